@@ -14,7 +14,8 @@ namespace fsm
         IDLE,          // System is idle
         START_STEP,    // Starting a new step on the melody
         PLAYING_STEP,  // Currently playing a step of the melody
-        ADVANCE_STEP   // Advancing to the next step
+        ADVANCE_STEP,  // Advancing to the next step
+        PAUSED         // Playback frozen in the middle of a step, waiting for resume()
     };
 
 } // namespace fsm
\ No newline at end of file
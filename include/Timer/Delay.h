@@ -1,5 +1,6 @@
 #pragma once
 #include <stdint.h> // Include standard integer types for fixed-width types.
+#include "Timer/TimerWheel.h"
 
 /**
  * @brief Utility class for handling non-blocking delays.
@@ -15,19 +16,30 @@
  * - Repeatedly call `isDelayTimeElapsed()` in a loop to check if the delay has passed.
  * - Use `restartTimer()` to reset the timer when the delay condition is met.
  * - The delay interval can be changed dynamically with `updateDelayTime()`.
+ * - For back to back intervals without drift (e.g. notes of a melody), check with `hasElapsed()`
+ *   and start the next interval with `chain()`: it starts at the previous deadline, not at "now".
+ * - `attach(&wheel)` hands the deadline to a TimerWheel: the checks then read a flag set by
+ *   TimerWheel::poll() instead of calling micros() (only arming the interval reads the clock).
  * 
  * Notes:
  * - The empty constructor `Delay()` is provided but should be avoided 
  *   (it does not initialize the timer).
  * - Designed for microcontroller environments where precise non-blocking timing is required.
+ * - An attached Delay must not be copied while its interval is running.
  */
 class Delay{
   private:
     unsigned long _delayTime;          // us
     unsigned long _previousTime;      // us
     bool _disarm;                     // whether the delay is disarmed
+    TimerWheel* _wheel;               // wheel owning the deadline, nullptr: poll micros()
+    WheelTimer _wheelTimer;           // deadline registered in the wheel
+    volatile bool _fired;             // the wheel reached the deadline
+
+    void arm();                                                // register the current deadline in the wheel
+    static void onWheelExpired(void* context);                 // wheel callback: the deadline is reached
   public:
-    Delay(){}                         // Empty Constructor. Do not used
+    Delay() : _wheel(nullptr), _fired(false) {}                // Empty Constructor. Do not used
     Delay(unsigned long delayTime);   // Constructor
     
     void init();     
@@ -36,4 +48,9 @@ class Delay{
     void stopDelay();                                          // Stop the Delay time tracking 
     void updateDelayTime(unsigned long newDelayTime);          // set a new time for the Delay
     void restartTimer();                                       // restart the internal timer
+
+    bool hasElapsed() const;                                   // true when the delay has elapsed (does not restart the timer)
+    unsigned long elapsed() const;                             // us since the start of the current interval (0 when disarmed)
+    void chain(unsigned long nextDelayTime);                   // start the next interval at the current deadline (drift free)
+    void attach(TimerWheel* wheel);                            // let a timer wheel track the deadline (nullptr: poll micros() again)
 };
@@ -0,0 +1,98 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @brief Timer owned by a TimerWheel (intrusive: the wheel links the timers, no allocation)
+ *
+ * @details The callback runs inside TimerWheel::poll(). It may schedule the timer again
+ * (periodic timer) or schedule/cancel other timers.
+ *
+ * @note An armed timer must not be copied or destroyed: cancel it first.
+ */
+struct WheelTimer
+{
+    typedef void (*Callback)(void* context);
+
+    WheelTimer() : next(nullptr), pprev(nullptr), expiryTick(0), callback(nullptr), context(nullptr) {}
+    WheelTimer(Callback cb, void* ctx) : next(nullptr), pprev(nullptr), expiryTick(0), callback(cb), context(ctx) {}
+
+    bool isArmed() const { return pprev != nullptr; }
+
+    WheelTimer* next;           // slot list links (owned by the wheel)
+    WheelTimer** pprev;         // link pointing to this timer (slot head or previous next), nullptr = not armed
+    uint32_t expiryTick;        // tick where the timer fires
+    Callback callback;          // called when it fires
+    void* context;              // passed to the callback
+};
+
+/**
+ * @brief Hierarchical timer wheel: one clock for all the deadlines of the application
+ *
+ * @details
+ * Instead of every Delay and player reading micros() on each loop() pass, they register their
+ * deadline here and poll() is the only place that reads the clock.
+ *
+ * Time is cut in ticks of tickUs. Level 0 has one slot per tick for the next 16 ticks, level 1
+ * one slot per 16 ticks, and so on (4 levels of 16 slots = 65536 ticks ahead, 65 s with 1 ms
+ * ticks; further timers wait in the last slot and are placed again when it comes round).
+ * Each tick only looks at one slot of level 0, and every 16 ticks moves one slot of the next level
+ * down: the cost of a tick does not depend on how many timers exist. Scheduling and cancelling
+ * are O(1) list operations.
+ *
+ * Deadlines are given in us and rounded up to the next tick, so a timer fires at most one tick
+ * (plus the poll period) late, and chained deadlines (Delay::chain()) do not drift.
+ *
+ * Example usage:
+ *
+ * TimerWheel wheel(1000);              // 1 ms ticks
+ * player.attachTimerWheel(&wheel);
+ * blinkDelay.attach(&wheel);
+ *
+ * void loop() { wheel.poll(); player.update(); if (blinkDelay.isDelayTimeElapsed()) toggleLed(); }
+ */
+class TimerWheel
+{
+    public:
+
+        static constexpr uint8_t SLOT_BITS = 4;
+        static constexpr uint8_t SLOTS = 1 << SLOT_BITS;   // slots per level
+        static constexpr uint8_t LEVELS = 4;
+
+        /// @brief Constructor
+        /// @param tickUs - length of a tick in us (resolution of the deadlines)
+        explicit TimerWheel(uint32_t tickUs = 1000);
+
+        /// @brief Run the ticks elapsed since the last call, firing the timers that expired
+        void poll();
+
+        /// @brief Arm a timer to fire after a number of ticks (0 = at the next tick). Re-arms it if armed
+        void schedule(WheelTimer& timer, uint32_t delayTicks);
+
+        /// @brief Arm a timer to fire at the first tick at or after a micros() timestamp
+        void scheduleAtUs(WheelTimer& timer, unsigned long deadlineUs);
+
+        /// @brief Disarm a timer (nothing happens if it is not armed)
+        void cancel(WheelTimer& timer);
+
+        /// @brief Next tick to run
+        uint32_t now() const;
+
+        /// @brief Length of a tick in us
+        uint32_t tickUs() const;
+
+    private:
+
+        /// @brief Link an armed timer in the slot matching its expiry tick
+        void place(WheelTimer& timer);
+
+        /// @brief Run tick current_: move the higher levels down when they roll over, then fire level 0
+        void runTick();
+
+        /// @brief Place again the timers of one slot of a higher level
+        void cascade(uint8_t level);
+
+        WheelTimer* slots_[LEVELS][SLOTS];      // slot lists
+        uint32_t tickUs_;                       // tick length
+        uint32_t current_;                      // next tick to run
+        unsigned long baseUs_;                  // micros() time of tick current_
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef ARDUINO
+    #include <Arduino.h>
+#endif
+
+/**
+ * @brief tone()/noTone() square wave generator resolved at compile time
+ * 
+ * @details
+ * Same wave as ArduinoToneBackend, but nothing is virtual: the pin is a template parameter
+ * and start()/stop() are inline. Used as BasicBuzzerPlayer<StaticToneBackend<PIN>> the player
+ * calls tone(PIN, f) directly, there is no vtable (no SRAM copy of it on AVR) and no indirect call.
+ * 
+ * Example usage:
+ * 
+ * StaticToneBackend<config::BUZZER_PIN> hwBackend;
+ * BasicBuzzerPlayer<StaticToneBackend<config::BUZZER_PIN>> player(hwBackend);
+ * 
+ * @tparam Pin - buzzer pin where the PWM wave is generated
+ */
+template<uint8_t Pin>
+class StaticToneBackend
+{
+    public:
+
+    /// @brief Config the buzzer pin as OUTPUT
+    void begin() { pinMode(Pin, OUTPUT); }
+
+    /// @brief Generate a square wave of the specified frequency(and 50% duty cycle) on the pin
+    /// @param frequencyHz - frequency of the wave
+    void start(uint16_t frequencyHz) { tone(Pin, frequencyHz); }
+
+    /// @brief Stop the square wave on the pin
+    void stop() { noTone(Pin); }
+};
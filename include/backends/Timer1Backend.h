@@ -0,0 +1,128 @@
+#pragma once
+
+#include <stdint.h>
+#include "player/BatchBackend.h"
+
+#ifdef __AVR__
+    #include <avr/io.h>
+#endif
+
+#ifndef F_CPU
+    #define F_CPU 16000000UL
+#endif
+
+namespace timer1
+{
+    /**
+     * @brief Timer1 setting that plays one step
+     *
+     * @details In CTC mode with "toggle OC1A on compare match" every match is half a period of
+     * the wave, so the step lasts an exact number of matches: there is no rounding against
+     * micros(), the note ends on a wave period boundary.
+     */
+    struct Timing
+    {
+        uint16_t ocr;           // OCR1A: the timer counts 0..ocr, then matches
+        uint8_t csBits;         // clock select bits (prescaler) of TCCR1B
+        bool toggle;            // tone: toggle OC1A on match. Rest: output disconnected
+        uint32_t matches;       // compare matches the step lasts (even for a tone: whole periods)
+    };
+
+    constexpr uint32_t REST_TICK_HZ = 10000;   // compare rate used to time rests(100us resolution)
+
+    /**
+     * @brief Compute the timer setting of a step (host safe, no register access)
+     *
+     * @param freqHz - frequency of the tone, 0 for a rest
+     * @param durationUs - real duration of the step
+     * @param carryCycles - optional rounding error of the previous steps: added to this step and
+     *                      updated, so whole period rounding does not drift the melody
+     * @return Timing - at least one match (one period for a tone)
+     */
+    Timing timingFor(uint16_t freqHz, uint32_t durationUs, int32_t* carryCycles = nullptr);
+
+    /// @brief Timer clock ticks (CPU cycles) one compare match lasts
+    uint32_t cyclesPerMatch(const Timing& timing);
+
+} // namespace timer1
+
+
+#if defined(__AVR__) && defined(OCR1A) && defined(TIMSK1) && defined(BUZZER_USE_TIMER1)
+
+/**
+ * @brief Square wave generator on Timer1 that plays a window of steps from its compare ISR
+ *
+ * @details
+ * Batch backend (see BatchTraits): the player pushes the next steps ahead of time, their timer
+ * settings are computed in push() (outside the ISR). The compare ISR toggles OC1A in hardware
+ * and counts matches: when the count of the step is reached it loads the next step itself.
+ * Note boundaries are cycle exact and do not depend on micros() or on how late update() runs,
+ * update() only has to refill the window before it runs dry.
+ *
+ * The buzzer must be on the OC1A pin (D9 on Uno/Nano, D11 on Mega). The backend owns Timer1
+ * and defines TIMER1_COMPA_vect, which other libraries (e.g. Servo) define too: it is only
+ * built with -D BUZZER_USE_TIMER1 (build_flags in platformio.ini).
+ *
+ * Example usage:
+ *
+ * Timer1Backend hwBackend;
+ * BasicBuzzerPlayer<Timer1Backend> player(hwBackend);
+ *
+ * void setup() { hwBackend.begin(); player.play(melody); }
+ * void loop()  { player.update(); }
+ *
+ * @note Only one instance makes sense: the state lives in static members shared with the ISR.
+ */
+class Timer1Backend
+{
+    public:
+
+        static constexpr uint8_t BATCH_WINDOW = 4;     // steps scheduled ahead
+
+        /// @brief Config the OC1A pin as OUTPUT and stop the timer
+        void begin();
+
+        // --- Plain backend ---
+
+        /// @brief Play a tone until stop(), dropping the scheduled steps
+        /// @param frequencyHz - frequency of the wave
+        void start(uint16_t frequencyHz);
+
+        /// @brief Silence and drop the scheduled steps
+        void stop();
+
+        // --- Batch capability ---
+
+        /// @brief Steps that can still be pushed
+        uint8_t freeSlots() const;
+
+        /// @brief Schedule a step after the ones already pushed (starts now if idle)
+        void push(const BatchStep& step);
+
+        /// @brief Steps finished since the last call
+        uint8_t takeCompleted();
+
+        /// @brief Time the current step has been playing in us
+        uint32_t elapsedUs() const;
+
+        /// @brief Compare match work, called from TIMER1_COMPA_vect only
+        static void onCompareMatch();
+
+    private:
+
+        /// @brief Program the timer for a step (interrupts disabled)
+        static void load(const timer1::Timing& timing);
+
+        /// @brief Stop the timer and leave the pin low (interrupts disabled)
+        static void halt();
+
+        static timer1::Timing window_[BATCH_WINDOW];   // scheduled steps, window_[head_] is playing
+        static volatile uint8_t head_;                 // index of the step playing
+        static volatile uint8_t count_;                // steps in the window
+        static volatile uint8_t completed_;            // steps finished, not reported yet
+        static volatile uint32_t remaining_;           // matches left in the step playing
+        static volatile bool endless_;                 // tone from start(): no step counting
+        static int32_t carryCycles_;                   // rounding error carried to the next pushed step
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include "../music/Score.h"
 #include "../lib/avr_algorithms.h"
 #include "../music/Notes.h"
+#include "../music/Timing.h"
 #include "../logger/Logger.h"
 
 
@@ -169,6 +170,9 @@ public:
     // Build the melody
     Melody build() const; 
 
+    // Build only the steps added since a mark taken with size() (e.g. one phrase of an Arrangement)
+    Melody buildFrom(size_t firstStep) const;
+
     // --- For retrieve status: Debugging  ---
 
     /// @brief to check if the build is done correctly not overflow capacity
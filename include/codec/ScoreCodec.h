@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "music/Score.h"
+
+/**
+ * @brief Compact encoding for sheet music scores(ScoreNote sequences)
+ * 
+ * @details
+ * A ScoreNote takes 3 bytes of flash on AVR (4 on 32-bit targets), and a built Step takes 6 bytes of SRAM.
+ * Jingles move in small intervals and repeat the same rhythm, so most of those bits are redundant.
+ * 
+ * Format (all multi-bit fields MSB first, bit stream packed MSB first into bytes):
+ * 
+ *  - Header: note count, 1 byte up to 127 notes (0ccccccc), 2 bytes up to 32767 (1ccccccc cccccccc, low bits first)
+ *  - Per note: duration code followed by pitch code
+ * 
+ *  Duration (run-length of the rhythm):
+ *      0               same denom as the previous note
+ *      1 ccc           new denom = 1 << ccc (ccc = 0..6: Whole..SixtyFourth)
+ *      1 111 dddddddd  new denom, raw 8 bits (any other denom)
+ * 
+ *  Pitch (delta coded chromatic index, see pitch::):
+ *      0 ssss          previous pitch + signed delta (-8..+7 semitones)
+ *      10              rest (previous pitch is kept as reference)
+ *      11 iiiiiii      absolute chromatic index (0..107)
+ *      11 1111111 h16  frequency not in the chromatic table, raw 16 bits Hz
+ * 
+ * A typical note (same rhythm, step-wise motion) costs 6 bits instead of 24.
+ * The reference pitch before the first note is A4 and there is no previous denom, so the first note
+ * always carries its rhythm.
+ */
+namespace codec {
+
+    // Format constants
+    constexpr uint8_t MAX_HEADER_SIZE   = 2;
+    constexpr uint16_t MAX_NOTES        = 0x7FFF;
+    constexpr uint8_t DENOM_CODE_BITS   = 3;
+    constexpr uint8_t DENOM_CODE_RAW    = 7;        // escape: raw 8 bits denom follows
+    constexpr uint8_t DELTA_BITS        = 4;
+    constexpr int8_t  DELTA_MIN         = -8;
+    constexpr int8_t  DELTA_MAX         = 7;
+    constexpr uint8_t INDEX_BITS        = 7;
+    constexpr uint8_t INDEX_RAW_HZ      = 0x7F;     // escape: raw 16 bits Hz follows
+
+    /// @brief Where the encoded bytes live, so the decoder knows how to read them
+    enum class MemorySpace : uint8_t
+    {
+        Ram,        // plain pointer
+        Flash,      // PROGMEM, read with pgm_read_byte()
+        Eeprom      // internal EEPROM, the pointer is the EEPROM address (see core/Eeprom.h)
+    };
+
+    /**
+     * @brief Encode a score
+     * 
+     * @param notes - notes to encode
+     * @param count - number of notes
+     * @param out - output buffer
+     * @param capacity - size of the output buffer in bytes
+     * @return size_t - number of bytes written, 0 if the output buffer is too small
+     */
+    size_t encodeScore(const score::ScoreNote* notes, uint16_t count, uint8_t* out, size_t capacity);
+
+    /**
+     * @brief Streaming decoder of an encoded score
+     * 
+     * @details Decodes one note per call to next(), reading the bytes straight from where they are
+     * stored. The whole state is a few bytes: no decompression buffer.
+     */
+    class ScoreDecoder
+    {
+        public:
+
+        /// @brief Constructor
+        /// @param data - encoded score (header included)
+        /// @param space - memory where data lives
+        ScoreDecoder(const uint8_t* data, MemorySpace space);
+
+        /// @brief Go back to the first note
+        void rewind();
+
+        /// @brief Decode the next note
+        /// @param note - output note
+        /// @return false when all notes were decoded
+        bool next(score::ScoreNote& note);
+
+        /// @brief Total number of notes in the encoded score
+        uint16_t count() const;
+
+        private:
+
+        uint8_t fetch_(uint16_t offset) const;     // read one encoded byte
+        uint16_t readBits_(uint8_t bits);          // read up to 16 bits, MSB first
+
+        const uint8_t* data_;       // encoded score
+        MemorySpace space_;         // where data_ lives
+        uint16_t count_;            // notes in the score
+        uint8_t headerSize_;        // bytes used by the note count
+        uint16_t remaining_;        // notes still to decode
+        uint16_t offset_;           // next byte to fetch
+        uint8_t byte_;              // byte being consumed
+        uint8_t bitsLeft_;          // bits not consumed yet in byte_
+        uint8_t prevIndex_;         // reference pitch for deltas
+        uint8_t prevDenom_;         // rhythm of the previous note
+    };
+
+} // namespace codec
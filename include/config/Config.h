@@ -8,8 +8,8 @@ namespace config
     // buzzer pin
     constexpr uint8_t   BUZZER_PIN =  9;
 
-    // max number of step the the melody can hold
-    constexpr uint8_t MAX_BUFFER_MELODY_STEP_SIZE = 64;
+    // max number of step the the melody can hold (size_t like MelodyBuilder's capacity: not capped at 255)
+    constexpr size_t MAX_BUFFER_MELODY_STEP_SIZE = 64;
 
     /// @brief for debugging 
     namespace debug
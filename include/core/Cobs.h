@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Consistent Overhead Byte Stuffing: byte frames with 0x00 as the only delimiter
+ *
+ * @details
+ * The encoded bytes never contain 0x00, so a receiver resynchronizes on the next 0x00 whatever
+ * it got before (line noise, a log line, half a frame). The overhead is one byte per 254 bytes
+ * plus one.
+ *
+ * Both sides work a byte at a time, without a copy of the whole frame: the encoder writes into
+ * the output as bytes are put (patching each block code once the block ends), and the decoder
+ * returns each decoded byte as its encoded byte arrives (a receiver can store it where it goes).
+ * The 0x00 delimiters themselves are added and detected by the caller.
+ */
+namespace cobs
+{
+    /// @brief Worst case encoded size of length bytes (delimiter not included)
+    constexpr size_t maxEncodedSize(size_t length)
+    {
+        return length + length / 254 + 1;
+    }
+
+    /**
+     * @brief Encodes a frame directly into an output buffer
+     */
+    class Encoder
+    {
+        public:
+
+        /// @brief Constructor
+        /// @param out - output buffer
+        /// @param capacity - its size
+        Encoder(uint8_t* out, size_t capacity);
+
+        /// @brief Encode one byte of the frame
+        void put(uint8_t byte);
+
+        /// @brief Close the last block
+        /// @return size_t - encoded length, 0 if the output buffer was too small
+        size_t finish();
+
+        private:
+
+        void closeBlock_();         // write the code of the current block, start the next one
+
+        uint8_t* out_;              // output buffer
+        size_t capacity_;           // its size
+        size_t length_;             // bytes written (codes included)
+        size_t codeIndex_;          // where the code of the current block goes
+        uint8_t code_;              // 1 + data bytes in the current block
+        bool ok_;                   // the output never overflowed
+    };
+
+    /**
+     * @brief Decodes a frame one encoded byte at a time
+     */
+    class Decoder
+    {
+        public:
+
+        Decoder();
+
+        /// @brief Start a new frame (after a delimiter)
+        void reset();
+
+        /// @brief Decode one encoded byte (never 0x00, that is the delimiter)
+        /// @param in - encoded byte
+        /// @param out - decoded byte, when there is one
+        /// @return true if out was written (a block code only produces the zero it stands for)
+        bool push(uint8_t in, uint8_t& out);
+
+        /// @brief Check if the frame can end here (the last block got all its bytes)
+        bool isComplete() const;
+
+        private:
+
+        uint8_t remaining_;         // data bytes still expected in the current block
+        uint8_t code_;              // code of the current block
+        bool started_;              // a block code was seen
+    };
+
+    /// @brief Encode a whole buffer
+    /// @return size_t - encoded length, 0 if out is too small
+    size_t encode(const uint8_t* data, size_t length, uint8_t* out, size_t capacity);
+
+    /// @brief Decode a whole frame (delimiters excluded)
+    /// @return size_t - decoded length, 0 if the frame is malformed or out is too small
+    size_t decode(const uint8_t* data, size_t length, uint8_t* out, size_t capacity);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection, no final xor)
+ *
+ * @details Shared by everything that checks stored or transmitted bytes (EEPROM melody bank,
+ * Serial upload frames). Bitwise, no table: 8 shifts per byte and no flash spent on a 512 bytes
+ * table. Check value: crc16("123456789") = 0x29B1.
+ */
+namespace crc16
+{
+    constexpr uint16_t INIT = 0xFFFF;
+
+    /// @brief Add one byte to a running CRC
+    inline uint16_t update(uint16_t crc, uint8_t byte)
+    {
+        crc ^= (uint16_t)byte << 8;
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+        return crc;
+    }
+
+    /// @brief CRC of a buffer (pass the previous result as crc to continue it)
+    inline uint16_t compute(const uint8_t* data, size_t length, uint16_t crc = INIT)
+    {
+        for (size_t i = 0; i < length; ++i) crc = update(crc, data[i]);
+        return crc;
+    }
+}
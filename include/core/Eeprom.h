@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Portable byte access to the internal EEPROM
+ *
+ * @details
+ * On AVR this is avr-libc: reads are a few cycles, and updateByte() only writes (3.3 ms, one of
+ * the ~100000 erase/write cycles of the cell) when the value changes.
+ * Other targets and host builds get an emulation in RAM with the same interface and a write
+ * counter per byte (to measure wear), not persistent across resets.
+ *
+ * Addresses are byte offsets from the start of the EEPROM.
+ */
+#if defined(__AVR__)
+    #include <avr/eeprom.h>
+
+    namespace eeprom
+    {
+        constexpr uint16_t SIZE = E2END + 1;
+
+        inline uint8_t readByte(uint16_t address)
+        {
+            return eeprom_read_byte(reinterpret_cast<const uint8_t*>(address));
+        }
+
+        inline void updateByte(uint16_t address, uint8_t value)
+        {
+            eeprom_update_byte(reinterpret_cast<uint8_t*>(address), value);
+        }
+    }
+#else
+    namespace eeprom
+    {
+        constexpr uint16_t SIZE = 1024;     // ATmega328P
+
+        /// @brief Read a byte (0xFF outside the emulated EEPROM, like an erased cell)
+        uint8_t readByte(uint16_t address);
+
+        /// @brief Write a byte if it changed
+        void updateByte(uint16_t address, uint8_t value);
+
+        /// @brief Emulation only: writes done to a byte since the start
+        uint32_t writeCount(uint16_t address);
+    }
+#endif
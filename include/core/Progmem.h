@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Portable access to data stored in program memory(flash)
+ * 
+ * @details
+ * On AVR constant tables must be tagged PROGMEM and read back with pgm_read_*(),
+ * otherwise they are copied into the 2KB of SRAM at boot.
+ * Other Arduino cores provide the same macros through Arduino.h, and host builds
+ * (encoder tools) just read the memory directly.
+ */
+#if defined(__AVR__)
+    #include <avr/pgmspace.h>
+#elif defined(ARDUINO)
+    #include <Arduino.h>
+#else
+    #define PROGMEM
+    #define pgm_read_byte(addr)  (*(const uint8_t*)(addr))
+    #define pgm_read_word(addr)  (*(const uint16_t*)(addr))
+    #define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+    #define pgm_read_ptr(addr)   (*(const void* const*)(addr))
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Tiny pseudo random generator for musical choices (shuffle, variations)
+ * 
+ * @details 16 bits xorshift (7, 9, 8): 2 bytes of state, a few shifts per number, period 65535.
+ * Not suitable for anything security related.
+ */
+class XorShift16
+{
+    private:
+
+        uint16_t state_;
+
+    public:
+
+    /// @brief Constructor
+    /// @param seed - any value, 0 is replaced by a fixed non zero seed
+    explicit XorShift16(uint16_t seed = 0xACE1u): state_(seed ? seed : 0xACE1u) {}
+
+    /// @brief Next pseudo random number (never 0)
+    uint16_t next()
+    {
+        state_ ^= (uint16_t)(state_ << 7);
+        state_ ^= (uint16_t)(state_ >> 9);
+        state_ ^= (uint16_t)(state_ << 8);
+        return state_;
+    }
+
+    /// @brief Pseudo random number in [0, bound)
+    /// @param bound - exclusive upper bound, 0 returns 0
+    uint16_t below(uint16_t bound)
+    {
+        return bound ? (uint16_t)(((uint32_t)next() * bound) >> 16) : 0;
+    }
+};
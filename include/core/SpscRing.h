@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+
+#if !defined(__AVR__)
+#include <atomic>
+#endif
+
+/**
+ * @brief Wait-free single producer / single consumer ring of fixed size elements
+ *
+ * @details
+ * One context pushes (an ISR, or another thread on host builds), one context pops (the main
+ * loop). Neither side ever waits or masks interrupts: push() fails when the ring is full and
+ * pop() fails when it is empty.
+ *
+ * The two indices run freely (uint8_t, wrapping at 256) and are masked on access, so full and
+ * empty are told apart without wasting a slot. Each index has a single writer:
+ *  - push(): writes the slot, then publishes it by storing head_ (release)
+ *  - pop(): reads the slot, then frees it by storing tail_ (release)
+ * On AVR a uint8_t load or store is a single instruction, so a volatile byte plus a compiler
+ * barrier is enough. Elsewhere (host builds, multi-core boards) the indices are std::atomic
+ * with acquire / release ordering.
+ *
+ * @tparam T - element type, copied in and out
+ * @tparam N - capacity: a power of two, at most 128
+ */
+template<class T, uint8_t N>
+class SpscRing
+{
+    static_assert(N > 0 && N <= 128 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two <= 128");
+
+    public:
+
+        SpscRing() : head_(0), tail_(0), rejected_(0) {}
+
+        /// @brief Append an element. Producer only
+        /// @return false if the ring is full (nothing written)
+        bool push(const T& item)
+        {
+            uint8_t head = load(head_);
+            if ((uint8_t)(head - acquire(tail_)) >= N)
+            {
+                uint8_t rejected = load(rejected_);
+                if (rejected < 0xFF) release(rejected_, (uint8_t)(rejected + 1));
+                return false;
+            }
+
+            items_[head & (N - 1)] = item;
+            release(head_, (uint8_t)(head + 1));
+            return true;
+        }
+
+        /// @brief Take the oldest element. Consumer only
+        /// @return false if the ring is empty (item untouched)
+        bool pop(T& item)
+        {
+            uint8_t tail = load(tail_);
+            if (tail == acquire(head_)) return false;
+
+            item = items_[tail & (N - 1)];
+            release(tail_, (uint8_t)(tail + 1));
+            return true;
+        }
+
+        /// @brief Elements waiting (a snapshot when called from the other side)
+        uint8_t size() const { return (uint8_t)(acquire(head_) - acquire(tail_)); }
+
+        bool isEmpty() const { return size() == 0; }
+
+        /// @brief push() calls that failed because the ring was full (saturates at 255)
+        uint8_t rejected() const { return acquire(rejected_); }
+
+        static constexpr uint8_t capacity() { return N; }
+
+    private:
+
+#if defined(__AVR__)
+        typedef volatile uint8_t Index;
+
+        static uint8_t load(const Index& index) { return index; }
+        static uint8_t acquire(const Index& index)
+        {
+            uint8_t value = index;
+            __asm__ __volatile__("" ::: "memory");
+            return value;
+        }
+        static void release(Index& index, uint8_t value)
+        {
+            __asm__ __volatile__("" ::: "memory");
+            index = value;
+        }
+#else
+        typedef std::atomic<uint8_t> Index;
+
+        static uint8_t load(const Index& index) { return index.load(std::memory_order_relaxed); }
+        static uint8_t acquire(const Index& index) { return index.load(std::memory_order_acquire); }
+        static void release(Index& index, uint8_t value) { index.store(value, std::memory_order_release); }
+#endif
+
+        T items_[N];
+        Index head_;        // next slot to write, written by the producer only
+        Index tail_;        // next slot to read, written by the consumer only
+        Index rejected_;    // failed push() calls, written by the producer only
+};
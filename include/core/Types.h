@@ -34,6 +34,44 @@ struct Melody
     size_t count;
 };
 
+/**
+ * @brief Section of a melody the player repeats (intro -> loop section -> outro)
+ * 
+ * @details
+ * Steps before firstStep play once (intro), [firstStep, endStep) plays `count` times,
+ * then the rest of the melody plays once (outro).
+ * Step indices can be marked while composing with MelodyBuilder::size().
+ */
+struct LoopRegion
+{
+    size_t firstStep;       // first step of the section
+    size_t endStep;         // one past the last step of the section
+    uint8_t count;          // times the section plays in total (0 = forever, the outro is never reached)
+};
+
+/**
+ * @brief Reference to a phrase inside an arrangement
+ * 
+ * @details The phrase Steps are stored once; the reference says how to play them here.
+ */
+struct PhraseRef
+{
+    const Melody* phrase;   // Steps of the phrase (not owned)
+    uint8_t repeat;         // How many times in a row the phrase is played (0 = skipped)
+    int8_t transpose;       // Semitones to shift the phrase (0 = as built)
+};
+
+/**
+ * @brief A song described as a sequence of phrase references (e.g. AABA form)
+ * 
+ * @details Repeated material costs one PhraseRef (4 bytes on AVR) instead of a copy of its Steps.
+ */
+struct Arrangement
+{
+    const PhraseRef* refs;
+    size_t count;
+};
+
 /**
  * @brief Context for playing a melody
  * 
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Chromatic pitch index helpers
+ * 
+ * @details
+ * Every frequency defined in notes:: is one semitone of the chromatic scale from C0 to B8.
+ * Giving each of them an index (C0 = 0, C#0 = 1, ... B8 = 107) lets us store a pitch in 7 bits
+ * and express melodic movement as small semitone deltas, which is what the score codec relies on.
+ * 
+ * @note The frequency table lives in flash (PROGMEM), so it costs no SRAM.
+ */
+namespace pitch {
+
+    constexpr uint8_t COUNT      = 108;     // C0..B8 (9 octaves * 12 semitones)
+    constexpr uint8_t NONE       = 0xFF;    // frequency is not a note of the table (or a REST)
+    constexpr uint8_t A4_INDEX   = 57;      // standard tuning pitch, 440 Hz
+
+    /// @brief Frequency in Hz of a chromatic index
+    /// @param index - 0..COUNT-1
+    /// @return Frequency in Hz, or 0 (REST) if the index is out of range
+    uint16_t toHz(uint8_t index);
+
+    /// @brief Chromatic index of a frequency in Hz(exact match against notes::)
+    /// @param hz - Frequency in Hz
+    /// @return index 0..COUNT-1, or NONE if hz is not one of the notes:: frequencies
+    uint8_t fromHz(uint16_t hz);
+
+    /// @brief Shift a frequency by a number of semitones
+    /// @param hz - Frequency in Hz (0 = REST stays a REST)
+    /// @param semitones - interval, negative to go down
+    /// @return transposed frequency in Hz, saturated to the uint16_t range
+    uint16_t transpose(uint16_t hz, int8_t semitones);
+
+} // namespace pitch
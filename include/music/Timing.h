@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include "../core/Types.h"
+
+/**
+ * @brief Sheet music -> time conversions shared by everything that turns a score into Steps
+ * 
+ * @details
+ * MelodyBuilder converts a whole score up front, while streaming sources convert one note
+ * at a time during playback. Both must produce exactly the same Steps, so the math lives here.
+ */
+namespace timing {
+
+    /**
+     * @brief Convert musical notation (denom) to duration in milliseconds
+     * 
+     * @details note_durationMs = (60000 / BPM) * (4 / denom)
+     * 
+     * @param denom - Duration in musical notation (durations::Quarter, ...)
+     * @param bpm - Tempo in beats per minute (beat = quarter note)
+     * @return uint32_t - duration in ms, 0 if the inputs are invalid. Never 0 for valid inputs.
+     */
+    inline uint32_t denomToMs(uint8_t denom, uint16_t bpm)
+    {
+        if (denom == 0 || bpm == 0) return 0;
+
+        const uint32_t numerator = 60000UL * 4UL;                 // 240000
+        const uint32_t divisor   = (uint32_t)bpm * (uint32_t)denom;
+
+        uint32_t noteMs = numerator / divisor;
+
+        // never return 0ms (avoids zero-length steps at high BPM / small notes)
+        return (noteMs == 0) ? 1 : noteMs;
+    }
+
+    /**
+     * @brief Articulation rest to cut from the end of a note
+     * 
+     * @details The gap is clamped so the tone keeps at least MelodyContext::MIN_PLAY_MS of sound.
+     * 
+     * @param durationMs - total slot duration of the note
+     * @param gapMs - requested articulation gap
+     * @return uint32_t - rest in ms to append after the tone (0 = no split)
+     */
+    inline uint32_t articulationGapMs(uint32_t durationMs, uint16_t gapMs)
+    {
+        if (gapMs == 0 || durationMs <= MelodyContext::MIN_PLAY_MS) return 0;
+
+        // compute the max gap allow so the tone is audible
+        uint32_t maxGap = durationMs - MelodyContext::MIN_PLAY_MS;
+
+        return (gapMs > maxGap) ? maxGap : gapMs;
+    }
+
+} // namespace timing
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief One step handed in advance to a batch backend
+ *
+ * @details Transpose and playback rate are already applied, the backend only has to play it.
+ */
+struct BatchStep
+{
+    uint16_t freqHz;        // 0 = rest
+    uint32_t durationUs;    // real time the step lasts
+};
+
+/**
+ * @brief Optional backend capability: schedule a window of upcoming steps on its own
+ *
+ * @details
+ * A backend opts in by declaring `static constexpr uint8_t BATCH_WINDOW` (steps it can hold) and:
+ *  - uint8_t freeSlots() const          : steps that can still be pushed
+ *  - void push(const BatchStep& step)   : append after the last one. An idle backend starts it right away
+ *  - uint8_t takeCompleted()            : steps finished since the last call (read and clear)
+ *  - uint32_t elapsedUs() const         : time the first step of the window has been playing
+ *  - void stop()                        : silence and drop the whole window
+ * plus start(frequencyHz) like any backend. When the window runs dry the backend must go silent.
+ *
+ * The backend switches from one step to the next itself (e.g. by reloading timer compare values
+ * from its ISR), so note boundaries do not depend on how often update() is called: the player
+ * only refills the window and reports the completed steps.
+ *
+ * BatchTraits<Backend> tells the player whether the capability is there. For a plain backend
+ * it is disabled and its calls do nothing, so the player code compiles for both and the unused
+ * branch is removed by the compiler.
+ */
+template<class T>
+struct BatchVoid { typedef void type; };
+
+template<class Backend, class = void>
+struct BatchTraits
+{
+    static constexpr bool ENABLED = false;
+    static constexpr uint8_t WINDOW = 0;
+
+    static uint8_t freeSlots(const Backend&) { return 0; }
+    static void push(Backend&, const BatchStep&) {}
+    static uint8_t takeCompleted(Backend&) { return 0; }
+    static uint32_t elapsedUs(const Backend&) { return 0; }
+};
+
+template<class Backend>
+struct BatchTraits<Backend, typename BatchVoid<decltype(Backend::BATCH_WINDOW)>::type>
+{
+    static constexpr bool ENABLED = true;
+    static constexpr uint8_t WINDOW = Backend::BATCH_WINDOW;
+
+    static uint8_t freeSlots(const Backend& backend) { return backend.freeSlots(); }
+    static void push(Backend& backend, const BatchStep& step) { backend.push(step); }
+    static uint8_t takeCompleted(Backend& backend) { return backend.takeCompleted(); }
+    static uint32_t elapsedUs(const Backend& backend) { return backend.elapsedUs(); }
+};
+
+template<class Backend, class Enable> constexpr bool BatchTraits<Backend, Enable>::ENABLED;
+template<class Backend, class Enable> constexpr uint8_t BatchTraits<Backend, Enable>::WINDOW;
+template<class Backend> constexpr bool BatchTraits<Backend, typename BatchVoid<decltype(Backend::BATCH_WINDOW)>::type>::ENABLED;
+template<class Backend> constexpr uint8_t BatchTraits<Backend, typename BatchVoid<decltype(Backend::BATCH_WINDOW)>::type>::WINDOW;
+
+/**
+ * @brief Fixed capacity FIFO of the steps handed to a batch backend (player side bookkeeping)
+ *
+ * @tparam T - element type
+ * @tparam N - capacity. 0 gives an always empty window that takes no storage
+ */
+template<class T, uint8_t N>
+class StepWindow
+{
+    public:
+
+        StepWindow() : head_(0), count_(0) {}
+
+        bool isEmpty() const { return count_ == 0; }
+        bool isFull() const { return count_ == N; }
+        uint8_t size() const { return count_; }
+
+        /// @brief Oldest element (the step being heard). Only when !isEmpty()
+        T& front() { return items_[head_]; }
+        const T& front() const { return items_[head_]; }
+
+        /// @brief Newest element. Only when !isEmpty()
+        const T& back() const
+        {
+            uint8_t last = head_ + count_ - 1;
+            if (last >= N) last -= N;
+            return items_[last];
+        }
+
+        /// @brief Append an element. Only when !isFull()
+        void push(const T& item)
+        {
+            uint8_t tail = head_ + count_;
+            if (tail >= N) tail -= N;
+            items_[tail] = item;
+            ++count_;
+        }
+
+        /// @brief Drop the oldest element. Only when !isEmpty()
+        void pop()
+        {
+            if (++head_ == N) head_ = 0;
+            --count_;
+        }
+
+        void clear() { head_ = 0; count_ = 0; }
+
+    private:
+
+        T items_[N];
+        uint8_t head_;
+        uint8_t count_;
+};
+
+template<class T>
+class StepWindow<T, 0>
+{
+    public:
+
+        bool isEmpty() const { return true; }
+        bool isFull() const { return true; }
+        uint8_t size() const { return 0; }
+
+        // Never called: the window is always empty
+        T& front() { return *static_cast<T*>(nullptr); }
+        const T& front() const { return *static_cast<const T*>(nullptr); }
+        const T& back() const { return *static_cast<const T*>(nullptr); }
+
+        void push(const T&) {}
+        void pop() {}
+        void clear() {}
+};
@@ -2,47 +2,197 @@
 
 #include <stdint.h>
 #include "player/IBuzzerBackend.h"
+#include "player/IStepSource.h"
+#include "player/PlayerHooks.h"
+#include "player/BatchBackend.h"
+#include "sources/MelodySource.h"
+#include "player/TimeIndex.h"
 #include "core/Types.h"
 #include "Timer/Delay.h"
 #include "FSM/States.h"
 
 
+/**
+ * @brief When a queued melody replaces the one being played
+ */
+enum class SwapPoint : uint8_t
+{
+    NextStep,       // as soon as the current step ends
+    EndOfLoop       // when the melody (or the current pass of its loop section) ends
+};
+
+/**
+ * @brief What update() does with steps whose deadline passed before it was called
+ * 
+ * @details Happens when the loop was blocked longer than a step (e.g. a slow display refresh).
+ */
+enum class LatePolicy : uint8_t
+{
+    Skip,           // steps already over are not sounded, the melody stays aligned with time
+    PlayAll,        // every step sounds, the late ones only until the next update() (stays aligned)
+    Resync          // a step already over starts now with its full length, the rest of the melody shifts later
+};
+
 /**
  * @brief Buzzer Player class that uses a backend to play melodies
  *  It's the Melody scheduler(FSM) and controller 
  * 
  * @details
- * This class manages the playback of melodies using a provided IBuzzerBackend implementation.
+ * This class manages the playback of melodies using a provided backend to generate the tone.
  * It handles the timing and sequencing of notes in the melody.
  * 
+ * The backend type is a template parameter, so its start()/stop() are called directly and a
+ * backend that is a couple of register writes is inlined into update(). Any class with
+ * `void start(uint16_t)` and `void stop()` works (e.g. StaticToneBackend). With
+ * Backend = IBuzzerBackend the calls are virtual and the backend can be chosen at runtime:
+ * that is BuzzerPlayer.
+ * 
+ * A backend with the batch capability (see BatchTraits) gets a window of upcoming steps and
+ * switches notes on its own: update() then only refills the window and reports completed steps.
+ * Changes that act at the next step (queue at NextStep, rate, transpose, loop hooks) reach the
+ * audio after the steps already handed to the backend.
+ * 
+ * Steps are pulled one at a time from an IStepSource, so the player can play a built Melody
+ * as well as sequences produced during playback (e.g. a compressed score decoded from flash).
+ * 
+ * Step and melody events are reported to a compile time hooks policy (see NoPlayerHooks).
+ * 
+ * @tparam Backend - tone generator: start(frequencyHz) and stop()
+ * @tparam Hooks - events policy: onStepStart, onStepEnd, onLoop, onFinish
  */
-class BuzzerPlayer
+template<class Backend = IBuzzerBackend, class Hooks = NoPlayerHooks>
+class BasicBuzzerPlayer : private Hooks
 {
     public:
 
         /// @brief Constructor for BuzzerPlayer
-        /// @param IBuzzerBackend Reference to an hardware wave form generation implementation
-        BuzzerPlayer(IBuzzerBackend& hwBackend);
+        /// @param hwBackend Reference to an hardware wave form generation implementation
+        /// @param hooks - initial state of the hooks policy
+        BasicBuzzerPlayer(Backend& hwBackend, const Hooks& hooks = Hooks());
         
         /// @brief Default destructor
-        ~BuzzerPlayer() = default;        
+        ~BasicBuzzerPlayer() = default;        
 
         /// @brief Function that starts playing a melody
         /// @param melody - Reference to the melody to be played
         /// @param loop - Whether to loop the melody after it finishes
         void play(const Melody& melody, bool loop = false);
 
+        /// @brief Function that starts playing a sequence of steps produced on the fly
+        /// @param source - Step source to pull from. Must outlive the playback
+        /// @param loop - Whether to rewind the source and start again after it finishes
+        void play(IStepSource& source, bool loop = false);
+
+        /// @brief Play a melody with an intro, a repeated section and an outro
+        /// @param melody - Reference to the melody to be played
+        /// @param region - section to repeat and how many times
+        void play(const Melody& melody, const LoopRegion& region);
+
+        /// @brief Play a step source with an intro, a repeated section and an outro
+        /// @param source - Step source to pull from. Must outlive the playback
+        /// @param region - section to repeat and how many times
+        void play(IStepSource& source, const LoopRegion& region);
+
+        /// @brief Queue a melody to replace the current one without a gap
+        /// @details The swap happens inside update() at the requested boundary. If nothing is playing it starts right away.
+        /// @param melody - melody to play next. Its steps must stay untouched until it is swapped in and while it plays
+        /// @param at - boundary where the swap happens
+        /// @param loop - Whether to loop the new melody
+        void queue(const Melody& melody, SwapPoint at = SwapPoint::EndOfLoop, bool loop = false);
+
+        /// @brief Queue a step source to replace the current one without a gap
+        /// @param source - Step source to pull from next. Must outlive the playback
+        /// @param at - boundary where the swap happens
+        /// @param loop - Whether to loop the new source
+        void queue(IStepSource& source, SwapPoint at = SwapPoint::EndOfLoop, bool loop = false);
+
+        /// @brief Check if a queued melody is still waiting for its swap point
+        /// @return true while the previous melody is still being played
+        bool isSwapPending() const;
         
         /// @brief Implementation for stopping the buzzer
         void stop()  ;
 
         /// @brief Check if the buzzer is currently playing
-        /// @return true if the buzzer is playing, false otherwise
+        /// @return true if the buzzer is playing (or paused with a melody loaded), false otherwise
         bool isPlaying() const;        
 
+        /// @brief Freeze the playback, keeping the exact time left in the current step
+        void pause();
+
+        /// @brief Continue a paused playback where it was paused
+        void resume();
+
+        /// @brief Check if the playback is paused
+        bool isPaused() const;
+
+        /// @brief Play an alert on top of the current melody, then resume the melody where it was
+        /// @param alert - steps of the alert (e.g. a ScoreViewSource over a preset). Must outlive the alert
+        void interrupt(IStepSource& alert);
+
+        // --- Playback time effects (the built melody is never rewritten) ---
+
+        /// @brief Tempo multiplier applied from the next step on
+        /// @param rateQ8 - unsigned q8.8: 0x0100 = normal, 0x0200 = twice as fast, 0x0080 = half speed
+        void setPlaybackRate(uint16_t rateQ8);
+
+        /// @brief Current tempo multiplier (q8.8)
+        uint16_t playbackRate() const;
+
+        /// @brief Pitch shift applied from the next step on
+        /// @param semitones - interval, negative to go down (0 = as built)
+        void setTranspose(int8_t semitones);
+
+        /// @brief Current pitch shift in semitones
+        int8_t transpose() const;
+
+        static constexpr uint16_t RATE_NORMAL = 0x0100;    // q8.8 1.0
+        static constexpr uint16_t RATE_MIN    = 0x0010;    // q8.8 1/16, slower rates are clamped
+
+        // --- Late update() handling ---
+
+        /// @brief Choose what happens to steps whose deadline passed before update() was called
+        /// @param policy - LatePolicy::Skip by default
+        void setLatePolicy(LatePolicy policy);
+
+        /// @brief Current late update policy
+        LatePolicy latePolicy() const;
+
+        /// @brief Steps not sounded because update() came after their end (LatePolicy::Skip)
+        uint16_t skippedSteps() const;
+
+        static constexpr uint8_t MAX_CATCHUP_STEPS = 16;   // steps skipped in one update() at most, bounds its run time
+
+        /// @brief Hand the step deadlines to a timer wheel: update() then checks a flag instead of micros()
+        /// @param wheel - wheel polled by the application before update(), nullptr to poll micros() again
+        void attachTimerWheel(TimerWheel* wheel);
+
+        /// @brief Hooks policy object (e.g. to set which LED it drives)
+        Hooks& hooks();
+
         /// @brief Update the buzzer state, should be called periodically
         void update();
 
+        // --- Position queries (progress bars, resume) ---
+
+        /// @brief Use application provided storage for the prefix sum index (O(log n) seek)
+        /// @param index - index storage. Without it seek() scans the melody
+        void attachTimeIndex(TimeIndex& index);
+
+        /// @brief Position in the melody in ms (0 when idle)
+        uint32_t elapsedMs() const;
+
+        /// @brief Duration of the melody in ms, indexed lazily on the first call (0 if unknown: source not replayable)
+        uint32_t totalMs();
+
+        /// @brief Time left until the end of the melody in ms (0 if unknown)
+        uint32_t remainingMs();
+
+        /// @brief Jump to a position of the melody being played
+        /// @param ms - position from the start of the melody
+        /// @return false if nothing is playing, the source is not replayable or ms is past the end
+        bool seek(uint32_t ms);
+
 
     private:
 
@@ -55,17 +205,155 @@ class BuzzerPlayer
     /// @brief Advance to the next step in the melody
     void advanceToNextStep();
 
+    /// @brief Sound the current step and arm its timer, applying the late policy
+    void startStep();
+
+    /// @brief Stop because the playback ended by itself (reported to the hooks)
+    void finish();
+
+    /// @brief Batch backend: hand the current step to the backend, from offsetUs into it
+    void feedStep(uint32_t offsetUs);
+
+    /// @brief Batch backend: report completed steps, refill the window, finish once it drained
+    void serviceWindow();
+
+    /// @brief Batch backend: take the window back, the cursor returns to the step being heard (PAUSED)
+    /// @return false if nothing was handed to the backend
+    bool flushWindow();
+
+    /// @brief Batch backend: hand the oldest step taken back by flushWindow() to the backend again
+    void refeedStep();
+
+    /// @brief Replace the current source by the queued one
+    /// @return true if the queued source has steps to play
+    bool swapToPending();
+
+    /// @brief Build the time index of the current source if needed, keeping the playback position
+    TimeIndex& ensureTimeIndex();
+
+    /// @brief Arm the player on a source without touching the resume point or queued melody
+    /// @return true if the source has steps to play
+    bool start(IStepSource& source, bool loop);
+
+    /// @brief Time left in the current step in us
+    uint32_t remainingStepUs() const;
+
+    /// @brief Real time a step lasts at the current playback rate
+    /// @param durationMs - step duration in the melody
+    uint32_t scaledDurationUs(uint32_t durationMs) const;
+
+    /// @brief Real time the current step lasts, sub-ms part reported by the source included
+    uint32_t currentStepUs() const;
+
+    /// @brief Real time the current step lasts with a given sub-ms part
+    /// @param extraUs - us added to its duration in ms (IStepSource::lastStepExtraUs() when it was read)
+    uint32_t currentStepUs(uint16_t extraUs) const;
+
+    /// @brief Melody time(ms) spent in a step after realUs of playback
+    /// @param rateQ8 - playback rate the step was started with
+    uint32_t stepMelodyMs(uint32_t realUs, uint16_t rateQ8) const;
+
+    /// @brief Frequency to send to the backend for a step frequency (transpose applied)
+    uint16_t playbackHz(uint16_t hz) const;
+
+    /// @brief Restore the playback interrupted by an alert
+    void restoreResumePoint();
+
+    typedef BatchTraits<Backend> Batch;
+
+    /// @brief Step handed to a batch backend, with the cursor needed to report or take it back
+    struct InFlightStep
+    {
+        IStepSource* source;            // source the step came from
+        uint8_t generation;             // playback it belongs to (a swap may be inside the window, on the same adapter)
+        Step step;                      // step as in the melody
+        size_t idx;
+        uint32_t startPosMs;
+        uint32_t durationUs;            // whole step at the rate it was fed with
+        uint16_t extraUs;               // sub-ms part the source reported for it
+        uint32_t offsetUs;              // part of the step played before it was fed (resume)
+        uint16_t rateQ8;
+        uint8_t loopPassesLeft;
+    };
+
+    /// @brief Steps a flush can take back without them being heard: all the window but the one being heard
+    static constexpr uint8_t REFEED_WINDOW = (Batch::WINDOW > 0) ? Batch::WINDOW - 1 : 0;
+    typedef StepWindow<InFlightStep, REFEED_WINDOW> RefeedWindow;
+
+    /// @brief Cursor of a playback interrupted by an alert (the steps are not copied, except the few a batch backend had not played)
+    struct ResumePoint
+    {
+        IStepSource* source;
+        Step step;
+        size_t stepIdx;
+        uint32_t stepStartPosMs;
+        uint32_t remainingUs;
+        uint32_t stepDurationUs;
+        uint16_t stepExtraUs;
+        uint16_t stepRateQ8;
+        bool paused;
+        bool looping;
+        bool hasLoopRegion;
+        LoopRegion loopRegion;
+        uint8_t loopPassesLeft;
+        uint32_t loopStartPosMs;
+        RefeedWindow refeed;            // batch backend: steps taken back, not heard yet
+        bool feedDone;                  // batch backend: the source had ended
+    };
+
     // === private members ===
 
-    IBuzzerBackend& hwBackend_;     // Reference to the buzzer backend implementation
+    Backend& hwBackend_;                // Reference to the buzzer backend implementation
+
+    MelodySource melodySource_;         // Adapter used to play a built Melody
+    IStepSource* source_;               // Where the steps being played come from
 
-    const Melody* melody_;              // The melody to be played 
-  
+    Step currentStep_;                  // Step being played(copied from the source)
     size_t  melodyStepIdx_;             // Current melody step index 
 
     bool looping_;                       // Whether to loop the melody
+
+    bool hasLoopRegion_;                // Whether a loop section is active
+    LoopRegion loopRegion_;             // Section repeated inside the melody
+    uint8_t loopPassesLeft_;            // Passes of the section still to play (unused when forever)
+
+    Melody pendingMelody_;              // Queued melody (when pendingSource_ is the melody adapter)
+    IStepSource* pendingSource_;        // Queued source, nullptr when nothing is queued
+    SwapPoint pendingAt_;               // Boundary where the queued source is swapped in
+    bool pendingLoop_;                  // Loop flag of the queued source
+
+    bool chainNextStep_;                // Next step starts at the previous deadline (false: starts when armed)
+    LatePolicy latePolicy_;             // What to do with steps already over when update() comes late
+    uint16_t skippedSteps_;             // Steps skipped by LatePolicy::Skip (saturates)
+
+    TimeIndex ownTimeIndex_;            // Duration only index, used when the application attached none
+    TimeIndex* timeIndex_;              // Index of the current source
+    uint32_t stepStartPosMs_;           // Position in the melody where the current step starts
+    uint32_t loopStartPosMs_;           // Position in the melody of the loop section first step
+
+    uint16_t playbackRateQ8_;           // Tempo multiplier (q8.8) applied at each step start
+    uint32_t usPerMsQ8_;                // Real us per melody ms at playbackRateQ8_ (q24.8), avoids a division per step
+    int8_t transpose_;                  // Pitch shift in semitones applied at each step start
+
+    uint32_t stepDurationUs_;           // Real duration of the current step (rate applied when it started)
+    uint16_t stepExtraUs_;              // Batch backend: sub-ms part of the current step, kept with it in the window
+    uint16_t stepRateQ8_;               // Rate the current step was started with
+    uint32_t stepOffsetUs_;             // Part of the current step played before its timer was (re)armed
+    uint32_t pausedRemainingUs_;        // Time left in the current step while PAUSED
+    bool hasResumePoint_;               // An alert interrupted a playback
+    ResumePoint resumePoint_;           // Playback to resume after the alert
     Delay stepDelay_;                   // Delay for the current step
 
+    StepWindow<InFlightStep, Batch::WINDOW> inFlight_;  // Steps handed to a batch backend (no storage otherwise)
+    RefeedWindow refeed_;                               // Steps taken back by flushWindow(), fed again before the source is read
+    bool feedDone_;                     // Batch backend: the source ended, waiting for the window to drain
+    uint8_t generation_;                // Batch backend: bumped when a playback starts (play, swap, resume after an alert)
+
     fsm::State state_;                 // Current state of the player FSM
     
-};
\ No newline at end of file
+};
+
+/// @brief Player with a backend chosen at runtime (virtual IBuzzerBackend calls) and no event hooks
+using BuzzerPlayer = BasicBuzzerPlayer<>;
+
+#include "player/BuzzerPlayerImpl.h"
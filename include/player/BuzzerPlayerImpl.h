@@ -0,0 +1,1344 @@
+#pragma once
+
+// Definitions of the BasicBuzzerPlayer template, included at the end of player/BuzzerPlayer.h
+// (include that header, not this one)
+
+#include "music/Pitch.h"
+
+template<class Backend, class Hooks> constexpr uint16_t BasicBuzzerPlayer<Backend, Hooks>::RATE_NORMAL;
+template<class Backend, class Hooks> constexpr uint16_t BasicBuzzerPlayer<Backend, Hooks>::RATE_MIN;
+template<class Backend, class Hooks> constexpr uint8_t BasicBuzzerPlayer<Backend, Hooks>::MAX_CATCHUP_STEPS;
+template<class Backend, class Hooks> constexpr uint8_t BasicBuzzerPlayer<Backend, Hooks>::REFEED_WINDOW;
+
+
+/**
+ * @brief Construct a new Buzzer Player:: Buzzer Player object
+ * 
+ * @param hwBackend - Reference to an hardware wave form generation implementation
+ * @param hooks - event callbacks (state of the hooks policy, usually empty)
+ */
+template<class Backend, class Hooks>
+BasicBuzzerPlayer<Backend, Hooks>::BasicBuzzerPlayer(Backend& hwBackend, const Hooks& hooks): 
+Hooks(hooks),
+hwBackend_(hwBackend),
+melodySource_(),
+source_(nullptr),
+currentStep_(Step{0, 0}),
+melodyStepIdx_(0),
+looping_(false),
+hasLoopRegion_(false),
+loopRegion_(LoopRegion{0, 0, 0}),
+loopPassesLeft_(0),
+pendingMelody_(Melody{nullptr, 0}),
+pendingSource_(nullptr),
+pendingAt_(SwapPoint::EndOfLoop),
+pendingLoop_(false),
+chainNextStep_(false),
+latePolicy_(LatePolicy::Skip),
+skippedSteps_(0),
+ownTimeIndex_(nullptr, 0),
+timeIndex_(&ownTimeIndex_),
+stepStartPosMs_(0),
+loopStartPosMs_(0),
+playbackRateQ8_(RATE_NORMAL),
+usPerMsQ8_(1000UL << 8),
+transpose_(0),
+stepDurationUs_(0),
+stepExtraUs_(0),
+stepRateQ8_(RATE_NORMAL),
+stepOffsetUs_(0),
+pausedRemainingUs_(0),
+hasResumePoint_(false),
+resumePoint_(),
+stepDelay_(Delay(0)),
+inFlight_(),
+refeed_(),
+feedDone_(false),
+generation_(0),
+state_(fsm::State::IDLE)
+{
+    stepDelay_.init();
+};
+
+
+/**
+ * @brief Loads the melody and arm the Player so it's start to play back the
+ * melody in hte next update() call.
+ * 
+ * @param melody - Reference to the melody to be played
+ * @param loop - Whether to loop the melody after it finishes
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::play(const Melody &melody, bool loop)
+{   
+    LOGI("play count=%u", (unsigned)melody.count);
+
+    // 1. Check if we are already playing a melody
+    if(isPlaying()) stop();         // Stop current playback if any
+
+    // 2. Walk the melody steps in place through the melody adapter
+    melodySource_.reset(melody);
+    play(melodySource_, loop);
+}
+
+/**
+ * @brief Loads a step source and arm the Player so it's start to play back the
+ * steps in the next update() call.
+ * 
+ * @param source - Step source to pull from. Must outlive the playback
+ * @param loop - Whether to rewind the source and start again after it finishes
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::play(IStepSource& source, bool loop)
+{
+    // 1. Check if we are already playing a melody
+    if(isPlaying()) stop();         // Stop current playback if any
+
+    // 2. Arm the player
+    start(source, loop);
+}
+
+/**
+ * @brief Play a melody that has an intro, a repeated section and an outro
+ * 
+ * @details
+ * The section is repeated inside advanceToNextStep(), so there is no gap between passes and
+ * the section is not duplicated in the step buffer.
+ * 
+ * @param melody - Reference to the melody to be played
+ * @param region - section to repeat. Ignored if empty or past the end of the melody
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::play(const Melody& melody, const LoopRegion& region)
+{
+    LOGI("play count=%u loop=[%u,%u)x%u", (unsigned)melody.count,
+        (unsigned)region.firstStep, (unsigned)region.endStep, (unsigned)region.count
+    );
+
+    if(isPlaying()) stop();
+
+    melodySource_.reset(melody);
+    play(melodySource_, region);
+}
+
+/**
+ * @brief Play a step source that has an intro, a repeated section and an outro
+ * 
+ * @param source - Step source to pull from. Must outlive the playback
+ * @param region - section to repeat. Ignored if empty
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::play(IStepSource& source, const LoopRegion& region)
+{
+    // 1. Arm the player as a one shot playback
+    play(source, false);
+    if (!isPlaying()) return;
+
+    // 2. Arm the loop section
+    if (region.firstStep < region.endStep)
+    {
+        hasLoopRegion_ = true;
+        loopRegion_ = region;
+        loopPassesLeft_ = region.count;
+        loopStartPosMs_ = 0;
+    }
+}
+
+/**
+ * @brief Queue a melody to replace the current one at a step or loop boundary
+ * 
+ * @details
+ * This is the front/back buffer handover: the application builds the next melody in a second
+ * buffer while the current one plays, then queues it. The player swaps sources inside update()
+ * when the boundary is reached, so the new melody starts at the deadline of the last step
+ * with no stop()/play() gap.
+ * 
+ * @param melody - melody to play next
+ * @param at - boundary where the swap happens
+ * @param loop - Whether to loop the new melody
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::queue(const Melody& melody, SwapPoint at, bool loop)
+{
+    // Nothing playing: no boundary to wait for
+    if (!isPlaying())
+    {
+        play(melody, loop);
+        return;
+    }
+
+    // The melody adapter is still in use by the current melody: keep the view until the swap
+    pendingMelody_ = melody;
+    queue(melodySource_, at, loop);
+}
+
+/**
+ * @brief Queue a step source to replace the current one at a step or loop boundary
+ * 
+ * @param source - Step source to pull from next
+ * @param at - boundary where the swap happens
+ * @param loop - Whether to loop the new source
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::queue(IStepSource& source, SwapPoint at, bool loop)
+{
+    if (!isPlaying())
+    {
+        play(source, loop);
+        return;
+    }
+
+    pendingSource_ = &source;
+    pendingAt_ = at;
+    pendingLoop_ = loop;
+}
+
+/**
+ * @brief Check if a queued melody is waiting for its swap point
+ * 
+ * @note A MelodyDoubleBuffer uses it to know when the old front buffer is free to be rebuilt
+ * 
+ * @return true - the queued melody has not started yet
+ * @return false - nothing queued
+ */
+template<class Backend, class Hooks>
+bool BasicBuzzerPlayer<Backend, Hooks>::isSwapPending() const
+{
+    return (pendingSource_ != nullptr);
+}
+
+/**
+ * @brief Stop the current playing melody and reset the scheduler
+ * 
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::stop()
+{
+    // 1.- Call the hardware backend to stop the buzzer
+    hwBackend_.stop();
+
+    // 2.Clear the active melody
+    source_ = nullptr;
+
+    // 3. Reset states
+    looping_ = false;
+    hasLoopRegion_ = false;
+    pendingSource_ = nullptr;
+    hasResumePoint_ = false;
+    melodyStepIdx_ = 0;
+
+    // 4. Set the FSM state to IDLE
+    state_ = fsm::State::IDLE;
+
+    // 5.- Stop the timer so won't fired later
+    stepDelay_.stopDelay();
+    chainNextStep_ = false;
+
+    // 6.- Forget the steps handed to a batch backend (it dropped them in stop()) or taken back from it
+    inFlight_.clear();
+    refeed_.clear();
+    feedDone_ = false;
+}
+
+/**
+ * @brief Gives the rest of the app a simple query to know if we are playing a melody
+ * 
+ * @note
+ * Why is usefull?
+ *  - UI: If you need to show on a display if we are playing
+ *  - logic: prevent re-trigger, so you can decide if you whether to queue something
+ *  - Enter in power save mode if you are not playing
+ * 
+ * @return true - if the buzzer is playing
+ * @return false - if we are in IDLE state so it's not playing a melody
+ */
+template<class Backend, class Hooks>
+bool BasicBuzzerPlayer<Backend, Hooks>::isPlaying() const
+{
+    return (state_ != fsm::State::IDLE); 
+}
+
+/**
+ * @brief Freeze the playback in the middle of the current step
+ * 
+ * @details The time left in the step is kept in microseconds, so resume() plays exactly
+ * the rest of the note and the melody keeps its rhythm.
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::pause()
+{
+    if (!isPlaying() || state_ == fsm::State::PAUSED) return;
+
+    // 1. Freeze the step timer (batch backend: take back the steps it was given)
+    if (!flushWindow())
+    {
+        if (state_ == fsm::State::START_STEP)
+        {
+            stepDurationUs_ = currentStepUs();
+            stepRateQ8_ = playbackRateQ8_;
+        }
+        pausedRemainingUs_ = remainingStepUs();
+        stepOffsetUs_ = stepDurationUs_ - pausedRemainingUs_;
+    }
+
+    // 2. Silence
+    hwBackend_.stop();
+    stepDelay_.stopDelay();
+
+    LOGI("pause idx=%u left=%luus", (unsigned)melodyStepIdx_, (unsigned long)pausedRemainingUs_);
+    state_ = fsm::State::PAUSED;
+}
+
+/**
+ * @brief Continue a paused playback
+ * 
+ * @details The current step plays again for the time it had left, then the next steps
+ * chain from that deadline as usual.
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::resume()
+{
+    if (state_ != fsm::State::PAUSED) return;
+
+    LOGI("resume idx=%u left=%luus", (unsigned)melodyStepIdx_, (unsigned long)pausedRemainingUs_);
+
+    // Batch backend: hand it the rest of the step, the steps taken back and the next ones follow in update()
+    if (Batch::ENABLED && (pausedRemainingUs_ > 0 || !refeed_.isEmpty() || feedDone_))
+    {
+        if (pausedRemainingUs_ > 0) feedStep(stepOffsetUs_);
+        state_ = fsm::State::PLAYING_STEP;
+        return;
+    }
+
+    // Step was already over: go to the next one, starting now
+    if (pausedRemainingUs_ == 0)
+    {
+        chainNextStep_ = false;
+        state_ = fsm::State::ADVANCE_STEP;
+        return;
+    }
+
+    // Play the rest of the step
+    if (currentStep_.freqHz > 0) hwBackend_.start(playbackHz(currentStep_.freqHz));
+    else hwBackend_.stop();
+
+    stepDelay_.init(pausedRemainingUs_);
+    chainNextStep_ = true;
+    state_ = fsm::State::PLAYING_STEP;
+}
+
+/**
+ * @brief Check if the playback is paused
+ * 
+ * @return true - paused, resume() continues it
+ */
+template<class Backend, class Hooks>
+bool BasicBuzzerPlayer<Backend, Hooks>::isPaused() const
+{
+    return (state_ == fsm::State::PAUSED);
+}
+
+/**
+ * @brief Play an alert, then resume the interrupted melody at the exact same position
+ * 
+ * @details
+ *  1. Save the cursor of the current playback: source, step, time left in it, loop state.
+ *     The steps stay where they are, nothing is copied (no second buffer)
+ *  2. Play the alert. When it ends advanceToNextStep() restores the cursor and resumes
+ * 
+ * Interrupting an alert replaces it and keeps the original resume point. If nothing is playing
+ * the alert is simply played.
+ * 
+ * @param alert - steps of the alert
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::interrupt(IStepSource& alert)
+{
+    // 1. Save the interrupted playback (batch backend: the step being heard, not the last one fed)
+    bool wasPaused = (state_ == fsm::State::PAUSED);
+    flushWindow();
+
+    if (isPlaying() && !hasResumePoint_)
+    {
+        resumePoint_.source = source_;
+        resumePoint_.step = currentStep_;
+        resumePoint_.stepIdx = melodyStepIdx_;
+        resumePoint_.stepStartPosMs = stepStartPosMs_;
+        resumePoint_.remainingUs = (state_ == fsm::State::PAUSED) ? pausedRemainingUs_ : remainingStepUs();
+        resumePoint_.stepDurationUs = (state_ == fsm::State::START_STEP) ? resumePoint_.remainingUs : stepDurationUs_;
+        resumePoint_.stepExtraUs = (state_ == fsm::State::START_STEP) ? source_->lastStepExtraUs() : stepExtraUs_;
+        resumePoint_.stepRateQ8 = (state_ == fsm::State::START_STEP) ? playbackRateQ8_ : stepRateQ8_;
+        resumePoint_.paused = wasPaused;
+        resumePoint_.looping = looping_;
+        resumePoint_.hasLoopRegion = hasLoopRegion_;
+        resumePoint_.loopRegion = loopRegion_;
+        resumePoint_.loopPassesLeft = loopPassesLeft_;
+        resumePoint_.loopStartPosMs = loopStartPosMs_;
+        resumePoint_.refeed = refeed_;
+        resumePoint_.feedDone = feedDone_;
+        hasResumePoint_ = true;
+
+        LOGI("interrupt idx=%u left=%luus", (unsigned)melodyStepIdx_, (unsigned long)resumePoint_.remainingUs);
+    }
+
+    // The steps taken back belong to the playback saved above, or to the alert being replaced
+    refeed_.clear();
+    feedDone_ = false;
+
+    // 2. Play the alert from the next update
+    hwBackend_.stop();
+    stepDelay_.stopDelay();
+    state_ = fsm::State::IDLE;
+
+    if (!start(alert, false) && hasResumePoint_) restoreResumePoint();     // empty alert
+}
+
+/**
+ * @brief This function is the Engine of the FSM.
+ * Progress the FSM states without blocking, base on timer
+ * 
+ * @details
+ *  - update(): must be call ofter (in the main loop() or at least every few milliseconds)
+ *  - Not heavy work is done here , just small constant work and return quickly
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::update()
+{
+    using namespace fsm;    
+
+    switch (state_)
+    {
+        case State::IDLE :
+        {            
+            // Do nothing
+            break;
+        }
+
+        case State::START_STEP:
+        {
+            startStep();
+            break;    
+        }       
+        
+        case State::PLAYING_STEP:
+        {
+            // Batch backend: it switches the notes, we only keep its window full
+            if (Batch::ENABLED)
+            {
+                serviceWindow();
+                break;
+            }
+
+            // Wait until the note duration elapsed
+            if(!stepDelay_.hasElapsed()) break;
+
+            LOGI("step idx=%u f=%u ms=%lu",
+                (unsigned)melodyStepIdx_, (unsigned)getCurrentStep().freqHz, (unsigned long)getCurrentStep().durationMs
+            );
+
+            hooks().onStepEnd(melodyStepIdx_, currentStep_.freqHz);
+
+            // The next step starts in this same call: every extra update() would add a loop period of latency
+            advanceToNextStep();
+            if (state_ == State::START_STEP) startStep();
+            break;
+        }
+        
+
+        case State::ADVANCE_STEP:
+        {
+            advanceToNextStep();
+            if (state_ == State::START_STEP) startStep();
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+}
+
+
+
+/**
+ * @brief Use application provided storage for the prefix sum index of the melodies
+ * 
+ * @details Without it the player only caches the total duration and seek() is a linear scan.
+ * 
+ * @param index - index storage, must outlive the player
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::attachTimeIndex(TimeIndex& index)
+{
+    timeIndex_ = &index;
+    timeIndex_->invalidate();
+}
+
+/**
+ * @brief Get the position in the melody
+ * 
+ * @details O(1): start of the current step (tracked as steps advance) + time spent in it.
+ * 
+ * @return uint32_t - ms from the start of the melody, 0 when idle
+ */
+template<class Backend, class Hooks>
+uint32_t BasicBuzzerPlayer<Backend, Hooks>::elapsedMs() const
+{
+    if (!isPlaying()) return 0;
+
+    // Batch backend: the step being heard is the oldest one handed to it
+    if (!inFlight_.isEmpty())
+    {
+        const InFlightStep& heard = inFlight_.front();
+        uint32_t heardMs = stepMelodyMs(heard.offsetUs + Batch::elapsedUs(hwBackend_), heard.rateQ8);
+        if (heardMs > heard.step.durationMs) heardMs = heard.step.durationMs;
+
+        return heard.startPosMs + heardMs;
+    }
+
+    // The step timer is armed in START_STEP: until then no time was spent in the step
+    uint32_t inStepMs = 0;
+    if (state_ == fsm::State::PAUSED)
+    {
+        inStepMs = stepMelodyMs(stepOffsetUs_, stepRateQ8_);
+    }
+    else if (state_ != fsm::State::START_STEP)
+    {
+        inStepMs = stepMelodyMs(stepOffsetUs_ + stepDelay_.elapsed(), stepRateQ8_);
+    }
+    if (inStepMs > currentStep_.durationMs) inStepMs = currentStep_.durationMs;
+
+    return stepStartPosMs_ + inStepMs;
+}
+
+/**
+ * @brief Get the duration of the melody being played
+ * 
+ * @details The first call after play() indexes the melody (one pass over its steps),
+ * the next ones are O(1).
+ * 
+ * @return uint32_t - ms, 0 when idle or if the duration is unknown (endless source)
+ */
+template<class Backend, class Hooks>
+uint32_t BasicBuzzerPlayer<Backend, Hooks>::totalMs()
+{
+    if (!isPlaying()) return 0;
+
+    return ensureTimeIndex().totalMs();
+}
+
+/**
+ * @brief Get the time left until the end of the melody
+ * 
+ * @note With looping or a loop section it is the time left in the current pass
+ * 
+ * @return uint32_t - ms, 0 when idle or unknown
+ */
+template<class Backend, class Hooks>
+uint32_t BasicBuzzerPlayer<Backend, Hooks>::remainingMs()
+{
+    uint32_t total = totalMs();
+    uint32_t elapsed = elapsedMs();
+
+    return (total > elapsed) ? (total - elapsed) : 0;
+}
+
+/**
+ * @brief Jump to a position of the melody being played
+ * 
+ * @details
+ *  1. Find the step playing at ms: binary search in the time index, or a scan of the source
+ *     when the melody does not fit in the index storage
+ *  2. Position the source after it and play only the part of the step left after ms
+ * 
+ * @param ms - position from the start of the melody
+ * @return true - playback continues from ms at the next update()
+ * @return false - nothing playing, source not replayable, duration unknown or ms past the end
+ */
+template<class Backend, class Hooks>
+bool BasicBuzzerPlayer<Backend, Hooks>::seek(uint32_t ms)
+{
+    // A live or endless source cannot be positioned: it is left untouched
+    if (!isPlaying() || !source_->isReplayable()) return false;
+
+    // Batch backend: take the window back first, the cursor is then the step being heard
+    bool wasPaused = (state_ == fsm::State::PAUSED);
+    flushWindow();
+
+    TimeIndex& index = ensureTimeIndex();
+    if (!index.isComplete() || ms >= index.totalMs())
+    {
+        if (!wasPaused) resume();
+        return false;
+    }
+
+    // 1. Find the step playing at ms
+    size_t idx = 0;
+    uint32_t startMs = 0;
+    if (index.hasPrefix())
+    {
+        idx = index.stepAt(ms);
+        startMs = index.stepStartMs(idx);
+        if (!source_->seek(idx) || !source_->next(currentStep_))
+        {
+            if (!wasPaused) resume();
+            return false;
+        }
+    }
+    else
+    {
+        source_->rewind();
+        while (source_->next(currentStep_) && startMs + currentStep_.durationMs <= ms)
+        {
+            startMs += currentStep_.durationMs;
+            ++idx;
+        }
+    }
+
+    // 2. Play the rest of that step from the next update (or from resume() when paused), the steps taken back are stale
+    refeed_.clear();
+    feedDone_ = false;
+    currentStep_.durationMs -= (ms - startMs);
+    melodyStepIdx_ = idx;
+    stepStartPosMs_ = ms;
+    chainNextStep_ = false;
+
+    if (state_ == fsm::State::PAUSED)
+    {
+        stepDurationUs_ = scaledDurationUs(currentStep_.durationMs);
+        stepExtraUs_ = 0;
+        stepRateQ8_ = playbackRateQ8_;
+        pausedRemainingUs_ = stepDurationUs_;
+        stepOffsetUs_ = 0;
+    }
+    else
+    {
+        state_ = fsm::State::START_STEP;
+    }
+
+    if (state_ == fsm::State::PAUSED && !wasPaused) resume();
+
+    LOGI("seek ms=%lu idx=%u", (unsigned long)ms, (unsigned)idx);
+    return true;
+}
+
+/**
+ * @brief Change the tempo of the playback without rebuilding the melody
+ * 
+ * @details
+ * The multiplier is turned once here into "real us per melody ms", so starting a step costs
+ * a multiply and a shift instead of a division. The step being played keeps its length,
+ * the new rate applies from the next step.
+ * 
+ * @param rateQ8 - unsigned q8.8 tempo multiplier (0x0100 = as built). Clamped to RATE_MIN
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::setPlaybackRate(uint16_t rateQ8)
+{
+    if (rateQ8 < RATE_MIN) rateQ8 = RATE_MIN;
+
+    playbackRateQ8_ = rateQ8;
+    usPerMsQ8_ = ((1000UL << 16) + (rateQ8 / 2)) / rateQ8;      // q24.8, rounded
+}
+
+/**
+ * @brief Get the tempo multiplier
+ * 
+ * @return uint16_t - q8.8
+ */
+template<class Backend, class Hooks>
+uint16_t BasicBuzzerPlayer<Backend, Hooks>::playbackRate() const
+{
+    return playbackRateQ8_;
+}
+
+/**
+ * @brief Change the pitch of the playback without rebuilding the melody
+ * 
+ * @param semitones - interval applied to every step from the next one on
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::setTranspose(int8_t semitones)
+{
+    transpose_ = semitones;
+}
+
+/**
+ * @brief Get the pitch shift
+ * 
+ * @return int8_t - semitones
+ */
+template<class Backend, class Hooks>
+int8_t BasicBuzzerPlayer<Backend, Hooks>::transpose() const
+{
+    return transpose_;
+}
+
+/**
+ * @brief Choose what happens to steps whose deadline passed before update() was called
+ * 
+ * @param policy - Skip keeps the melody aligned with time and silent while behind, PlayAll
+ * sounds every step (the late ones briefly), Resync never cuts a step but the melody ends later
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::setLatePolicy(LatePolicy policy)
+{
+    latePolicy_ = policy;
+}
+
+/**
+ * @brief Get the late update policy
+ * 
+ * @return LatePolicy 
+ */
+template<class Backend, class Hooks>
+LatePolicy BasicBuzzerPlayer<Backend, Hooks>::latePolicy() const
+{
+    return latePolicy_;
+}
+
+/**
+ * @brief Get how many steps were skipped because update() came too late
+ * 
+ * @details Useful to tune the main loop: it should stay at 0. Saturates at 0xFFFF.
+ * 
+ * @return uint16_t - steps
+ */
+template<class Backend, class Hooks>
+uint16_t BasicBuzzerPlayer<Backend, Hooks>::skippedSteps() const
+{
+    return skippedSteps_;
+}
+
+/**
+ * @brief Let a timer wheel track the end of the steps
+ * 
+ * @details With several players and Delays in the loop, the wheel reads the clock once per
+ * loop() and each update() only tests whether its deadline was reached. Note boundaries are
+ * then rounded up to the wheel tick (chained, so the rounding does not add up). A batch
+ * backend times its steps itself and ignores the wheel.
+ * 
+ * @param wheel - wheel polled before update(), nullptr to detach
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::attachTimerWheel(TimerWheel* wheel)
+{
+    stepDelay_.attach(wheel);
+}
+
+/**
+ * @brief Access the hooks policy object, e.g. to configure it or read its state
+ * 
+ * @return Hooks& 
+ */
+template<class Backend, class Hooks>
+Hooks& BasicBuzzerPlayer<Backend, Hooks>::hooks()
+{
+    return *this;
+}
+
+//////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+/**
+ * @brief Real time a step lasts at the current playback rate
+ * 
+ * @details durationUs = durationMs * usPerMs, split in integer and fractional (q8) parts so
+ * the 32 bits product does not overflow for long notes.
+ * 
+ * @param durationMs - step duration in the melody
+ * @return uint32_t - us
+ */
+template<class Backend, class Hooks>
+uint32_t BasicBuzzerPlayer<Backend, Hooks>::scaledDurationUs(uint32_t durationMs) const
+{
+    if (playbackRateQ8_ == RATE_NORMAL) return durationMs * 1000UL;
+
+    return durationMs * (usPerMsQ8_ >> 8) + ((durationMs * (usPerMsQ8_ & 0xFF)) >> 8);
+}
+
+/**
+ * @brief Real time the current step lasts at the current playback rate
+ * 
+ * @details Adds the sub-ms part the source reports for it (IStepSource::lastStepExtraUs()),
+ * e.g. the beats of a MetronomeSource that are not a whole number of ms.
+ * 
+ * @return uint32_t - us
+ */
+template<class Backend, class Hooks>
+uint32_t BasicBuzzerPlayer<Backend, Hooks>::currentStepUs() const
+{
+    return currentStepUs((source_ != nullptr) ? source_->lastStepExtraUs() : 0);
+}
+
+/**
+ * @brief Real time the current step lasts at the current playback rate, with a given sub-ms part
+ * 
+ * @details For a step that is not the last one the source returned (a step taken back from a
+ * batch backend): the source no longer reports its sub-ms part.
+ * 
+ * @param extraUs - us added to its duration in ms
+ * @return uint32_t - us
+ */
+template<class Backend, class Hooks>
+uint32_t BasicBuzzerPlayer<Backend, Hooks>::currentStepUs(uint16_t extraUs) const
+{
+    uint32_t us = scaledDurationUs(currentStep_.durationMs);
+
+    if (extraUs == 0) return us;
+    if (playbackRateQ8_ == RATE_NORMAL) return us + extraUs;
+
+    return us + ((uint32_t)extraUs << 8) / playbackRateQ8_;
+}
+
+/**
+ * @brief Convert real time spent in a step to melody time
+ * 
+ * @param realUs - us played of the step
+ * @param rateQ8 - playback rate the step was started with
+ * @return uint32_t - ms of the melody
+ */
+template<class Backend, class Hooks>
+uint32_t BasicBuzzerPlayer<Backend, Hooks>::stepMelodyMs(uint32_t realUs, uint16_t rateQ8) const
+{
+    if (rateQ8 == RATE_NORMAL) return realUs / 1000UL;
+
+    return ((realUs / 1000UL) * rateQ8) >> 8;
+}
+
+/**
+ * @brief Frequency sent to the backend
+ * 
+ * @param hz - step frequency
+ * @return uint16_t - hz shifted by the transpose setting
+ */
+template<class Backend, class Hooks>
+uint16_t BasicBuzzerPlayer<Backend, Hooks>::playbackHz(uint16_t hz) const
+{
+    return (transpose_ == 0) ? hz : pitch::transpose(hz, transpose_);
+}
+
+/**
+ * @brief Gets the current step we are playing in a melody(sequence of steps)
+ * 
+ * @return const Step& - current step that's been playing
+ */
+template<class Backend, class Hooks>
+const Step& BasicBuzzerPlayer<Backend, Hooks>::getCurrentStep() const
+{
+    return currentStep_;
+}
+
+/**
+ * @brief This function advance the to the next musical note(Step) on the melody
+ * 
+ * @details 
+ *  1. It validates that there is a source(!nullptr) and pulls the next step from it
+ *  2. Handle the end of the sequence:
+ *      - If we end the current melody and looping is enable -> start a new pass of the source (nextPass())
+ *      - If we reached the end -> stop playing and ensure reset state
+ *  3. otherwise advance to the next step(No edge case) 
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::advanceToNextStep()
+{
+    // 1. Validate source
+    if (source_ == nullptr)
+    {
+        stop();
+        return;
+    }
+
+    // 2. Increment idx of the melody steps, the next one starts where the current one ended
+    ++melodyStepIdx_;
+    stepStartPosMs_ += currentStep_.durationMs;
+
+    // 2.1 Queued melody waiting for a step boundary (not while an alert plays)
+    if (pendingSource_ != nullptr && !hasResumePoint_ && pendingAt_ == SwapPoint::NextStep)
+    {
+        if (!swapToPending()) finish();
+        return;
+    }
+
+    // 2.2 End of the loop section: swap to the queued melody or jump back to its first step while passes are left
+    if (hasLoopRegion_ && melodyStepIdx_ == loopRegion_.endStep)
+    {
+        if (pendingSource_ != nullptr && !hasResumePoint_)
+        {
+            if (!swapToPending()) finish();
+            return;
+        }
+
+        bool forever = (loopRegion_.count == 0);
+        if ((forever || --loopPassesLeft_ > 0) && source_->seek(loopRegion_.firstStep))
+        {
+            melodyStepIdx_ = loopRegion_.firstStep;
+            stepStartPosMs_ = loopStartPosMs_;
+            hooks().onLoop(melodyStepIdx_);
+        }
+    }
+
+    // 2.3 Remember where the loop section starts in time, to jump back there
+    if (hasLoopRegion_ && melodyStepIdx_ == loopRegion_.firstStep) loopStartPosMs_ = stepStartPosMs_;
+
+    // 3. Handle the end of the sequence
+    if(!source_->next(currentStep_))
+    {
+        // End of an alert: back to the interrupted melody (if it stays paused, after the alert was heard)
+        if (hasResumePoint_)
+        {
+            if (Batch::ENABLED && resumePoint_.paused) feedDone_ = true;
+            else restoreResumePoint();
+            return;
+        }
+
+        // Queued melody waiting for the end of this one
+        if (pendingSource_ != nullptr)
+        {
+            if (!swapToPending()) finish();
+            return;
+        }
+
+        // If looping is true -> start a new pass of the melody from the beginning
+        if (looping_)
+        {
+            if (source_->nextPass()) timeIndex_->invalidate();
+            if (source_->next(currentStep_))
+            {
+                melodyStepIdx_ = 0;
+                stepStartPosMs_ = 0;
+                hooks().onLoop(0);
+                state_ = fsm::State::START_STEP;
+                return;
+            }
+        }
+
+        // We finish and looping_ is disable -> stop Player
+        finish(); // Ensure hardware backend stops and reset state.
+        return;        
+    }
+
+    // 4. Advance to the next step of the melody
+    state_ = fsm::State::START_STEP;
+
+}
+
+/**
+ * @brief Sound the current step and arm its timer
+ * 
+ * @details
+ * The first step starts now, the next ones at the deadline of the previous one. If update()
+ * came so late that the chained step is already over, the late policy decides:
+ *  - Skip: the step is not sounded, the next one is chained (at most MAX_CATCHUP_STEPS per call)
+ *  - PlayAll: the step sounds until the next update()
+ *  - Resync: the step starts now with its full length
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::startStep()
+{
+    // Batch backend: no timer, it plays the step after the ones it already has
+    if (Batch::ENABLED)
+    {
+        stepExtraUs_ = source_->lastStepExtraUs();
+        stepDurationUs_ = currentStepUs(stepExtraUs_);
+        stepRateQ8_ = playbackRateQ8_;
+        feedStep(0);
+        state_ = fsm::State::PLAYING_STEP;
+        serviceWindow();
+        return;
+    }
+
+    for (uint8_t caughtUp = 0; ; ++caughtUp)
+    {
+        // 1. Arm timer with the duration at the current playback rate (Delay uses Us)
+        stepDurationUs_ = currentStepUs();
+        stepRateQ8_ = playbackRateQ8_;
+        stepOffsetUs_ = 0;
+
+        if (!chainNextStep_) 
+        {
+            stepDelay_.init(stepDurationUs_);
+            chainNextStep_ = true;
+            break;
+        }
+
+        stepDelay_.chain(stepDurationUs_);
+        if (!stepDelay_.hasElapsed()) break;
+
+        // 2. The step is already over
+        if (latePolicy_ == LatePolicy::Resync)
+        {
+            stepDelay_.init(stepDurationUs_);
+            break;
+        }
+
+        if (latePolicy_ != LatePolicy::Skip || caughtUp >= MAX_CATCHUP_STEPS) break;
+
+        if (skippedSteps_ < 0xFFFF) ++skippedSteps_;
+        LOGD("late, skip idx=%u", (unsigned)melodyStepIdx_);
+
+        advanceToNextStep();
+        if (state_ != fsm::State::START_STEP) return;      // finished, or an alert ended and restored its melody
+    }
+
+    // 3. Check if we need to play a note of is a REST(transpose applied here, the melody is untouched)
+    if (currentStep_.freqHz > 0) hwBackend_.start(playbackHz(currentStep_.freqHz));    // Play note
+    else hwBackend_.stop();                                                             // REST == playing a silence
+
+    hooks().onStepStart(melodyStepIdx_, currentStep_.freqHz);
+
+    LOGI("step idx=%u f=%u ms=%lu",
+        (unsigned)melodyStepIdx_, (unsigned)currentStep_.freqHz, (unsigned long)currentStep_.durationMs
+    );
+
+    // 4. Move to wait until finish playin current step
+    state_ = fsm::State::PLAYING_STEP;
+}
+
+/**
+ * @brief The playback ended by itself(not by stop()): tell the hooks, then stop
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::finish()
+{
+    // Batch backend: the last steps are still playing, serviceWindow() finishes once they are heard
+    if (Batch::ENABLED)
+    {
+        feedDone_ = true;
+        return;
+    }
+
+    hooks().onFinish();
+    stop();
+}
+
+/**
+ * @brief Hand the current step to a batch backend
+ * 
+ * @details The step is also kept in the in flight window: it is reported to the hooks when
+ * the backend actually plays it, and pause()/seek()/interrupt() can take it back.
+ * 
+ * @param offsetUs - part of the step already played (resume), only the rest is handed over
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::feedStep(uint32_t offsetUs)
+{
+    InFlightStep fed;
+    fed.source = source_;
+    fed.generation = generation_;
+    fed.step = currentStep_;
+    fed.idx = melodyStepIdx_;
+    fed.startPosMs = stepStartPosMs_;
+    fed.durationUs = stepDurationUs_;
+    fed.extraUs = stepExtraUs_;
+    fed.offsetUs = offsetUs;
+    fed.rateQ8 = stepRateQ8_;
+    fed.loopPassesLeft = loopPassesLeft_;
+
+    bool wasIdle = inFlight_.isEmpty();
+    inFlight_.push(fed);
+    Batch::push(hwBackend_, BatchStep{playbackHz(currentStep_.freqHz), stepDurationUs_ - offsetUs});
+
+    LOGD("feed idx=%u f=%u us=%lu", (unsigned)melodyStepIdx_, (unsigned)currentStep_.freqHz, (unsigned long)stepDurationUs_);
+
+    // Nothing else queued: the backend starts it right away
+    if (wasIdle) hooks().onStepStart(fed.idx, fed.step.freqHz);
+}
+
+/**
+ * @brief Keep a batch backend busy
+ * 
+ * @details
+ *  1. Report the steps the backend finished and the step it plays now to the hooks
+ *  2. Until its window is full: feed again the steps taken back by flushWindow(), then pull
+ *     the next steps (loops, swaps, alerts as usual)
+ *  3. Once the source ended and the backend played everything: finish, or restore the
+ *     melody an alert interrupted
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::serviceWindow()
+{
+    // 1. Completed steps
+    for (uint8_t done = Batch::takeCompleted(hwBackend_); done > 0 && !inFlight_.isEmpty(); --done)
+    {
+        hooks().onStepEnd(inFlight_.front().idx, inFlight_.front().step.freqHz);
+        inFlight_.pop();
+
+        if (!inFlight_.isEmpty()) hooks().onStepStart(inFlight_.front().idx, inFlight_.front().step.freqHz);
+    }
+
+    // 2. Refill
+    while (state_ == fsm::State::PLAYING_STEP && !inFlight_.isFull() && Batch::freeSlots(hwBackend_) > 0)
+    {
+        if (!refeed_.isEmpty())
+        {
+            refeedStep();
+            continue;
+        }
+        if (feedDone_) break;
+
+        advanceToNextStep();
+        if (state_ != fsm::State::START_STEP) break;       // ended, stopped or resumed an interrupted melody
+
+        stepExtraUs_ = source_->lastStepExtraUs();
+        stepDurationUs_ = currentStepUs(stepExtraUs_);
+        stepRateQ8_ = playbackRateQ8_;
+        feedStep(0);
+        state_ = fsm::State::PLAYING_STEP;
+    }
+
+    // 3. Everything was heard
+    if (feedDone_ && inFlight_.isEmpty() && refeed_.isEmpty())
+    {
+        feedDone_ = false;
+        if (hasResumePoint_)
+        {
+            restoreResumePoint();
+            return;
+        }
+
+        hooks().onFinish();
+        stop();
+    }
+}
+
+/**
+ * @brief Take back the steps handed to a batch backend
+ * 
+ * @details
+ * The cursor of the player is the last step fed, ahead of what is heard. Before acting on the
+ * playback (pause, seek, interrupt) it goes back to the step being heard: the backend is stopped
+ * and the player is PAUSED in the middle of that step. The steps fed after it were read from the
+ * source but not heard: they are kept and fed again before the source is read (the source is not
+ * sought back, it may be a stream). If a queued melody was swapped in inside the window, the
+ * cursor goes back to its first step instead.
+ * 
+ * @return true - the window was taken back, the player is PAUSED
+ * @return false - nothing was handed to the backend (plain backend, or not started yet)
+ */
+template<class Backend, class Hooks>
+bool BasicBuzzerPlayer<Backend, Hooks>::flushWindow()
+{
+    if (inFlight_.isEmpty()) return false;
+
+    // 1. How far the backend got in the step it plays
+    uint32_t playedUs = inFlight_.front().offsetUs + Batch::elapsedUs(hwBackend_);
+    hwBackend_.stop();
+
+    // 2. Steps of a playback that was replaced in the window are dropped (the melody adapter is
+    //    reused by a melody swap: the source alone does not tell them apart)
+    while (inFlight_.size() > 1 && inFlight_.front().generation != generation_)
+    {
+        inFlight_.pop();
+        playedUs = inFlight_.front().offsetUs;
+    }
+
+    // 3. Back to that step
+    const InFlightStep& heard = inFlight_.front();
+    source_ = heard.source;
+    currentStep_ = heard.step;
+    melodyStepIdx_ = heard.idx;
+    stepStartPosMs_ = heard.startPosMs;
+    stepDurationUs_ = heard.durationUs;
+    stepExtraUs_ = heard.extraUs;
+    stepRateQ8_ = heard.rateQ8;
+    loopPassesLeft_ = heard.loopPassesLeft;
+
+    if (playedUs > stepDurationUs_) playedUs = stepDurationUs_;
+    stepOffsetUs_ = playedUs;
+    pausedRemainingUs_ = stepDurationUs_ - playedUs;
+
+    // 4. The steps after it go first, then those still waiting from an earlier flush (they fit: the
+    //    source is only read once they were all fed again)
+    inFlight_.pop();
+    for (; !refeed_.isEmpty(); refeed_.pop()) inFlight_.push(refeed_.front());
+    for (; !inFlight_.isEmpty(); inFlight_.pop()) refeed_.push(inFlight_.front());
+
+    state_ = fsm::State::PAUSED;
+
+    return true;
+}
+
+/**
+ * @brief Hand the oldest step taken back by flushWindow() to the backend again
+ * 
+ * @details The cursor moves to it as if it was just read from the source: it is played at the
+ * current rate, with the sub-ms part the source reported when it was first read.
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::refeedStep()
+{
+    const InFlightStep& next = refeed_.front();
+    source_ = next.source;
+    currentStep_ = next.step;
+    melodyStepIdx_ = next.idx;
+    stepStartPosMs_ = next.startPosMs;
+    loopPassesLeft_ = next.loopPassesLeft;
+    stepExtraUs_ = next.extraUs;
+    refeed_.pop();
+
+    stepDurationUs_ = currentStepUs(stepExtraUs_);
+    stepRateQ8_ = playbackRateQ8_;
+    feedStep(0);
+}
+
+/**
+ * @brief Arm the player on a source so it starts in the next update() call
+ * 
+ * @details Resets the per playback state only: a resume point or a queued melody survive,
+ * which is what interrupt() needs.
+ * 
+ * @param source - Step source to pull from
+ * @param loop - Whether to rewind the source and start again after it finishes
+ * @return true - first step fetched, START_STEP armed
+ * @return false - the source is empty, nothing to play
+ */
+template<class Backend, class Hooks>
+bool BasicBuzzerPlayer<Backend, Hooks>::start(IStepSource& source, bool loop)
+{
+    // 1. Store the source and loop flag
+    source_ = &source;
+    ++generation_;
+    looping_ = loop;
+    hasLoopRegion_ = false;
+
+    // 2. Reset the step index and fetch the first step(its timer starts at the next update)
+    melodyStepIdx_ = 0;
+    chainNextStep_ = false;
+    stepStartPosMs_ = 0;
+    timeIndex_->invalidate();
+    source_->rewind();
+    if (!source_->next(currentStep_))
+    {
+        // Empty sequence: nothing to play
+        source_ = nullptr;
+        return false;
+    }
+
+    // 3. Set the FSM state to START_STEP to begin playback in the next update
+    state_ = fsm::State::START_STEP;
+    return true;
+}
+
+/**
+ * @brief Get the time left in the current step
+ * 
+ * @return uint32_t - us (full step before it starts, 0 once it is over)
+ */
+template<class Backend, class Hooks>
+uint32_t BasicBuzzerPlayer<Backend, Hooks>::remainingStepUs() const
+{
+    switch (state_)
+    {
+        case fsm::State::START_STEP:    return currentStepUs();
+        case fsm::State::PAUSED:        return pausedRemainingUs_;
+        case fsm::State::PLAYING_STEP:
+        {
+            uint32_t playedUs = stepOffsetUs_ + stepDelay_.elapsed();
+            return (playedUs < stepDurationUs_) ? (stepDurationUs_ - playedUs) : 0;
+        }
+        default:                        return 0;
+    }
+}
+
+/**
+ * @brief Restore the playback interrupted by an alert, at the exact point it was left
+ * 
+ * @details The interrupted source was not touched while the alert played, so it is already
+ * positioned after the last step read (with a batch backend the steps it had not played are fed
+ * again first). The step plays for the time it had left (or stays paused).
+ */
+template<class Backend, class Hooks>
+void BasicBuzzerPlayer<Backend, Hooks>::restoreResumePoint()
+{
+    hasResumePoint_ = false;
+
+    // 1. Restore the cursor
+    source_ = resumePoint_.source;
+    ++generation_;
+    currentStep_ = resumePoint_.step;
+    melodyStepIdx_ = resumePoint_.stepIdx;
+    stepStartPosMs_ = resumePoint_.stepStartPosMs;
+    looping_ = resumePoint_.looping;
+    hasLoopRegion_ = resumePoint_.hasLoopRegion;
+    loopRegion_ = resumePoint_.loopRegion;
+    loopPassesLeft_ = resumePoint_.loopPassesLeft;
+    loopStartPosMs_ = resumePoint_.loopStartPosMs;
+    refeed_ = resumePoint_.refeed;
+    feedDone_ = resumePoint_.feedDone;
+    timeIndex_->invalidate();
+
+    // 2. Continue from the time left in the step
+    pausedRemainingUs_ = resumePoint_.remainingUs;
+    stepDurationUs_ = resumePoint_.stepDurationUs;
+    stepExtraUs_ = resumePoint_.stepExtraUs;
+    stepRateQ8_ = resumePoint_.stepRateQ8;
+    stepOffsetUs_ = stepDurationUs_ - pausedRemainingUs_;
+    state_ = fsm::State::PAUSED;
+
+    LOGI("restore idx=%u left=%luus", (unsigned)melodyStepIdx_, (unsigned long)pausedRemainingUs_);
+
+    if (!resumePoint_.paused) resume();
+}
+
+/**
+ * @brief Build the time index of the current source if it is not valid
+ * 
+ * @details Indexing reads the whole source, then the source is positioned back after the
+ * last step read (the current one, or the last one taken back from a batch backend) so the
+ * playback goes on unchanged. A source that is not replayable (stream,
+ * endless generator) is not touched: the index stays invalid, the duration unknown.
+ * 
+ * @return TimeIndex& - the index of the current source
+ */
+template<class Backend, class Hooks>
+TimeIndex& BasicBuzzerPlayer<Backend, Hooks>::ensureTimeIndex()
+{
+    if (!timeIndex_->isValid() && source_ != nullptr && source_->isReplayable())
+    {
+        size_t lastReadIdx = refeed_.isEmpty() ? melodyStepIdx_ : refeed_.back().idx;
+        timeIndex_->build(*source_);
+        source_->seek(lastReadIdx + 1);
+    }
+
+    return *timeIndex_;
+}
+
+/**
+ * @brief Replace the current source by the queued one, in place of its next step
+ * 
+ * @details 
+ *  1. Take the queued source, loop flag and (when it is a Melody) point the melody adapter to it
+ *  2. Rewind it and fetch its first step, the FSM then starts it like any other step
+ * 
+ * @return true - the queued source has steps, START_STEP armed
+ * @return false - the queued source is empty
+ */
+template<class Backend, class Hooks>
+bool BasicBuzzerPlayer<Backend, Hooks>::swapToPending()
+{
+    LOGI("swap at idx=%u", (unsigned)melodyStepIdx_);
+
+    // 1. Take the queued source
+    IStepSource* next = pendingSource_;
+    pendingSource_ = nullptr;
+
+    if (next == &melodySource_) melodySource_.reset(pendingMelody_);
+
+    source_ = next;
+    ++generation_;
+    looping_ = pendingLoop_;
+    hasLoopRegion_ = false;
+    melodyStepIdx_ = 0;
+    stepStartPosMs_ = 0;
+    timeIndex_->invalidate();
+
+    // 2. Fetch its first step
+    source_->rewind();
+    if (!source_->next(currentStep_)) return false;
+
+    state_ = fsm::State::START_STEP;
+    return true;
+}
+
+
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdint.h>
+#include "player/BuzzerPlayer.h"
+#include "sources/ScoreViewSource.h"
+#include "presetTones/Presets.h"
+#include "Timer/TimerWheel.h"
+
+/**
+ * @brief Fixed capacity list of sound events scheduled at absolute times
+ *
+ * @details
+ * Every cue has its own micros() timestamp, so a countdown or a 1 s tick computed as
+ * "t0 + k * period" does not drift: a late cue does not push the next ones (unlike a Delay
+ * restarted by hand after each one). Cues are kept sorted, so checking them is one comparison
+ * with the earliest.
+ *
+ * When a cue is due the player starts it right away (play() + update() in the same call), so its
+ * first edge comes at most one check period late: one update() of the list, or one tick when
+ * the list is attached to a TimerWheel (the wheel then calls it, update() is not needed).
+ * A cue replaces whatever the player was playing. Presets are converted while they play
+ * (ScoreViewSource), no MelodyBuilder pass.
+ *
+ * Example usage (countdown to T = now + 10 s):
+ *
+ * CueList<8> cues(player);
+ * unsigned long t = micros() + 10000000UL;
+ * for (uint8_t s = 3; s > 0; --s) cues.playAt(t - s * 1000000UL, PresetId::ButtonClick);
+ * cues.playAt(t, finalTone);
+ *
+ * void loop() { cues.update(); player.update(); }
+ *
+ * @tparam Capacity - cues the list can hold
+ * @tparam Player - BasicBuzzerPlayer instantiation the cues are played on
+ */
+template<uint8_t Capacity, class Player = BuzzerPlayer>
+class BasicCueList
+{
+    public:
+
+        /// @brief Constructor
+        /// @param player - player the cues are played on
+        /// @param presetCtx - tempo and gap used to play the preset cues
+        BasicCueList(Player& player, const MelodyContext& presetCtx = MelodyContext());
+
+        /// @brief Schedule a melody
+        /// @param atUs - micros() time of its first note. A time already passed plays at the next check
+        /// @param melody - steps to play. They must stay untouched until the cue has played
+        /// @return false if the list is full
+        bool playAt(unsigned long atUs, const Melody& melody);
+
+        /// @brief Schedule a preset tone
+        /// @param atUs - micros() time of its first note
+        /// @param preset - preset to play
+        /// @return false if the list is full
+        bool playAt(unsigned long atUs, PresetId preset);
+
+        /// @brief Start the cues whose time has come. Call it every loop() pass when no wheel is attached
+        void update();
+
+        /// @brief Let a timer wheel start the cues on its tick instead of update()
+        /// @param wheel - wheel polled by the application, nullptr to go back to update()
+        void attachTimerWheel(TimerWheel* wheel);
+
+        /// @brief Drop every scheduled cue (the one playing keeps playing)
+        void clear();
+
+        /// @brief Cues still waiting
+        uint8_t pending() const;
+
+        /// @brief Tempo and gap of the preset cues
+        void setPresetContext(const MelodyContext& ctx);
+
+    private:
+
+        /// @brief One scheduled event
+        struct Cue
+        {
+            unsigned long atUs;     // micros() time it starts
+            Melody melody;          // steps (when !isPreset)
+            PresetId preset;        // preset (when isPreset)
+            bool isPreset;
+        };
+
+        /// @brief Insert keeping the list sorted by time (stable: same time keeps insertion order)
+        bool insert(const Cue& cue);
+
+        /// @brief Play the due cues in order (the last one stays on the player)
+        void startDue(unsigned long now);
+
+        /// @brief Register the earliest cue in the wheel (if attached)
+        void armNext();
+
+        /// @brief Wheel callback: the earliest cue is due
+        static void onWheelExpired(void* context);
+
+        Player& player_;                // player the cues are played on
+        ScoreViewSource presetSource_;  // converts the preset of the last preset cue
+        Cue cues_[Capacity];            // scheduled cues, earliest first
+        uint8_t count_;                 // cues in the list
+        TimerWheel* wheel_;             // wheel starting the cues, nullptr: update()
+        WheelTimer wheelTimer_;         // earliest cue registered in the wheel
+};
+
+/// @brief Cue list of the runtime backend player
+template<uint8_t Capacity>
+using CueList = BasicCueList<Capacity>;
+
+#include "player/CueListImpl.h"
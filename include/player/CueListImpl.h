@@ -0,0 +1,221 @@
+#pragma once
+
+#include <Arduino.h>
+#include "logger/Logger.h"
+
+// Definitions of the BasicCueList template, included at the end of player/CueList.h
+
+/**
+ * @brief Construct a new Cue List
+ *
+ * @param player - player the cues are played on
+ * @param presetCtx - tempo and gap used to play the preset cues
+ */
+template<uint8_t Capacity, class Player>
+BasicCueList<Capacity, Player>::BasicCueList(Player& player, const MelodyContext& presetCtx):
+player_(player),
+presetSource_(score::ScoreView{nullptr, 0}, presetCtx),
+count_(0),
+wheel_(nullptr),
+wheelTimer_(&BasicCueList::onWheelExpired, this)
+{}
+
+/**
+ * @brief Schedule a melody at an absolute time
+ *
+ * @param atUs - micros() time of its first note
+ * @param melody - steps to play
+ * @return true - scheduled
+ * @return false - the list is full
+ */
+template<uint8_t Capacity, class Player>
+bool BasicCueList<Capacity, Player>::playAt(unsigned long atUs, const Melody& melody)
+{
+    Cue cue;
+    cue.atUs = atUs;
+    cue.melody = melody;
+    cue.preset = PresetId::Success;
+    cue.isPreset = false;
+
+    return insert(cue);
+}
+
+/**
+ * @brief Schedule a preset tone at an absolute time
+ *
+ * @param atUs - micros() time of its first note
+ * @param preset - preset to play
+ * @return true - scheduled
+ * @return false - the list is full
+ */
+template<uint8_t Capacity, class Player>
+bool BasicCueList<Capacity, Player>::playAt(unsigned long atUs, PresetId preset)
+{
+    Cue cue;
+    cue.atUs = atUs;
+    cue.melody = Melody{nullptr, 0};
+    cue.preset = preset;
+    cue.isPreset = true;
+
+    return insert(cue);
+}
+
+/**
+ * @brief Start the cues whose time has come
+ *
+ * @details One comparison with the earliest cue when nothing is due. Does nothing when a
+ * wheel is attached: the wheel starts the cues.
+ */
+template<uint8_t Capacity, class Player>
+void BasicCueList<Capacity, Player>::update()
+{
+    if (wheel_ != nullptr || count_ == 0) return;
+
+    unsigned long now = micros();
+    if ((long)(now - cues_[0].atUs) < 0) return;
+
+    startDue(now);
+}
+
+/**
+ * @brief Let a timer wheel start the cues
+ *
+ * @param wheel - wheel polled by the application, nullptr to go back to update()
+ */
+template<uint8_t Capacity, class Player>
+void BasicCueList<Capacity, Player>::attachTimerWheel(TimerWheel* wheel)
+{
+    if (wheel_ != nullptr) wheel_->cancel(wheelTimer_);
+
+    wheel_ = wheel;
+    armNext();
+}
+
+/**
+ * @brief Drop every scheduled cue
+ */
+template<uint8_t Capacity, class Player>
+void BasicCueList<Capacity, Player>::clear()
+{
+    count_ = 0;
+    if (wheel_ != nullptr) wheel_->cancel(wheelTimer_);
+}
+
+/**
+ * @brief Get how many cues are still waiting
+ *
+ * @return uint8_t
+ */
+template<uint8_t Capacity, class Player>
+uint8_t BasicCueList<Capacity, Player>::pending() const
+{
+    return count_;
+}
+
+/**
+ * @brief Set the tempo and gap of the preset cues (from the next preset cue played)
+ *
+ * @param ctx - tempo and articulation gap
+ */
+template<uint8_t Capacity, class Player>
+void BasicCueList<Capacity, Player>::setPresetContext(const MelodyContext& ctx)
+{
+    presetSource_.setContext(ctx);
+}
+
+//////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+/**
+ * @brief Insert a cue keeping the list sorted by time
+ *
+ * @details Times are compared as a signed difference, so the order holds across the micros()
+ * wrap around (cues less than ~35 min apart).
+ *
+ * @param cue - cue to insert
+ * @return false if the list is full
+ */
+template<uint8_t Capacity, class Player>
+bool BasicCueList<Capacity, Player>::insert(const Cue& cue)
+{
+    if (count_ >= Capacity) return false;
+
+    uint8_t pos = count_;
+    while (pos > 0 && (long)(cue.atUs - cues_[pos - 1].atUs) < 0)
+    {
+        cues_[pos] = cues_[pos - 1];
+        --pos;
+    }
+    cues_[pos] = cue;
+    ++count_;
+
+    if (pos == 0) armNext();
+    return true;
+}
+
+/**
+ * @brief Play the due cues
+ *
+ * @details
+ *  1. Pop every cue at or before now. After a stall several can be due: each one is started
+ *     in order and the last one is the one that stays on the player
+ *  2. update() the player right away, so the first note sounds in this same call
+ *  3. Register the next cue in the wheel
+ *
+ * @param now - micros() time of the check
+ */
+template<uint8_t Capacity, class Player>
+void BasicCueList<Capacity, Player>::startDue(unsigned long now)
+{
+    bool started = false;
+
+    // 1. Due cues
+    while (count_ > 0 && (long)(now - cues_[0].atUs) >= 0)
+    {
+        Cue cue = cues_[0];
+        for (uint8_t i = 1; i < count_; ++i) cues_[i - 1] = cues_[i];
+        --count_;
+
+        LOGD("cue late=%ldus", (long)(now - cue.atUs));
+
+        if (cue.isPreset)
+        {
+            presetSource_.reset(presets::getPresetById(cue.preset));
+            player_.play(presetSource_);
+        }
+        else
+        {
+            player_.play(cue.melody);
+        }
+        started = true;
+    }
+
+    // 2. First edge now
+    if (started) player_.update();
+
+    // 3. Next cue
+    armNext();
+}
+
+/**
+ * @brief Register the earliest cue in the wheel
+ */
+template<uint8_t Capacity, class Player>
+void BasicCueList<Capacity, Player>::armNext()
+{
+    if (wheel_ == nullptr) return;
+
+    if (count_ == 0) wheel_->cancel(wheelTimer_);
+    else wheel_->scheduleAtUs(wheelTimer_, cues_[0].atUs);
+}
+
+/**
+ * @brief Wheel callback: the earliest cue is due
+ *
+ * @param context - the cue list
+ */
+template<uint8_t Capacity, class Player>
+void BasicCueList<Capacity, Player>::onWheelExpired(void* context)
+{
+    BasicCueList* self = static_cast<BasicCueList*>(context);
+    self->startDue(micros());
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include "core/Types.h"
+
+/**
+ * @brief Interface for anything the player can pull Steps from
+ * 
+ * @details
+ * A Melody is a fully built array of Steps, but a melody can also be produced one Step at a time:
+ * decoding a compressed score from flash, converting a ScoreView on the fly, reading from EEPROM...
+ * The player only ever asks for the next Step, so it never needs the whole melody in SRAM.
+ * 
+ * @note Implementations must be cheap: next() is called from BuzzerPlayer::update() at every step boundary.
+ */
+class IStepSource
+{
+    public:
+
+    /// @brief Virtual destructor to proper clean up
+    virtual ~IStepSource() = default;
+
+    /// @brief Go back to the first Step of the sequence
+    virtual void rewind() = 0;
+
+    /// @brief Produce the next Step of the sequence
+    /// @param step - output Step
+    /// @return true if a Step was produced, false when the sequence is exhausted
+    virtual bool next(Step& step) = 0;
+
+    /// @brief Go back to the first Step for another pass of a looped playback
+    /// @details Called by the player where a looped melody wraps, instead of rewind(). rewind() must replay the
+    /// same steps (seek() and the time index rely on it), so a source that varies between passes (a shuffled
+    /// playlist) draws its new pass here.
+    /// @return true if the new pass differs from the previous one (the player then re-indexes it)
+    virtual bool nextPass()
+    {
+        rewind();
+        return false;
+    }
+
+    /// @brief Sub-ms part of the Step last returned by next()
+    /// @details Step durations are whole ms. A source timed more finely (e.g. a metronome at 130 BPM: 461538 us
+    /// per beat) reports here the us the player adds to durationMs, so its deadlines do not round to the ms.
+    /// @return us in [0, 999]
+    virtual uint16_t lastStepExtraUs() const { return 0; }
+
+    /// @brief Check if the sequence can be read again: finite, and rewind() replays the same steps
+    /// @details Position queries (totalMs(), remainingMs(), seek()) index the source by rewinding it and reading it
+    /// to the end. The player only does that to a replayable source: for the others (live streams, endless
+    /// generators) the duration is unknown, seek() fails and the source is left untouched.
+    virtual bool isReplayable() const { return true; }
+
+    /// @brief Position the sequence so the next call to next() returns the Step at index
+    /// @details Default implementation rewinds and skips steps, O(index). Random access sources should override it.
+    /// @param index - step index from the start of the sequence
+    /// @return false if the sequence has fewer steps than index
+    virtual bool seek(size_t index)
+    {
+        rewind();
+
+        Step skipped;
+        for (size_t i = 0; i < index; ++i)
+        {
+            if (!next(skipped)) return false;
+        }
+        return true;
+    }
+
+};
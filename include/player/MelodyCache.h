@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+#include "player/MelodyPool.h"
+#include "sources/ScoreViewSource.h"
+#include "presetTones/Presets.h"
+
+/**
+ * @brief LRU cache of built preset melodies, keyed by (preset, tempo, gap)
+ *
+ * @details
+ * Playing a preset normally converts its score again (MelodyBuilder or ScoreViewSource) on
+ * every trigger. get() converts it once into a MelodyPool and returns the same handle on the
+ * next calls with the same preset and MelodyContext: a repeated trigger is a lookup in a few
+ * entries, no conversion.
+ *
+ * The SRAM used is the pool the cache is given (its blocks and slots), so the application
+ * chooses the slice. When the pool is full the least recently used entries are evicted until
+ * the new melody fits. Evicting only drops the cache reference: a PooledMelodySource still
+ * playing the melody keeps it alive until it lets it go.
+ *
+ * hits(), misses() and evictions() tell if the cache is big enough: many evictions with few
+ * hits means the working set does not fit.
+ *
+ * Example usage:
+ *
+ * StaticMelodyPool<12, 4> pool;
+ * MelodyCache<4> cache(pool);
+ * PooledMelodySource source(pool);
+ *
+ * void notify()
+ * {
+ *     if (source.reset(cache.get(PresetId::Notification, ctx))) player.play(source);
+ * }
+ *
+ * @tparam Entries - presets kept at most (the pool needs at least as many slots)
+ */
+template<uint8_t Entries>
+class MelodyCache
+{
+    static_assert(Entries > 0, "MelodyCache needs at least one entry");
+
+    public:
+
+        /// @brief Constructor
+        /// @param pool - where the built melodies are stored
+        explicit MelodyCache(MelodyPool& pool);
+
+        /// @brief Releases the cached melodies
+        ~MelodyCache();
+
+        MelodyCache(const MelodyCache&) = delete;
+        MelodyCache& operator=(const MelodyCache&) = delete;
+
+        /// @brief Built melody of a preset, converted on a miss
+        /// @param preset - preset to play
+        /// @param ctx - tempo and gap it is built with
+        /// @return MelodyHandle - owned by the cache (take a reference to keep it, e.g. PooledMelodySource::reset()), null if it does not fit the pool
+        MelodyHandle get(PresetId preset, const MelodyContext& ctx = MelodyContext());
+
+        /// @brief Release every cached melody
+        void clear();
+
+        /// @brief Presets cached
+        uint8_t size() const;
+
+        /// @brief get() calls answered from the cache
+        uint32_t hits() const;
+
+        /// @brief get() calls that converted the preset
+        uint32_t misses() const;
+
+        /// @brief Entries dropped to make room
+        uint32_t evictions() const;
+
+        /// @brief Clear the counters
+        void resetStats();
+
+    private:
+
+        /// @brief Cached melody and what it was built from
+        struct Entry
+        {
+            uint8_t preset;
+            uint16_t bpm;
+            uint16_t gapMs;
+            MelodyHandle handle;
+        };
+
+        /// @brief Move an entry to the front (most recently used)
+        void touch(uint8_t idx);
+
+        /// @brief Release the least recently used entry
+        void evictLast();
+
+        MelodyPool& pool_;              // where the melodies live
+        ScoreViewSource converter_;     // converts a preset on a miss
+        Entry entries_[Entries];        // most recently used first
+        uint8_t count_;                 // entries in use
+        uint32_t hits_;                 // lookups found
+        uint32_t misses_;               // lookups converted
+        uint32_t evictions_;            // entries dropped for room
+};
+
+#include "player/MelodyCacheImpl.h"
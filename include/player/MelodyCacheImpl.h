@@ -0,0 +1,178 @@
+#pragma once
+
+#include "logger/Logger.h"
+
+// Definitions of the MelodyCache template, included at the end of player/MelodyCache.h
+
+/**
+ * @brief Construct a new Melody Cache
+ *
+ * @param pool - where the built melodies are stored
+ */
+template<uint8_t Entries>
+MelodyCache<Entries>::MelodyCache(MelodyPool& pool):
+pool_(pool),
+converter_(score::ScoreView{nullptr, 0}, MelodyContext()),
+count_(0),
+hits_(0),
+misses_(0),
+evictions_(0)
+{}
+
+/**
+ * @brief Destroy the Melody Cache, releasing its references
+ */
+template<uint8_t Entries>
+MelodyCache<Entries>::~MelodyCache()
+{
+    clear();
+}
+
+/**
+ * @brief Get the built melody of a preset
+ *
+ * @details
+ *  1. Lookup: same preset, tempo and gap -> hit, the entry becomes the most recent
+ *  2. Miss: make room if all the entries are used, then convert the preset into the pool,
+ *     evicting the least recently used entries while it does not fit
+ *  3. Insert the new entry in front
+ *
+ * @param preset - preset to play
+ * @param ctx - tempo and gap it is built with
+ * @return MelodyHandle - owned by the cache, null if it does not fit an empty pool
+ */
+template<uint8_t Entries>
+MelodyHandle MelodyCache<Entries>::get(PresetId preset, const MelodyContext& ctx)
+{
+    const uint8_t id = static_cast<uint8_t>(preset);
+
+    // 1. Lookup
+    for (uint8_t i = 0; i < count_; ++i)
+    {
+        const Entry& entry = entries_[i];
+        if (entry.preset == id && entry.bpm == ctx.bpm && entry.gapMs == ctx.gapMs)
+        {
+            ++hits_;
+            touch(i);
+            return entries_[0].handle;
+        }
+    }
+
+    // 2. Convert
+    ++misses_;
+    if (count_ == Entries) evictLast();
+
+    converter_.setContext(ctx);
+    converter_.reset(presets::getPresetById(preset));
+
+    MelodyHandle handle = pool_.add(converter_);
+    while (handle.isNull() && count_ > 0)
+    {
+        evictLast();
+        handle = pool_.add(converter_);
+    }
+    if (handle.isNull())
+    {
+        LOGI("cache: preset %u does not fit the pool", (unsigned)id);
+        return handle;
+    }
+
+    // 3. Most recent in front
+    for (uint8_t i = count_; i > 0; --i) entries_[i] = entries_[i - 1];
+    entries_[0] = Entry{ id, ctx.bpm, ctx.gapMs, handle };
+    ++count_;
+
+    LOGD("cache miss preset=%u bpm=%u gap=%u", (unsigned)id, (unsigned)ctx.bpm, (unsigned)ctx.gapMs);
+    return handle;
+}
+
+/**
+ * @brief Release every cached melody
+ */
+template<uint8_t Entries>
+void MelodyCache<Entries>::clear()
+{
+    while (count_ > 0) pool_.release(entries_[--count_].handle);
+}
+
+/**
+ * @brief Get the presets cached
+ *
+ * @return uint8_t
+ */
+template<uint8_t Entries>
+uint8_t MelodyCache<Entries>::size() const
+{
+    return count_;
+}
+
+/**
+ * @brief Get the lookups answered from the cache
+ *
+ * @return uint32_t
+ */
+template<uint8_t Entries>
+uint32_t MelodyCache<Entries>::hits() const
+{
+    return hits_;
+}
+
+/**
+ * @brief Get the lookups that converted the preset
+ *
+ * @return uint32_t
+ */
+template<uint8_t Entries>
+uint32_t MelodyCache<Entries>::misses() const
+{
+    return misses_;
+}
+
+/**
+ * @brief Get the entries dropped to make room
+ *
+ * @return uint32_t
+ */
+template<uint8_t Entries>
+uint32_t MelodyCache<Entries>::evictions() const
+{
+    return evictions_;
+}
+
+/**
+ * @brief Clear the counters
+ */
+template<uint8_t Entries>
+void MelodyCache<Entries>::resetStats()
+{
+    hits_ = 0;
+    misses_ = 0;
+    evictions_ = 0;
+}
+
+//////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+/**
+ * @brief Move an entry to the front
+ *
+ * @param idx - entry that was just used
+ */
+template<uint8_t Entries>
+void MelodyCache<Entries>::touch(uint8_t idx)
+{
+    Entry used = entries_[idx];
+    for (uint8_t i = idx; i > 0; --i) entries_[i] = entries_[i - 1];
+    entries_[0] = used;
+}
+
+/**
+ * @brief Release the least recently used entry
+ *
+ * @details Only the cache reference is dropped: a source still playing the melody keeps it.
+ */
+template<uint8_t Entries>
+void MelodyCache<Entries>::evictLast()
+{
+    pool_.release(entries_[--count_].handle);
+    ++evictions_;
+}
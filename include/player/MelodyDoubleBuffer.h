@@ -0,0 +1,64 @@
+#pragma once
+
+#include "builder/MelodyBuilder.h"
+#include "player/BuzzerPlayer.h"
+
+/**
+ * @brief Front/back step buffers to change the music without stopping the player
+ * 
+ * @details
+ * The front buffer is the one being played, the back buffer is where the next melody is built.
+ * publish() hands the back melody to the player, which swaps it in at the requested boundary.
+ * Until the swap actually happens the old front is still playing, so back() is not available
+ * (isBackFree() == false) and the application just tries again on the next loop() pass.
+ * 
+ * Example usage:
+ * 
+ * Step bufferA[32], bufferB[32];
+ * MelodyDoubleBuffer music(player, bufferA, bufferB, 32);
+ * 
+ * if (music.isBackFree())
+ * {
+ *     music.back().clearMelody(true).setTempo(160).appendScore(presets::warning());
+ *     music.publish(SwapPoint::EndOfLoop, true);
+ * }
+ * 
+ * @tparam Player - BasicBuzzerPlayer instantiation the melodies are published to
+ */
+template<class Player = BuzzerPlayer>
+class BasicMelodyDoubleBuffer
+{
+    public:
+
+        /// @brief Constructor
+        /// @param player - player the melodies are published to
+        /// @param bufferA - first step buffer
+        /// @param bufferB - second step buffer
+        /// @param capacity - steps each buffer can hold
+        BasicMelodyDoubleBuffer(Player& player, Step* bufferA, Step* bufferB, size_t capacity);
+
+        /// @brief Check if the back buffer can be (re)built
+        /// @return false while the previously published melody waits for its swap point
+        bool isBackFree() const;
+
+        /// @brief Builder writing into the back buffer
+        /// @note Only use it when isBackFree() is true
+        MelodyBuilder& back();
+
+        /// @brief Hand the back melody to the player and make it the front one
+        /// @param at - boundary where the player swaps it in
+        /// @param loop - Whether to loop the published melody
+        /// @return false if the back buffer was not free or the build overflowed
+        bool publish(SwapPoint at = SwapPoint::EndOfLoop, bool loop = true);
+
+    private:
+
+        Player& player_;                // player the melodies are published to
+        MelodyBuilder builders_[2];     // one builder per buffer
+        uint8_t backIdx_;               // index of the back buffer
+};
+
+/// @brief Double buffer of the runtime backend player
+using MelodyDoubleBuffer = BasicMelodyDoubleBuffer<>;
+
+#include "player/MelodyDoubleBufferImpl.h"
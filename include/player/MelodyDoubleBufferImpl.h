@@ -0,0 +1,65 @@
+#pragma once
+
+// Definitions of the BasicMelodyDoubleBuffer template, included at the end of player/MelodyDoubleBuffer.h
+
+/**
+ * @brief Construct a new Melody Double Buffer
+ * 
+ * @param player - player the melodies are published to
+ * @param bufferA - first step buffer
+ * @param bufferB - second step buffer
+ * @param capacity - steps each buffer can hold
+ */
+template<class Player>
+BasicMelodyDoubleBuffer<Player>::BasicMelodyDoubleBuffer(Player& player, Step* bufferA, Step* bufferB, size_t capacity):
+player_(player),
+builders_{MelodyBuilder(bufferA, capacity), MelodyBuilder(bufferB, capacity)},
+backIdx_(0)
+{}
+
+/**
+ * @brief Check if the back buffer can be (re)built
+ * 
+ * @details The back buffer is the previous front one: it is free once the player swapped
+ * to the last published melody.
+ * 
+ * @return true - back() can be used
+ * @return false - the player still plays from it
+ */
+template<class Player>
+bool BasicMelodyDoubleBuffer<Player>::isBackFree() const
+{
+    return !player_.isSwapPending();
+}
+
+/**
+ * @brief Builder writing into the back buffer
+ * 
+ * @return MelodyBuilder& 
+ */
+template<class Player>
+MelodyBuilder& BasicMelodyDoubleBuffer<Player>::back()
+{
+    return builders_[backIdx_];
+}
+
+/**
+ * @brief Hand the back melody to the player and flip the buffers
+ * 
+ * @param at - boundary where the player swaps it in
+ * @param loop - Whether to loop the published melody
+ * @return true - melody queued
+ * @return false - the back buffer was still in use or the build is not ok
+ */
+template<class Player>
+bool BasicMelodyDoubleBuffer<Player>::publish(SwapPoint at, bool loop)
+{
+    if (!isBackFree() || !builders_[backIdx_].ok()) return false;
+
+    // 1. Build the back melody and queue it
+    player_.queue(builders_[backIdx_].build(), at, loop);
+
+    // 2. Flip: the front buffer becomes the next back buffer
+    backIdx_ ^= 1;
+    return true;
+}
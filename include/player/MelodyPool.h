@@ -0,0 +1,155 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "player/IStepSource.h"
+#include "core/Types.h"
+
+/**
+ * @brief Handle to a melody stored in a MelodyPool
+ *
+ * @details Slot + generation: once the melody is freed its slot gets a new generation, so an old
+ * handle is detected (isValid() false) instead of reading the steps of whatever reused the slot.
+ */
+struct MelodyHandle
+{
+    uint8_t slot;
+    uint8_t generation;
+
+    static constexpr uint8_t INVALID_SLOT = 0xFF;
+
+    bool isNull() const { return slot == INVALID_SLOT; }
+};
+
+/**
+ * @brief Shared, immutable melodies in a fixed arena, referenced by handles
+ *
+ * @details
+ * A melody is copied into the pool once (add()) and is read only from then on. Players, cue
+ * lists or queued requests play it through a PooledMelodySource, which holds a reference: any
+ * number of them share the same steps without copies, and the caller can drop its own Melody
+ * buffer right after add().
+ *
+ * Memory is reclaimed deterministically: each handle counts its references (add() returns the
+ * first one), and the steps are freed in the release() that drops the last one. Nothing is
+ * freed while a source still plays it.
+ *
+ * The arena is made of fixed size blocks of BLOCK_STEPS steps chained per melody, so freeing a
+ * melody never fragments the arena: any free block fits any melody. Allocation and release
+ * are O(blocks of the melody), no heap.
+ *
+ * The storage is provided by the derived StaticMelodyPool (or by the application).
+ *
+ * Example usage:
+ *
+ * StaticMelodyPool<16, 4> pool;                   // 16 * 8 steps, 4 melodies
+ * MelodyHandle alarm = pool.add(builder.clearMelody().appendScore(...).build());
+ * PooledMelodySource a(pool), b(pool);
+ * a.reset(alarm); playerA.play(a);                 // both players share the steps
+ * b.reset(alarm); playerB.play(b);
+ * pool.release(alarm);                             // freed when a and b let it go
+ */
+class MelodyPool
+{
+    public:
+
+        static constexpr uint8_t BLOCK_STEPS = 8;          // steps per arena block
+        static constexpr uint8_t END_OF_CHAIN = 0xFF;      // no next block
+
+        /// @brief Bookkeeping of one melody
+        struct Slot
+        {
+            uint16_t count;         // steps of the melody
+            uint8_t firstBlock;     // first block of its chain
+            uint8_t refs;           // references held, 0 = free slot
+            uint8_t generation;     // bumped when the slot is freed
+        };
+
+        /// @brief Constructor over application storage
+        /// @param blocks - arena, blockCount * BLOCK_STEPS steps
+        /// @param links - next block of each block, blockCount entries
+        /// @param blockCount - blocks in the arena (at most 255)
+        /// @param slots - melody table
+        /// @param slotCount - melodies the pool can hold (at most 255)
+        MelodyPool(Step* blocks, uint8_t* links, uint8_t blockCount, Slot* slots, uint8_t slotCount);
+
+        /// @brief Copy a built melody into the pool
+        /// @param melody - steps to copy. The original buffer is not referenced afterwards
+        /// @return MelodyHandle - holding one reference, null if the pool is full
+        MelodyHandle add(const Melody& melody);
+
+        /// @brief Copy the steps produced by a source into the pool (e.g. a preset converted on the fly)
+        /// @param source - finite source, rewound and read to the end
+        /// @return MelodyHandle - holding one reference, null if the pool is full
+        MelodyHandle add(IStepSource& source);
+
+        /// @brief Take one more reference to a melody
+        /// @return false if the handle is stale or the reference count is saturated
+        bool acquire(MelodyHandle handle);
+
+        /// @brief Drop a reference. The last one frees the melody
+        void release(MelodyHandle handle);
+
+        /// @brief Check if the handle still refers to its melody
+        bool isValid(MelodyHandle handle) const;
+
+        /// @brief Steps of a melody (0 if the handle is stale)
+        uint16_t stepCount(MelodyHandle handle) const;
+
+        /// @brief References held on a melody (0 if the handle is stale)
+        uint8_t refCount(MelodyHandle handle) const;
+
+        /// @brief Blocks not used by any melody
+        uint8_t freeBlocks() const;
+
+        // --- Read access for PooledMelodySource ---
+
+        /// @brief First block of a melody (END_OF_CHAIN if the handle is stale)
+        uint8_t firstBlock(MelodyHandle handle) const;
+
+        /// @brief Block following a block of a chain
+        uint8_t nextBlock(uint8_t block) const;
+
+        /// @brief Steps of a block
+        const Step* blockSteps(uint8_t block) const;
+
+    private:
+
+        /// @brief Reserve a free slot and enough blocks for count steps
+        /// @return slot index, END_OF_CHAIN if there is not enough room (nothing reserved)
+        uint8_t allocate(uint16_t count);
+
+        /// @brief Give a chain of blocks back to the free list
+        void freeChain(uint8_t block);
+
+        Step* blocks_;              // arena, BLOCK_STEPS steps per block
+        uint8_t* links_;            // next block of each block (chains and free list)
+        uint8_t blockCount_;        // blocks in the arena
+        Slot* slots_;               // melody table
+        uint8_t slotCount_;         // entries of the table
+        uint8_t freeHead_;          // first free block
+        uint8_t freeBlocks_;        // blocks in the free list
+};
+
+/**
+ * @brief MelodyPool with its storage inside
+ *
+ * @tparam Blocks - arena blocks (BLOCK_STEPS steps each), at most 255
+ * @tparam Slots - melodies the pool can hold, at most 255
+ */
+template<uint8_t Blocks, uint8_t Slots>
+class StaticMelodyPool : public MelodyPool
+{
+    static_assert(Blocks > 0 && Blocks < MelodyPool::END_OF_CHAIN, "StaticMelodyPool needs 1..254 blocks");
+    static_assert(Slots > 0 && Slots < MelodyHandle::INVALID_SLOT, "StaticMelodyPool needs 1..254 slots");
+
+    public:
+
+        StaticMelodyPool() : MelodyPool(storage_, links_, Blocks, table_, Slots) {}
+
+    private:
+
+        Step storage_[Blocks * MelodyPool::BLOCK_STEPS];
+        uint8_t links_[Blocks];
+        MelodyPool::Slot table_[Slots];
+};
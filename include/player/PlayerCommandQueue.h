@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+#include "player/BuzzerPlayer.h"
+#include "core/SpscRing.h"
+
+/**
+ * @brief Command posted to a player from another context
+ */
+struct PlayerCommand
+{
+    enum class Type : uint8_t
+    {
+        PlayMelody,     // melody, loop
+        PlaySource,     // source, loop
+        Stop,
+        Pause,
+        Resume,
+        Rate,           // rateQ8
+        Transpose       // semitones
+    };
+
+    Type type;
+    bool loop;
+    union
+    {
+        Melody melody;
+        IStepSource* source;
+        uint16_t rateQ8;
+        int8_t semitones;
+    };
+};
+
+/**
+ * @brief Wait-free command queue in front of a player, to control it from ISRs or other threads
+ *
+ * @details
+ * The player itself is not reentrant: play() from an ISR (or from another thread on host builds)
+ * while update() runs would change the source, the step index and the FSM state under its feet.
+ * Instead, the producer posts commands here (play, stop, pause, resume, tempo, transpose): each
+ * post is a copy into a SpscRing slot and one index store, it never blocks and never masks
+ * interrupts. update() runs in the main context: it applies the waiting commands in order, then
+ * updates the player, so a command takes effect at most one loop() period after it was posted.
+ *
+ * Single producer: all the posts must come from one context. On AVR, ISRs do not nest, so every
+ * ISR counts as the same producer, but the main context must then call the player directly, not
+ * post. A post on a full queue fails and is counted (rejected()).
+ *
+ * Example usage:
+ *
+ * PlayerCommandQueue<8> commands(player);
+ * void onButton() { commands.play(alarm); }
+ * void loop()     { commands.update(); }
+ *
+ * @tparam Capacity - commands that can wait, a power of two <= 128
+ * @tparam Player - BasicBuzzerPlayer instantiation controlled by the queue
+ */
+template<uint8_t Capacity, class Player = BuzzerPlayer>
+class BasicPlayerCommandQueue
+{
+    public:
+
+        /// @brief Constructor
+        /// @param player - player the commands are applied to (main context only)
+        explicit BasicPlayerCommandQueue(Player& player);
+
+        // --- Producer side (ISR / other thread). Each returns false if the queue is full ---
+
+        /// @brief Post Player::play(melody, loop)
+        /// @param melody - steps to play. They must stay untouched until it stopped playing
+        bool play(const Melody& melody, bool loop = false);
+
+        /// @brief Post Player::play(source, loop)
+        /// @param source - step source. Must outlive the playback
+        bool play(IStepSource& source, bool loop = false);
+
+        /// @brief Post Player::stop()
+        bool stop();
+
+        /// @brief Post Player::pause()
+        bool pause();
+
+        /// @brief Post Player::resume()
+        bool resume();
+
+        /// @brief Post Player::setPlaybackRate()
+        /// @param rateQ8 - q8.8 tempo multiplier
+        bool setPlaybackRate(uint16_t rateQ8);
+
+        /// @brief Post Player::setTranspose()
+        /// @param semitones - pitch shift
+        bool setTranspose(int8_t semitones);
+
+        // --- Consumer side (main context) ---
+
+        /// @brief Apply the waiting commands, then update the player. Call it every loop() instead of player.update()
+        void update();
+
+        /// @brief Apply the waiting commands without updating the player
+        /// @return uint8_t - commands applied
+        uint8_t drain();
+
+        /// @brief Commands waiting
+        uint8_t pending() const;
+
+        /// @brief Posts lost because the queue was full (saturates at 255)
+        uint8_t rejected() const;
+
+    private:
+
+        /// @brief Apply one command to the player
+        void apply(const PlayerCommand& command);
+
+        /// @brief Post a command without payload
+        bool post(PlayerCommand::Type type);
+
+        Player& player_;                                // player the commands are applied to
+        SpscRing<PlayerCommand, Capacity> ring_;        // posted commands, oldest first
+};
+
+/// @brief Command queue of the runtime backend player
+template<uint8_t Capacity>
+using PlayerCommandQueue = BasicPlayerCommandQueue<Capacity>;
+
+#include "player/PlayerCommandQueueImpl.h"
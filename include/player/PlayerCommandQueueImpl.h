@@ -0,0 +1,197 @@
+#pragma once
+
+#include "logger/Logger.h"
+
+// Definitions of the BasicPlayerCommandQueue template, included at the end of player/PlayerCommandQueue.h
+
+/**
+ * @brief Construct a new Player Command Queue
+ *
+ * @param player - player the commands are applied to
+ */
+template<uint8_t Capacity, class Player>
+BasicPlayerCommandQueue<Capacity, Player>::BasicPlayerCommandQueue(Player& player):
+player_(player),
+ring_()
+{}
+
+/**
+ * @brief Post a melody to play
+ *
+ * @param melody - steps to play (the view is copied, not the steps)
+ * @param loop - Whether to loop the melody
+ * @return false - queue full, the command is lost
+ */
+template<uint8_t Capacity, class Player>
+bool BasicPlayerCommandQueue<Capacity, Player>::play(const Melody& melody, bool loop)
+{
+    PlayerCommand command;
+    command.type = PlayerCommand::Type::PlayMelody;
+    command.loop = loop;
+    command.melody = melody;
+    return ring_.push(command);
+}
+
+/**
+ * @brief Post a step source to play
+ *
+ * @param source - step source
+ * @param loop - Whether to rewind the source and start again after it finishes
+ * @return false - queue full, the command is lost
+ */
+template<uint8_t Capacity, class Player>
+bool BasicPlayerCommandQueue<Capacity, Player>::play(IStepSource& source, bool loop)
+{
+    PlayerCommand command;
+    command.type = PlayerCommand::Type::PlaySource;
+    command.loop = loop;
+    command.source = &source;
+    return ring_.push(command);
+}
+
+template<uint8_t Capacity, class Player>
+bool BasicPlayerCommandQueue<Capacity, Player>::stop()
+{
+    return post(PlayerCommand::Type::Stop);
+}
+
+template<uint8_t Capacity, class Player>
+bool BasicPlayerCommandQueue<Capacity, Player>::pause()
+{
+    return post(PlayerCommand::Type::Pause);
+}
+
+template<uint8_t Capacity, class Player>
+bool BasicPlayerCommandQueue<Capacity, Player>::resume()
+{
+    return post(PlayerCommand::Type::Resume);
+}
+
+/**
+ * @brief Post a tempo change
+ *
+ * @param rateQ8 - q8.8 tempo multiplier
+ * @return false - queue full, the command is lost
+ */
+template<uint8_t Capacity, class Player>
+bool BasicPlayerCommandQueue<Capacity, Player>::setPlaybackRate(uint16_t rateQ8)
+{
+    PlayerCommand command;
+    command.type = PlayerCommand::Type::Rate;
+    command.loop = false;
+    command.rateQ8 = rateQ8;
+    return ring_.push(command);
+}
+
+/**
+ * @brief Post a pitch shift
+ *
+ * @param semitones - interval, negative to go down
+ * @return false - queue full, the command is lost
+ */
+template<uint8_t Capacity, class Player>
+bool BasicPlayerCommandQueue<Capacity, Player>::setTranspose(int8_t semitones)
+{
+    PlayerCommand command;
+    command.type = PlayerCommand::Type::Transpose;
+    command.loop = false;
+    command.semitones = semitones;
+    return ring_.push(command);
+}
+
+/**
+ * @brief Apply the waiting commands, then update the player
+ *
+ * @details The commands go first, so a play() posted since the last pass starts sounding in
+ * this same call.
+ */
+template<uint8_t Capacity, class Player>
+void BasicPlayerCommandQueue<Capacity, Player>::update()
+{
+    drain();
+    player_.update();
+}
+
+/**
+ * @brief Apply the waiting commands
+ *
+ * @details At most Capacity commands per call: a producer posting faster than the loop runs
+ * cannot keep the main context in here.
+ *
+ * @return uint8_t - commands applied
+ */
+template<uint8_t Capacity, class Player>
+uint8_t BasicPlayerCommandQueue<Capacity, Player>::drain()
+{
+    PlayerCommand command;
+    uint8_t applied = 0;
+
+    while (applied < Capacity && ring_.pop(command))
+    {
+        apply(command);
+        ++applied;
+    }
+    return applied;
+}
+
+/**
+ * @brief Get the commands waiting
+ *
+ * @return uint8_t
+ */
+template<uint8_t Capacity, class Player>
+uint8_t BasicPlayerCommandQueue<Capacity, Player>::pending() const
+{
+    return ring_.size();
+}
+
+/**
+ * @brief Get the posts lost because the queue was full
+ *
+ * @return uint8_t - saturates at 255
+ */
+template<uint8_t Capacity, class Player>
+uint8_t BasicPlayerCommandQueue<Capacity, Player>::rejected() const
+{
+    return ring_.rejected();
+}
+
+//////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+/**
+ * @brief Apply one command to the player
+ *
+ * @param command - command taken from the ring
+ */
+template<uint8_t Capacity, class Player>
+void BasicPlayerCommandQueue<Capacity, Player>::apply(const PlayerCommand& command)
+{
+    LOGD("command type=%u", (unsigned)command.type);
+
+    switch (command.type)
+    {
+        case PlayerCommand::Type::PlayMelody:   player_.play(command.melody, command.loop); break;
+        case PlayerCommand::Type::PlaySource:   player_.play(*command.source, command.loop); break;
+        case PlayerCommand::Type::Stop:         player_.stop(); break;
+        case PlayerCommand::Type::Pause:        player_.pause(); break;
+        case PlayerCommand::Type::Resume:       player_.resume(); break;
+        case PlayerCommand::Type::Rate:         player_.setPlaybackRate(command.rateQ8); break;
+        case PlayerCommand::Type::Transpose:    player_.setTranspose(command.semitones); break;
+    }
+}
+
+/**
+ * @brief Post a command without payload
+ *
+ * @param type - Stop, Pause or Resume
+ * @return false - queue full, the command is lost
+ */
+template<uint8_t Capacity, class Player>
+bool BasicPlayerCommandQueue<Capacity, Player>::post(PlayerCommand::Type type)
+{
+    PlayerCommand command;
+    command.type = type;
+    command.loop = false;
+    command.source = nullptr;
+    return ring_.push(command);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Default hooks policy of BasicBuzzerPlayer: every event does nothing
+ * 
+ * @details
+ * The player calls its hooks policy directly (no virtual call, no function pointer), so these
+ * empty inline functions compile to nothing and the default BuzzerPlayer pays no cost for them.
+ * 
+ * To sync LEDs, haptics or animations with the melody, derive from NoPlayerHooks and hide
+ * only the events you need. The player inherits the policy, so an empty one takes no RAM.
+ * 
+ * Example usage:
+ * 
+ * struct LedHooks : NoPlayerHooks
+ * {
+ *     void onStepStart(size_t stepIdx, uint16_t freqHz) { digitalWrite(LED_BUILTIN, freqHz > 0); }
+ *     void onFinish() { digitalWrite(LED_BUILTIN, LOW); }
+ * };
+ * 
+ * BasicBuzzerPlayer<IBuzzerBackend, LedHooks> player(hwBackend);
+ * 
+ * @note Hooks run inside update(): keep them short, they delay the next step boundary.
+ */
+struct NoPlayerHooks
+{
+    /// @brief A step starts sounding (freqHz == 0 for a rest). Alert steps are reported too
+    /// @param stepIdx - index of the step in the melody being played
+    /// @param freqHz - step frequency as in the melody(before transpose)
+    void onStepStart(size_t stepIdx, uint16_t freqHz) { (void)stepIdx; (void)freqHz; }
+
+    /// @brief A step played its whole duration (not reported for steps cut by stop())
+    /// @param stepIdx - index of the step in the melody being played
+    /// @param freqHz - step frequency as in the melody(before transpose)
+    void onStepEnd(size_t stepIdx, uint16_t freqHz) { (void)stepIdx; (void)freqHz; }
+
+    /// @brief The melody or its loop section wraps around
+    /// @param firstStepIdx - index of the step the playback jumps back to
+    void onLoop(size_t firstStepIdx) { (void)firstStepIdx; }
+
+    /// @brief The playback ended by itself (not reported for stop())
+    void onFinish() {}
+};
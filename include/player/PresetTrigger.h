@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+#include "player/BuzzerPlayer.h"
+#include "sources/ScoreViewSource.h"
+#include "presetTones/Presets.h"
+#include "Timer/TimerWheel.h"
+
+/**
+ * @brief Start a preset tone from an interrupt (e.g. a button press) with a bounded latency
+ *
+ * @details
+ * fire() is the only call allowed from an ISR: it stores the preset and the micros() time and
+ * returns (a few us). The main context starts it with service(), from update() or from every
+ * tick of a TimerWheel: the preset plays through interrupt() (the melody resumes after it) and
+ * the player is updated in the same call, so the first edge comes out right away. The preset
+ * is converted while it plays (ScoreViewSource), nothing is built at trigger time.
+ *
+ * Latency from fire() to the first edge = wait until the next service() (at most one loop()
+ * period, or one wheel tick + the poll period) + the service() work itself. lastLatencyUs()
+ * and maxLatencyUs() measure it on the target. Triggers fired before the previous one was
+ * serviced are merged (the last preset wins): a burst of presses gives one click.
+ *
+ * Example usage:
+ *
+ * PresetTrigger click(player);
+ * void onButton() { click.fire(PresetId::ButtonClick); }
+ *
+ * void setup() { attachInterrupt(digitalPinToInterrupt(2), onButton, FALLING); }
+ * void loop()  { click.service(); player.update(); }
+ *
+ * @tparam Player - BasicBuzzerPlayer instantiation the presets are played on
+ */
+template<class Player = BuzzerPlayer>
+class BasicPresetTrigger
+{
+    public:
+
+        /// @brief Constructor
+        /// @param player - player the presets are played on
+        /// @param ctx - tempo and gap of the presets
+        BasicPresetTrigger(Player& player, const MelodyContext& ctx = MelodyContext());
+
+        /// @brief Request a preset (ISR safe)
+        /// @param preset - preset to play
+        void fire(PresetId preset);
+
+        /// @brief Start the requested preset, if any. Main context only
+        /// @return true if a preset was started
+        bool service();
+
+        /// @brief Let a timer wheel call service() on every tick
+        /// @param wheel - wheel polled by the application, nullptr to stop
+        void attachTimerWheel(TimerWheel* wheel);
+
+        /// @brief Time from the last fire() to the first edge of its preset in us
+        unsigned long lastLatencyUs() const;
+
+        /// @brief Worst latency seen since the start (or resetLatency())
+        unsigned long maxLatencyUs() const;
+
+        /// @brief Forget the latency measurements
+        void resetLatency();
+
+    private:
+
+        /// @brief Wheel callback: service() and arm the next tick
+        static void onWheelTick(void* context);
+
+        Player& player_;                    // player the presets are played on
+        ScoreViewSource source_;            // converts the preset while it plays
+
+        volatile bool pending_;             // fire() not serviced yet
+        volatile uint8_t preset_;           // PresetId of the pending request
+        volatile unsigned long firedUs_;    // micros() in fire()
+
+        TimerWheel* wheel_;                 // wheel calling service(), nullptr: application calls it
+        WheelTimer wheelTimer_;             // periodic tick in the wheel
+
+        unsigned long lastLatencyUs_;       // last fire() -> first edge
+        unsigned long maxLatencyUs_;        // worst of them
+};
+
+/// @brief Preset trigger of the runtime backend player
+using PresetTrigger = BasicPresetTrigger<>;
+
+#include "player/PresetTriggerImpl.h"
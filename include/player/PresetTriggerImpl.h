@@ -0,0 +1,141 @@
+#pragma once
+
+#include <Arduino.h>
+#include "logger/Logger.h"
+
+// Definitions of the BasicPresetTrigger template, included at the end of player/PresetTrigger.h
+
+/**
+ * @brief Construct a new Preset Trigger
+ *
+ * @param player - player the presets are played on
+ * @param ctx - tempo and gap of the presets
+ */
+template<class Player>
+BasicPresetTrigger<Player>::BasicPresetTrigger(Player& player, const MelodyContext& ctx):
+player_(player),
+source_(score::ScoreView{nullptr, 0}, ctx),
+pending_(false),
+preset_(0),
+firedUs_(0),
+wheel_(nullptr),
+wheelTimer_(&BasicPresetTrigger::onWheelTick, this),
+lastLatencyUs_(0),
+maxLatencyUs_(0)
+{}
+
+/**
+ * @brief Request a preset
+ *
+ * @details Called from an ISR: interrupts are off, so the three fields are written together.
+ * pending_ is written last, service() only reads the others once it is set.
+ *
+ * @param preset - preset to play
+ */
+template<class Player>
+void BasicPresetTrigger<Player>::fire(PresetId preset)
+{
+    preset_ = static_cast<uint8_t>(preset);
+    firedUs_ = micros();
+    pending_ = true;
+}
+
+/**
+ * @brief Start the requested preset
+ *
+ * @details
+ *  1. Nothing pending: one byte read, no interrupt masking
+ *  2. Take the request with interrupts off (the timestamp is 4 bytes on AVR)
+ *  3. Play it over the current melody and update() the player, so the first edge comes out now
+ *  4. Measure the latency from fire()
+ *
+ * @return true - a preset was started
+ * @return false - nothing was requested
+ */
+template<class Player>
+bool BasicPresetTrigger<Player>::service()
+{
+    // 1. Fast path
+    if (!pending_) return false;
+
+    // 2. Take the request
+    noInterrupts();
+    PresetId preset = static_cast<PresetId>(preset_);
+    unsigned long firedUs = firedUs_;
+    pending_ = false;
+    interrupts();
+
+    // 3. First edge
+    source_.reset(presets::getPresetById(preset));
+    player_.interrupt(source_);
+    player_.update();
+
+    // 4. Latency
+    lastLatencyUs_ = micros() - firedUs;
+    if (lastLatencyUs_ > maxLatencyUs_) maxLatencyUs_ = lastLatencyUs_;
+
+    LOGD("trigger preset=%u latency=%luus", (unsigned)preset, lastLatencyUs_);
+    return true;
+}
+
+/**
+ * @brief Let a timer wheel call service() on every tick
+ *
+ * @param wheel - wheel polled by the application, nullptr to stop
+ */
+template<class Player>
+void BasicPresetTrigger<Player>::attachTimerWheel(TimerWheel* wheel)
+{
+    if (wheel_ != nullptr) wheel_->cancel(wheelTimer_);
+
+    wheel_ = wheel;
+    if (wheel_ != nullptr) wheel_->schedule(wheelTimer_, 0);
+}
+
+/**
+ * @brief Get the time from the last fire() to the first edge of its preset
+ *
+ * @return unsigned long - us
+ */
+template<class Player>
+unsigned long BasicPresetTrigger<Player>::lastLatencyUs() const
+{
+    return lastLatencyUs_;
+}
+
+/**
+ * @brief Get the worst latency measured
+ *
+ * @return unsigned long - us
+ */
+template<class Player>
+unsigned long BasicPresetTrigger<Player>::maxLatencyUs() const
+{
+    return maxLatencyUs_;
+}
+
+/**
+ * @brief Forget the latency measurements
+ */
+template<class Player>
+void BasicPresetTrigger<Player>::resetLatency()
+{
+    lastLatencyUs_ = 0;
+    maxLatencyUs_ = 0;
+}
+
+//////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+/**
+ * @brief Wheel callback: service the trigger and come back on the next tick
+ *
+ * @param context - the trigger
+ */
+template<class Player>
+void BasicPresetTrigger<Player>::onWheelTick(void* context)
+{
+    BasicPresetTrigger* self = static_cast<BasicPresetTrigger*>(context);
+
+    self->service();
+    self->wheel_->schedule(self->wheelTimer_, 1);
+}
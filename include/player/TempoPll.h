@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Fixed point software PLL that follows an external tempo pulse
+ *
+ * @details
+ * Fed with the timestamps of a pulse (tap button, 24 PPQN sync clock, beat messages from a
+ * host), it predicts when the next pulse is due and corrects the prediction with the phase error
+ * e = pulse - prediction (second order loop, gains as shifts, no division per pulse):
+ *
+ *      period += e >> freqShift        (tempo)
+ *      next   += period + (e >> phaseShift)   (phase)
+ *
+ * Defaults (phaseShift 2, freqShift 6) give a critically damped loop: it locks in a handful of
+ * pulses and averages the input jitter instead of following it. Missed pulses are counted from
+ * the interval (k periods = k - 1 missed), a pulse less than half a period after the previous one
+ * is dropped as a glitch, and a tempo jump (error over a quarter period twice in a row) restarts
+ * the period from the measured interval instead of slipping cycles.
+ *
+ * playbackRateFor() turns the estimate into a BuzzerPlayer playback rate: the tempo ratio plus
+ * a small bounded trim (MAX_TRIM_Q8) that pulls the melody beat onto the pulse beat, so the
+ * correction is a gradual speed change, never a jump.
+ *
+ * Example usage (tap tempo):
+ *
+ * TempoPll pll(1);
+ * void loop()
+ * {
+ *     if (tapPressed()) pll.pulse(micros());
+ *     if (pll.isLocked(micros())) player.setPlaybackRate(pll.playbackRateFor(120, player.elapsedMs(), micros()));
+ *     player.update();
+ * }
+ *
+ * @note Timestamps are micros() values; call pulse() from the main context (an ISR can store
+ * the timestamp and let the loop call pulse()).
+ */
+class TempoPll
+{
+    public:
+
+        static constexpr uint8_t LOCK_PULSES = 4;          // consecutive pulses inside the lock window to lock
+        static constexpr uint8_t LOCK_WINDOW_SHIFT = 3;    // lock window = period / 8
+        static constexpr uint8_t TIMEOUT_PERIODS = 4;      // no pulse for this many periods: unlocked
+        static constexpr uint16_t MAX_TRIM_Q8 = 16;        // phase trim of the playback rate, at most 1/16 (6 %)
+
+        /// @brief Constructor
+        /// @param pulsesPerBeat - 1 for taps or beat messages, 24 for a MIDI style clock
+        /// @param phaseShift - phase gain 1 / 2^phaseShift
+        /// @param freqShift - tempo gain 1 / 2^freqShift
+        explicit TempoPll(uint8_t pulsesPerBeat = 1, uint8_t phaseShift = 2, uint8_t freqShift = 6);
+
+        /// @brief Forget the estimate (next pulse starts a new acquisition)
+        void reset();
+
+        /// @brief Feed one pulse
+        /// @param atUs - micros() time of the pulse
+        void pulse(unsigned long atUs);
+
+        /// @brief Make the next pulse a beat (e.g. a "start" message of the sync source)
+        void alignBeat();
+
+        /// @brief Check if the loop follows the pulse (and pulses keep coming)
+        /// @param nowUs - micros()
+        bool isLocked(unsigned long nowUs) const;
+
+        /// @brief Estimated beat length in us (0 before two pulses)
+        uint32_t beatUs() const;
+
+        /// @brief Estimated tempo in BPM, q8.8 (0 before two pulses)
+        uint32_t bpmQ8() const;
+
+        /// @brief Phase error of the last pulse against the prediction in us
+        int32_t lastErrorUs() const;
+
+        /// @brief Position in the current beat of the pulse, 0..65535 for one beat
+        /// @param nowUs - micros()
+        uint16_t beatPhaseQ16(unsigned long nowUs) const;
+
+        /// @brief Playback rate that makes a melody follow the pulse
+        /// @param melodyBpm - tempo the melody was built with (its beats are quarter notes from position 0)
+        /// @param melodyPosMs - current position of the melody (BuzzerPlayer::elapsedMs())
+        /// @param nowUs - micros()
+        /// @return uint16_t - q8.8 rate for BuzzerPlayer::setPlaybackRate()
+        uint16_t playbackRateFor(uint16_t melodyBpm, uint32_t melodyPosMs, unsigned long nowUs) const;
+
+    private:
+
+        uint8_t pulsesPerBeat_;         // pulses in one beat
+        uint8_t phaseShift_;            // phase gain shift
+        uint8_t freqShift_;             // tempo gain shift
+
+        uint8_t pulseCount_;            // pulses seen since reset (saturates at 2)
+        uint8_t inWindow_;              // consecutive pulses inside the lock window
+        bool locked_;                   // lock reached
+
+        uint32_t periodQ8_;             // pulse period, us q24.8
+        unsigned long lastPulseUs_;     // time of the last pulse
+        unsigned long nextUs_;          // predicted time of the next pulse
+        unsigned long beatUs0_;         // predicted time of the last beat
+        uint8_t pulseInBeat_;           // index of the next pulse in its beat (0 = beat)
+        int32_t lastErrorUs_;           // e of the last pulse
+        uint8_t slips_;                 // consecutive pulses off by more than a quarter period
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "player/IStepSource.h"
+
+/**
+ * @brief Prefix sum index over the step durations of a melody
+ * 
+ * @details
+ * endTimes[i] = durationMs of steps 0..i, so the total duration is the last entry and the
+ * step playing at any time is found with a binary search: O(log n) seek and position queries.
+ * 
+ * The storage is provided by the application (4 bytes per step). When the melody has more steps
+ * than the storage holds, the index still records the total duration and step count from the
+ * same pass, and seeks fall back to a linear scan of the source.
+ * 
+ * @note The index is built by rewinding and reading the source once, so the source must produce
+ * the same steps after every rewind(). A source that changes between passes of a loop (a shuffled
+ * PlaylistSource) says so from nextPass() and the player rebuilds the index.
+ * 
+ * Example usage:
+ * 
+ * uint32_t endTimes[config::MAX_BUFFER_MELODY_STEP_SIZE];
+ * TimeIndex index(endTimes, config::MAX_BUFFER_MELODY_STEP_SIZE);
+ * player.attachTimeIndex(index);
+ */
+class TimeIndex
+{
+    public:
+
+        static constexpr size_t MAX_SCAN_STEPS = 0xFFFF;   // sources longer than this (or endless) have an unknown duration
+
+        /// @brief Constructor
+        /// @param endTimes - storage for the prefix sums (nullptr: total duration only)
+        /// @param capacity - entries endTimes can hold
+        TimeIndex(uint32_t* endTimes, size_t capacity);
+
+        /// @brief Forget the indexed melody (it will be rebuilt on the next query)
+        void invalidate();
+
+        /// @brief Check if the index describes the current melody
+        bool isValid() const;
+
+        /// @brief Read the whole source once and fill the index
+        /// @param source - steps to index. Its position is lost (rewound and read to the end)
+        void build(IStepSource& source);
+
+        /// @brief Check if the prefix sums are usable (the melody fit the storage)
+        bool hasPrefix() const;
+
+        /// @brief Check if the source ended during the scan (finite, known duration)
+        bool isComplete() const;
+
+        /// @brief Total duration of the melody in ms (0 if unknown)
+        uint32_t totalMs() const;
+
+        /// @brief Number of steps of the melody
+        size_t stepCount() const;
+
+        /// @brief Step that is playing at a time position (requires hasPrefix())
+        /// @param ms - position from the start of the melody
+        /// @return step index, stepCount() if ms is past the end
+        size_t stepAt(uint32_t ms) const;
+
+        /// @brief Start time of a step (requires hasPrefix())
+        /// @param idx - step index
+        uint32_t stepStartMs(size_t idx) const;
+
+    private:
+
+        uint32_t* endTimes_;        // prefix sums storage (not owned)
+        size_t capacity_;           // entries endTimes_ can hold
+        size_t count_;              // steps of the indexed melody
+        uint32_t totalMs_;          // duration of the indexed melody
+        bool valid_;                // the index describes the current melody
+        bool complete_;             // the scan reached the end of the source
+};
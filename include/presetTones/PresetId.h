@@ -1,5 +1,24 @@
 #pragma once
 
+#include <stdint.h>
+
+/**
+ * @brief The preset list: X(id, name, score array), one line per preset
+ * 
+ * @details The only place a preset is declared. The PresetId enum below, presets::REGISTRY
+ * (Presets.h) and the flash table of names (Presets.cpp) are all expanded from it, so an id, its
+ * name and its score cannot drift apart. Adding a preset: its score array in Presets.h and its
+ * line here. The name is what findPresetByName() matches (lower case, unique).
+ */
+#define PRESET_LIST(X) \
+    X(Success,      "success",      TONE_SUCCESS)       \
+    X(Error,        "error",        TONE_ERROR)         \
+    X(Notification, "notification", TONE_NOTIFICATION)  \
+    X(Warning,      "warning",      TONE_WARNING)       \
+    X(Startup,      "startup",      TONE_STARTUP)       \
+    X(Shutdown,     "shutdown",     TONE_SHUTDOWN)      \
+    X(ButtonClick,  "click",        TONE_BUTTON_CLICK)
+
 /**
  * @brief Preset tone identifiers
  * 
@@ -7,4 +26,10 @@
  * These identifiers can be used to select and play specific preset tones in the application.
  * 
  */
-enum class PresetId {Success, Error, Notification, Warning, Startup, Shutdown, ButtonClick};
\ No newline at end of file
+enum class PresetId : uint8_t {
+#define PRESET_ID(id, name, tone) id,
+    PRESET_LIST(PRESET_ID)
+#undef PRESET_ID
+
+    Count   // number of presets (not a preset): keep it last
+};
@@ -1,5 +1,6 @@
 #pragma     once
-#include <Arduino.h>
+#include <stdint.h>
+#include <stddef.h>
 
 #include "../music/Notes.h"
 #include "../music/Durations.h"
@@ -121,26 +122,88 @@
 
 
 
+    // ===  REGISTRY: ONE ENTRY PER PresetId, IN ENUM ORDER ===
+    //  Expanded from PRESET_LIST (PresetId.h), like the enum: nothing to keep in sync by hand.
+    //
+    //  This table is for the compiler only (compile time ids): being in a header, a runtime read
+    //  of it would give every file its own copy in SRAM. Runtime lookups and names go through the
+    //  single flash table of Presets.cpp.
+
+    /**
+     * @brief Registry entry of a preset tone
+     */
+    struct PresetEntry
+    {
+        PresetId id;                    // index of the entry
+        const score::ScoreNote* notes;  // score
+        uint16_t count;                 // notes in the score
+    };
+
+    constexpr PresetEntry REGISTRY[] = {
+#define PRESET_ENTRY(id, name, tone) {PresetId::id, tone, sizeof(tone) / sizeof(score::ScoreNote)},
+        PRESET_LIST(PRESET_ENTRY)
+#undef PRESET_ENTRY
+    };
+
+    constexpr uint8_t PRESET_COUNT = static_cast<uint8_t>(PresetId::Count);
+
+    static_assert(sizeof(REGISTRY) / sizeof(REGISTRY[0]) == PRESET_COUNT, "presets::REGISTRY needs exactly one entry per PresetId");
+
+
     // ===  TO SELECT PRESETS BY ID ===
 
     /**
-     * @brief Get the Preset ScoreView By Id object
+     * @brief Get the ScoreView of a preset known at compile time
      * 
-     * @param id - Preset id
-     * @return score::ScoreView - struct that hold a reference to the actual data(ScoreNote*) and size 
+     * @details Folded by the compiler into the score pointer and size: no table is read.
+     * 
+     * Example usage:
+     * 
+     * builder.appendScore(presets::getPreset<PresetId::Startup>());
+     * 
+     * @tparam Id - Preset id
+     * @return score::ScoreView - struct that hold a reference to the actual data(ScoreNote*) and size
      */
-    inline score::ScoreView getPresetById(PresetId id)
+    template<PresetId Id>
+    constexpr score::ScoreView getPreset()
     {
-        switch (id)
-        {
-            case PresetId::Success:         return success();
-            case PresetId::Error:           return  error();
-            case PresetId::Notification:    return notification();
-            case PresetId::Warning:         return warning();
-            case PresetId::Startup:         return startup();
-            case PresetId::Shutdown:        return shutdown();
-            case PresetId::ButtonClick:     return buttonClick();
-            default:  break;
-        }
+        static_assert(static_cast<uint8_t>(Id) < PRESET_COUNT, "not a preset");
+        return score::ScoreView{REGISTRY[static_cast<uint8_t>(Id)].notes, REGISTRY[static_cast<uint8_t>(Id)].count};
     }
-}
\ No newline at end of file
+
+    /**
+     * @brief Get the Preset ScoreView By Id object
+     * 
+     * @details O(1): the id indexes the flash table of Presets.cpp.
+     * 
+     * @param id - Preset id
+     * @return score::ScoreView - struct that hold a reference to the actual data(ScoreNote*) and size. Empty for an unknown id
+     */
+    score::ScoreView getPresetById(PresetId id);
+
+    /**
+     * @brief Copy the name of a preset (the names stay in flash)
+     * 
+     * @param id - Preset id
+     * @param out - output buffer, always null terminated
+     * @param capacity - its size (a longer name is cut)
+     * @return size_t - characters copied, 0 for an unknown id
+     */
+    size_t getPresetName(PresetId id, char* out, size_t capacity);
+
+    /**
+     * @brief Find a preset by name in constant time (e.g. the argument of a "play error" Serial command)
+     * 
+     * @details The names are hashed into a table with a compile time perfect hash (no collisions),
+     * so the lookup is one hash of the input and one compare with the only candidate. Case insensitive.
+     * 
+     * @param name - characters of the name (need not be null terminated)
+     * @param length - characters in name
+     * @param id - output preset, untouched when not found
+     * @return true if the name is a preset
+     */
+    bool findPresetByName(const char* name, size_t length, PresetId& id);
+
+    /// @brief Same as above for a null terminated name
+    bool findPresetByName(const char* name, PresetId& id);
+}
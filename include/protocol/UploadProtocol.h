@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Wire format of the Serial melody upload (shared by the firmware and tools/melodyupload)
+ *
+ * @details
+ * Every frame, host -> device and device -> host, is
+ *
+ *      0x00  COBS( type | seq | body | crc16 LE )  0x00
+ *
+ * with the CRC-16 of core/Crc16.h over type, seq and body. COBS leaves 0x00 to the delimiters,
+ * so a receiver resynchronizes on the next frame after any garbage (the leading 0x00 also cuts
+ * the device log lines that share the Serial line from the reply that follows them).
+ *
+ * Host -> device (multi-byte values are little endian):
+ *
+ *      PING        -
+ *      BEGIN       kind (Kind), total u16 (steps, or bytes of encoded score)
+ *      DATA        offset u16, then STEP_WIRE_BYTES per step (freq u16, duration ms u32),
+ *                  or raw bytes of the encoded score (codec::encodeScore() output)
+ *      COMMIT      steps: loop flag / score: tone number
+ *      PLAY        tone number
+ *      STOP        -
+ *
+ * Device -> host: REPLY_FLAG | type, same seq, body = status (Status), received u16.
+ *
+ * The host sends one frame at a time and waits for its reply. A frame with a bad CRC gets no
+ * reply at all (its type and seq cannot be trusted), the host resends it after a timeout. DATA
+ * frames must come in order (offset == what the device already has): a repeated frame, sent
+ * again because its reply got lost, is acknowledged without being written twice.
+ */
+namespace upload
+{
+    constexpr uint8_t DELIMITER = 0x00;
+    constexpr uint8_t HEAD_BYTES = 2;                   // type, seq
+    constexpr uint8_t CRC_BYTES = 2;
+    constexpr uint8_t STEP_WIRE_BYTES = 6;              // freq u16, duration u32
+    constexpr uint8_t MAX_STEPS_PER_FRAME = 16;
+    constexpr uint8_t MAX_DATA_BYTES = 2 + MAX_STEPS_PER_FRAME * STEP_WIRE_BYTES;   // offset + payload
+    constexpr uint8_t REPLY_FLAG = 0x80;
+    constexpr uint8_t REPLY_BODY_BYTES = 3;             // status, received u16
+    constexpr uint32_t BAUD_RATE = 115200;
+
+    /// @brief Frame types sent by the host (replies carry REPLY_FLAG | type)
+    enum class FrameType : uint8_t
+    {
+        Ping    = 0x01,
+        Begin   = 0x02,
+        Data    = 0x03,
+        Commit  = 0x04,
+        Play    = 0x05,
+        Stop    = 0x06
+    };
+
+    /// @brief What an upload carries
+    enum class Kind : uint8_t
+    {
+        Steps   = 0,            // ready to play steps, into the step buffer of the device
+        Score   = 1             // encoded score, stored as a tone (EEPROM melody bank)
+    };
+
+    /// @brief Reply status
+    enum class Status : uint8_t
+    {
+        Ok          = 0,
+        BadState    = 1,        // DATA / COMMIT without BEGIN, or incomplete upload committed
+        BadRange    = 2,        // too big for the buffer, out of order or malformed body
+        StoreFailed = 3,        // the score could not be stored
+        Unknown     = 4         // unknown frame type
+    };
+
+    /// @brief Worst case size of an encoded frame, both delimiters included
+    constexpr size_t maxFrameSize(size_t bodyLength)
+    {
+        return 2 + (HEAD_BYTES + bodyLength + CRC_BYTES) + (HEAD_BYTES + bodyLength + CRC_BYTES) / 254 + 1;
+    }
+
+    /**
+     * @brief Build a frame: CRC, COBS and both delimiters
+     *
+     * @param type - frame type (REPLY_FLAG set for a reply)
+     * @param seq - sequence number
+     * @param body - body bytes (nullptr if bodyLength is 0)
+     * @param bodyLength - their count
+     * @param out - output buffer, maxFrameSize(bodyLength) is always enough
+     * @param capacity - its size
+     * @return size_t - bytes to send, 0 if out is too small
+     */
+    size_t encodeFrame(uint8_t type, uint8_t seq, const uint8_t* body, size_t bodyLength, uint8_t* out, size_t capacity);
+
+    /**
+     * @brief Decode a frame received whole (delimiters excluded) and check its CRC
+     *
+     * @param data - COBS bytes between two delimiters
+     * @param length - their count
+     * @param out - decoded type, seq and body (CRC stripped)
+     * @param capacity - its size
+     * @return size_t - decoded length (type and seq included), 0 if malformed or bad CRC
+     */
+    size_t decodeFrame(const uint8_t* data, size_t length, uint8_t* out, size_t capacity);
+
+    /// @brief Read a little endian 16 bits value
+    inline uint16_t readU16(const uint8_t* bytes)
+    {
+        return (uint16_t)(bytes[0] | ((uint16_t)bytes[1] << 8));
+    }
+
+    /// @brief Write a little endian 16 bits value
+    inline void writeU16(uint8_t* bytes, uint16_t value)
+    {
+        bytes[0] = (uint8_t)value;
+        bytes[1] = (uint8_t)(value >> 8);
+    }
+}
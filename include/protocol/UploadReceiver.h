@@ -0,0 +1,180 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "core/Types.h"
+#include "core/Cobs.h"
+#include "protocol/UploadProtocol.h"
+
+/// @brief Sends reply bytes (Serial.write() on the device, the pty on the host)
+typedef void (*ByteSink)(const uint8_t* bytes, size_t length, void* context);
+
+/// @brief Stores an uploaded encoded score as a tone (MelodyBank::storeEncoded() on the device)
+/// @return false if it could not be stored
+typedef bool (*ScoreHandler)(uint8_t tone, const uint8_t* encoded, uint16_t length, void* context);
+
+/**
+ * @brief What a complete frame asks the application to do
+ */
+struct UploadEvent
+{
+    enum class Type : uint8_t
+    {
+        None,               // nothing (frame not complete yet, bad frame or nothing to do)
+        UploadStarted,      // the step buffer is about to be overwritten: stop playing it
+        MelodyReady,        // melody() holds the uploaded steps
+        ScoreStored,        // tone holds the uploaded score
+        PlayTone,           // play tone
+        Stop                // stop playing
+    };
+
+    Type type;
+    uint8_t tone;
+    bool loop;
+};
+
+/**
+ * @brief Device side of the Serial melody upload (see protocol/UploadProtocol.h)
+ *
+ * @details
+ * Bytes are fed one at a time as they come out of the Serial buffer and decoded on the fly:
+ * there is no frame buffer. The CRC is updated per byte and the last two decoded bytes are held
+ * back (they may be the CRC), every other byte of a DATA frame goes straight to its place:
+ *
+ *  - steps: each 6 bytes record is written as a Step at buffer[offset + k], the buffer the
+ *    player then plays (no copy between the Serial line and the melody)
+ *  - score: bytes are staged in the same buffer, seen as raw bytes, until COMMIT hands them to
+ *    the ScoreHandler (the EEPROM melody bank)
+ *
+ * A frame is written only past what the device already has, and what it has only grows when the
+ * CRC of the frame checks: a corrupt frame may scribble over the part not received yet, never
+ * over accepted data. MelodyReady is only reported once every step arrived.
+ *
+ * A frame repeating the type and seq of the last one (its reply got lost) is answered again
+ * without being applied twice.
+ *
+ * The step buffer is shared by the uploaded melody and the staged score: the application stops
+ * the player on UploadStarted if it is playing melody().
+ *
+ * No Arduino dependency: the same code runs in tools/melodyupload/fakedevice.cpp.
+ *
+ * Example usage:
+ *
+ * Step uploadSteps[64];
+ * UploadReceiver receiver(uploadSteps, 64);
+ * MelodyBank bank;
+ *
+ * void sendReply(const uint8_t* bytes, size_t n, void*) { Serial.write(bytes, n); }
+ * bool storeTone(uint8_t tone, const uint8_t* data, uint16_t n, void*) { return bank.storeEncoded(tone, data, n); }
+ *
+ * void setup()
+ * {
+ *     Serial.begin(upload::BAUD_RATE);
+ *     bank.mount();
+ *     receiver.setReplySink(sendReply, nullptr);
+ *     receiver.setScoreHandler(storeTone, nullptr);
+ * }
+ *
+ * void loop()
+ * {
+ *     while (Serial.available() > 0)
+ *     {
+ *         UploadEvent event = receiver.feed((uint8_t)Serial.read());
+ *         if (event.type == UploadEvent::Type::UploadStarted) player.stop();
+ *         if (event.type == UploadEvent::Type::MelodyReady) player.play(receiver.melody(), event.loop);
+ *     }
+ *     player.update();
+ * }
+ */
+class UploadReceiver
+{
+    public:
+
+        /// @brief Constructor
+        /// @param buffer - step buffer the uploads are written to
+        /// @param capacity - its size in steps
+        UploadReceiver(Step* buffer, uint16_t capacity);
+
+        /// @brief Where replies go (no replies if not set)
+        void setReplySink(ByteSink sink, void* context);
+
+        /// @brief Who stores uploaded scores (score uploads fail with StoreFailed if not set)
+        void setScoreHandler(ScoreHandler handler, void* context);
+
+        /// @brief Process one received byte
+        /// @return UploadEvent - what the frame ended by this byte asks for (None most of the time)
+        UploadEvent feed(uint8_t byte);
+
+        /// @brief Last uploaded melody (empty until MelodyReady, and again from UploadStarted)
+        Melody melody() const;
+
+        /// @brief Steps or score bytes of the current upload accepted so far
+        uint16_t received() const;
+
+        /// @brief Frames accepted (good CRC)
+        uint16_t goodFrames() const;
+
+        /// @brief Frames dropped because of a bad CRC
+        uint16_t crcErrors() const;
+
+        /// @brief Frames dropped because they were truncated or too long
+        uint16_t framingErrors() const;
+
+    private:
+
+        /// @brief A byte of type, seq or body (the CRC is held back)
+        void processByte_(uint8_t byte);
+
+        /// @brief Delimiter: check the frame and apply it
+        UploadEvent endFrame_();
+
+        /// @brief Apply a frame that passed the CRC check
+        UploadEvent handleFrame_(upload::Status& status);
+
+        /// @brief Send a reply to the last frame
+        void reply_(uint8_t type, uint8_t seq, upload::Status status);
+
+        /// @brief Forget the current frame
+        void resetFrame_();
+
+        /// @brief Raw view of the step buffer (score staging)
+        uint8_t* rawBuffer_() const;
+
+        static constexpr uint8_t HEAD_CAPTURE = 5;      // type, seq, up to 3 body bytes
+        static constexpr uint16_t MAX_FRAME_BYTES = upload::HEAD_BYTES + upload::MAX_DATA_BYTES;
+
+        Step* buffer_;                      // step buffer
+        uint16_t capacity_;                 // its size in steps
+
+        ByteSink sink_;                     // replies
+        void* sinkContext_;
+        ScoreHandler scoreHandler_;         // score storage
+        void* scoreContext_;
+
+        // Frame being decoded
+        cobs::Decoder decoder_;
+        uint16_t crc_;                      // CRC of the bytes processed so far
+        uint8_t lag_[upload::CRC_BYTES];    // last decoded bytes, maybe the CRC
+        uint8_t lagCount_;
+        uint16_t index_;                    // bytes processed (type = 0)
+        uint8_t head_[HEAD_CAPTURE];        // first bytes of the frame
+        uint8_t stepBytes_[upload::STEP_WIRE_BYTES];   // step being assembled
+        bool writing_;                      // the DATA frame extends the upload, store its payload
+
+        // Upload
+        bool active_;                       // BEGIN accepted, not committed yet
+        upload::Kind kind_;                 // what it carries
+        uint16_t total_;                    // steps or bytes announced by BEGIN
+        uint16_t received_;                 // steps or bytes accepted
+        uint16_t committed_;                // steps of melody()
+
+        // Last frame applied, to answer a retransmission without applying it again
+        bool hasLast_;
+        uint8_t lastType_;
+        uint8_t lastSeq_;
+        upload::Status lastStatus_;
+
+        uint16_t goodFrames_;
+        uint16_t crcErrors_;
+        uint16_t framingErrors_;
+};
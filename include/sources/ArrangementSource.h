@@ -0,0 +1,40 @@
+#pragma once
+
+#include "player/IStepSource.h"
+#include "core/Types.h"
+
+/**
+ * @brief Step source that walks an Arrangement(list of phrase references) in place
+ * 
+ * @details
+ * Phrases are built once (e.g. with MelodyBuilder::buildFrom()) and referenced as many times as
+ * the song needs them, optionally transposed. Nothing is expanded: the source only keeps
+ * which reference, which repetition and which step of the phrase comes next.
+ * 
+ * Example usage (AABA):
+ * 
+ * const PhraseRef refs[] = { {&phraseA, 2, 0}, {&phraseB, 1, 0}, {&phraseA, 1, 0} };
+ * ArrangementSource song(Arrangement{refs, 3});
+ * player.play(song, true);
+ */
+class ArrangementSource: public IStepSource
+{
+    private:
+
+        Arrangement arrangement_;   // references being walked (not owned)
+        size_t refIdx_;             // current phrase reference
+        uint8_t pass_;              // repetitions already played of the current reference
+        size_t stepIdx_;            // next step inside the current phrase
+
+    public:
+
+    /// @brief Constructor
+    /// @param arrangement - phrase references. They and their phrases must outlive the playback
+    explicit ArrangementSource(const Arrangement& arrangement);
+
+    // === Implemented method form IStepSource ===
+
+    void rewind() override;
+    bool next(Step& step) override;
+
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "sources/NoteStepSource.h"
+#include "codec/ScoreCodec.h"
+
+/**
+ * @brief Step source that decodes a compressed score(see codec::encodeScore) while it plays
+ * 
+ * @details
+ * The encoded bytes stay where they are (flash by default) and are decoded a note at a time,
+ * on the step boundary, so a jingle only costs its encoded size in flash and a few bytes of SRAM.
+ * 
+ * Example usage:
+ * 
+ * static const uint8_t JINGLE[] PROGMEM = { ... };     // generated with tools/scorepack
+ * 
+ * MelodyContext ctx;       // tempo 120bpm, no gap
+ * CompressedScoreSource jingle(JINGLE, ctx);
+ * player.play(jingle);
+ */
+class CompressedScoreSource: public NoteStepSource
+{
+    private:
+
+        codec::ScoreDecoder decoder_;
+
+    protected:
+
+        // === Implemented method form NoteStepSource ===
+        bool nextNote_(score::ScoreNote& note) override;
+        void rewindNotes_() override;
+
+    public:
+
+    /// @brief Constructor
+    /// @param data - encoded score
+    /// @param ctx - tempo and articulation gap
+    /// @param space - memory where data lives (flash by default)
+    CompressedScoreSource(const uint8_t* data, const MelodyContext& ctx, codec::MemorySpace space = codec::MemorySpace::Flash);
+
+    /// @brief Point the source to another encoded score and rewind it
+    /// @param data - encoded score
+    /// @param space - memory where data lives
+    void reset(const uint8_t* data, codec::MemorySpace space = codec::MemorySpace::Flash);
+
+    /// @brief Number of notes in the encoded score
+    uint16_t noteCount() const;
+
+};
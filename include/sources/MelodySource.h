@@ -0,0 +1,32 @@
+#pragma once
+
+#include "player/IStepSource.h"
+#include "core/Types.h"
+
+/**
+ * @brief Step source over an already built Melody(array of Steps)
+ * 
+ * @details This is how BuzzerPlayer plays a Melody: it walks the Step array in place, no copies.
+ */
+class MelodySource: public IStepSource
+{
+    private:
+
+        Melody melody_;         // view over the Steps (does not own them)
+        size_t nextIdx_;        // index of the Step the next call to next() returns
+
+    public:
+
+    MelodySource();
+
+    /// @brief Point the source to a new melody and rewind it
+    /// @param melody - melody to walk
+    void reset(const Melody& melody);
+
+    // === Implemented method form IStepSource ===
+
+    void rewind() override;
+    bool next(Step& step) override;
+    bool seek(size_t index) override;
+
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "player/IStepSource.h"
+#include "core/Types.h"
+
+/**
+ * @brief Settings of a metronome
+ */
+struct MetronomeConfig
+{
+    uint16_t bpm            = 120;      // quarter notes per minute (same tempo convention as MelodyBuilder)
+    uint8_t beatsPerBar     = 4;        // time signature numerator
+    uint8_t beatUnit        = 4;        // time signature denominator: one click per 1/beatUnit note
+    uint16_t accentHz       = 1760;     // click of the first beat of the bar
+    uint16_t beatHz         = 880;      // click of the other beats
+    uint16_t clickMs        = 15;       // click length (at most half a beat)
+};
+
+/**
+ * @brief Endless step source that produces metronome clicks from a deadline sequence
+ *
+ * @details
+ * No Step buffer: each beat is synthesized when the player asks for it (a click, then a rest
+ * until the next beat). Beat k starts at k * 240000000 / (bpm * beatUnit) us, computed with an
+ * exact remainder, and the sub-ms part of each step is reported to the player
+ * (lastStepExtraUs()), so beats do not round to the ms and the sequence never drifts.
+ *
+ * setConfig() (tempo, time signature, pitches) takes effect at the next beat: the beat being
+ * played keeps its length. With a batch backend the steps already handed to it (a beat or two)
+ * keep the old tempo.
+ *
+ * The beat onsets are as exact as the backend timing: with a polled backend a beat can start up
+ * to one loop() period late. Timer1Backend switches the steps from its ISR, so the onsets do not
+ * depend on what the main loop does.
+ *
+ * Example usage:
+ *
+ * MetronomeConfig cfg;
+ * cfg.bpm = 96;
+ * cfg.beatsPerBar = 6;
+ * cfg.beatUnit = 8;
+ * MetronomeSource metronome(cfg);
+ * player.play(metronome);
+ */
+class MetronomeSource: public IStepSource
+{
+    private:
+
+        MetronomeConfig config_;        // settings of the beats being produced
+        MetronomeConfig pending_;       // settings for the next beat
+        bool hasPending_;               // setConfig() not applied yet
+
+        uint32_t beatUs_;               // whole us of a beat
+        uint32_t beatRemainder_;        // 240000000 % (bpm * beatUnit): fraction of us per beat
+        uint32_t fractionAcc_;          // accumulated fraction (Bresenham)
+        uint32_t restUs_;               // rest left to emit after the click (0 = next is a click)
+        uint8_t beatInBar_;             // beat of the next click (0 = downbeat)
+        uint16_t lastExtraUs_;          // sub-ms part of the last step
+        uint32_t beats_;                // clicks produced since rewind()
+
+        void applyConfig_(const MetronomeConfig& config);  // compute the beat length of a config
+
+    public:
+
+    /// @brief Constructor
+    /// @param config - tempo, time signature, click pitches and length
+    explicit MetronomeSource(const MetronomeConfig& config = MetronomeConfig());
+
+    /// @brief Change the settings from the next beat on
+    /// @param config - new settings
+    void setConfig(const MetronomeConfig& config);
+
+    /// @brief Settings of the next beat
+    const MetronomeConfig& config() const;
+
+    /// @brief Clicks produced since the start
+    uint32_t beats() const;
+
+    // === Implemented method form IStepSource ===
+
+    void rewind() override;
+    bool next(Step& step) override;
+    uint16_t lastStepExtraUs() const override;
+    bool isReplayable() const override;
+
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "player/IStepSource.h"
+#include "core/Types.h"
+#include "music/Score.h"
+
+/**
+ * @brief Base class for sources that produce sheet music notes(ScoreNote) instead of Steps
+ * 
+ * @details
+ * It does on the fly, one note at a time, the same conversion MelodyBuilder::addNote() does up front:
+ *  - denom -> milliseconds using the tempo of the MelodyContext
+ *  - split the note into tone + articulation rest when a gap is configured
+ * 
+ * Derived classes only implement where the notes come from (nextNote_/rewindNotes_).
+ */
+class NoteStepSource: public IStepSource
+{
+    private:
+
+        MelodyContext ctx_;         // tempo + gap used to convert notes to Steps
+        uint32_t pendingRestMs_;    // articulation rest still to emit after the last tone (0 = none)
+
+    protected:
+
+        /// @brief Produce the next note of the score
+        /// @param note - output note
+        /// @return false when the score is exhausted
+        virtual bool nextNote_(score::ScoreNote& note) = 0;
+
+        /// @brief Go back to the first note of the score
+        virtual void rewindNotes_() = 0;
+
+    public:
+
+    /// @brief Constructor
+    /// @param ctx - tempo and articulation gap used to convert notes
+    explicit NoteStepSource(const MelodyContext& ctx);
+
+    /// @brief Change the tempo/gap used for the next converted notes
+    void setContext(const MelodyContext& ctx);
+
+    /// @brief Current conversion context
+    const MelodyContext& context() const;
+
+    // === Implemented method form IStepSource ===
+
+    void rewind() override;
+    bool next(Step& step) override;
+
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "player/IStepSource.h"
+#include "sources/MelodySource.h"
+#include "core/Types.h"
+#include "core/Random.h"
+
+/**
+ * @brief Order in which a playlist walks its entries
+ */
+enum class PlaylistOrder : uint8_t
+{
+    InOrder,        // entries as listed
+    Shuffle         // every entry once per pass, in pseudo random order
+};
+
+/**
+ * @brief Step source that plays several melodies back to back (playlist / medley / attract mode)
+ * 
+ * @details
+ * The entries are chained inside the step sequence, so for the player the whole playlist is one
+ * melody: the first step of an entry starts exactly at the deadline of the last step of the
+ * previous one, with no stop()/play() round trip.
+ * Playing it with loop = true repeats the playlist (and reshuffles it).
+ * 
+ * setRepeats() gives each entry a repeat count: the entry plays that many times in a row (a
+ * shuffle moves the run as a whole), 0 skips it. Without it every entry plays once.
+ * 
+ * A shuffled pass is drawn from a pass seed: rewind() replays the same order (seek() and position
+ * queries rewind the source), only nextPass(), called by the player where the loop wraps, draws
+ * a new one.
+ * 
+ * Example usage:
+ * 
+ * const Melody songs[] = { intro, themeA, themeB };
+ * const uint8_t repeats[] = { 1, 2, 2 };
+ * PlaylistSource attract(songs, 3, PlaylistOrder::Shuffle, analogRead(A0));
+ * attract.setRepeats(repeats);
+ * player.play(attract, true);
+ */
+class PlaylistSource: public IStepSource
+{
+    private:
+
+        static constexpr uint8_t SHUFFLE_MASK_BITS = 32;     // entries tracked by the "already played" mask
+
+        const Melody* melodies_;        // entries as built melodies (or nullptr)
+        IStepSource* const* sources_;   // entries as step sources (or nullptr)
+        size_t count_;                  // number of entries
+        const uint8_t* repeats_;        // times in a row each entry plays (nullptr: once each)
+        PlaylistOrder order_;           // how entries are picked
+
+        MelodySource melodyAdapter_;    // walks the current entry when entries are melodies
+        IStepSource* current_;          // source of the current entry, nullptr before the first one
+        size_t played_;                 // entries started in this pass
+        size_t entryIdx_;               // current entry
+        uint8_t pass_;                  // repetitions already played of the current entry
+        uint32_t playedMask_;           // entries already played in this pass (shuffle)
+        uint16_t passSeed_;             // seed of the current pass, rewind() replays its order
+        XorShift16 rng_;                // shuffle generator
+
+        bool startNextEntry_();         // pick and rewind the next entry
+        void startEntry_();             // rewind the current entry
+        uint8_t repeatsOf_(size_t entry) const;    // times an entry plays in a row
+        size_t pickShuffled_();         // next entry in shuffle order
+
+    public:
+
+    /// @brief Playlist of built melodies
+    /// @param melodies - entries. The array and the steps must outlive the playback
+    /// @param count - number of entries
+    /// @param order - in order or shuffled
+    /// @param seed - shuffle seed
+    PlaylistSource(const Melody* melodies, size_t count, PlaylistOrder order = PlaylistOrder::InOrder, uint16_t seed = 0);
+
+    /// @brief Playlist of step sources (compressed scores, arrangements...)
+    /// @param sources - entries. The array and the sources must outlive the playback
+    /// @param count - number of entries
+    /// @param order - in order or shuffled
+    /// @param seed - shuffle seed
+    PlaylistSource(IStepSource* const* sources, size_t count, PlaylistOrder order = PlaylistOrder::InOrder, uint16_t seed = 0);
+
+    /// @brief Play each entry several times in a row
+    /// @param repeats - one count per entry, 0 skips it (nullptr: every entry once). Must outlive the playback
+    void setRepeats(const uint8_t* repeats);
+
+    /// @brief Index of the entry being played
+    size_t currentEntry() const;
+
+    // === Implemented method form IStepSource ===
+
+    void rewind() override;
+    bool nextPass() override;
+    bool next(Step& step) override;
+    bool isReplayable() const override;
+
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "player/IStepSource.h"
+#include "player/MelodyPool.h"
+#include "core/Types.h"
+
+/**
+ * @brief Step source over a melody of a MelodyPool, holding a reference to it
+ *
+ * @details
+ * This is how a player plays a pooled melody: it walks the block chain in place, no copies. The
+ * source takes a reference in reset() and drops it in clear() / reset() / its destructor, so
+ * the steps cannot be freed while it plays them. Each player (or queued request) needs its own
+ * source: it is the read cursor, the steps are shared.
+ *
+ * A stale handle (melody already freed) is refused by reset() and plays nothing.
+ *
+ * Example usage:
+ *
+ * PooledMelodySource source(pool);
+ * if (source.reset(handle)) player.play(source);
+ */
+class PooledMelodySource: public IStepSource
+{
+    private:
+
+        MelodyPool& pool_;          // pool the melody lives in
+        MelodyHandle handle_;       // melody referenced, null when none
+        uint8_t block_;             // block of the next step
+        uint8_t offset_;            // position of the next step in its block
+        uint16_t nextIdx_;          // index of the next step in the melody
+        uint16_t count_;            // steps of the melody
+
+    public:
+
+    /// @brief Constructor
+    /// @param pool - pool the melodies come from
+    explicit PooledMelodySource(MelodyPool& pool);
+
+    /// @brief Releases the melody
+    ~PooledMelodySource();
+
+    // A copy would release the reference twice
+    PooledMelodySource(const PooledMelodySource&) = delete;
+    PooledMelodySource& operator=(const PooledMelodySource&) = delete;
+
+    /// @brief Reference a melody and rewind (the previous one is released)
+    /// @param handle - melody to play
+    /// @return false if the handle is stale (the source is then empty)
+    bool reset(MelodyHandle handle);
+
+    /// @brief Release the melody, the source is then empty
+    void clear();
+
+    /// @brief Melody referenced (null when empty)
+    MelodyHandle handle() const;
+
+    // === Implemented method form IStepSource ===
+
+    void rewind() override;
+    bool next(Step& step) override;
+    bool seek(size_t index) override;
+
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "sources/NoteStepSource.h"
+#include "music/Score.h"
+
+/**
+ * @brief Step source that converts a ScoreView (e.g. a preset tone) while it plays
+ * 
+ * @details No Step buffer and no MelodyBuilder pass: handy for alerts played on top of a
+ * melody with BuzzerPlayer::interrupt().
+ * 
+ * Example usage:
+ * 
+ * MelodyContext alertCtx;
+ * alertCtx.bpm = 140;
+ * ScoreViewSource alert(presets::notification(), alertCtx);
+ * player.interrupt(alert);
+ */
+class ScoreViewSource: public NoteStepSource
+{
+    private:
+
+        score::ScoreView view_;     // notes being converted (not owned)
+        uint16_t nextIdx_;          // next note of the view
+
+    protected:
+
+        // === Implemented method form NoteStepSource ===
+        bool nextNote_(score::ScoreNote& note) override;
+        void rewindNotes_() override;
+
+    public:
+
+    /// @brief Constructor
+    /// @param view - notes to play. The notes must outlive the playback
+    /// @param ctx - tempo and articulation gap
+    ScoreViewSource(score::ScoreView view, const MelodyContext& ctx);
+
+    /// @brief Point the source to another score and rewind it
+    /// @param view - notes to play
+    void reset(score::ScoreView view);
+
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "player/IStepSource.h"
+#include "core/Types.h"
+
+/**
+ * @brief Producer that refills a StreamingSource
+ *
+ * @param dest - free slots to write the steps into (contiguous)
+ * @param maxSteps - slots available in dest
+ * @param ended - set to true once the stream has no more steps (the steps written in this call still play)
+ * @param context - pointer given with the producer
+ * @return uint16_t - steps written, 0 when nothing is ready yet
+ */
+typedef uint16_t (*StepProducer)(Step* dest, uint16_t maxSteps, bool& ended, void* context);
+
+/**
+ * @brief Step source that plays from a small circular buffer refilled by a producer in idle time
+ *
+ * @details
+ * A melody longer than any step buffer (a 10 minute piece, a score read from a file, a
+ * decompressor output) plays through a ring of a few steps. The application calls refill() when
+ * it has time (every loop(), after player.update()). The producer writes straight into the free
+ * slots of the ring, no intermediate copy. At a step boundary next() only takes a step out of the
+ * ring, so the producer work never lands on the step deadline.
+ *
+ * The producer is a callback (builder, parser, file reader...) or any other IStepSource
+ * (CompressedScoreSource, ArrangementSource...), pulled ahead of time.
+ *
+ * Underrun: next() finds the ring empty before the stream ended. It then calls the producer
+ * itself (the step starts late by the producer time). If that gives nothing either, a rest of
+ * UNDERRUN_REST_MS keeps the player going until the producer catches up. underruns(),
+ * underrunMs() and lowWatermark() tell how close the stream came to starving, to size the ring
+ * and the refill rate.
+ *
+ * Forward only: the steps played are gone from the ring. rewind() restarts the producer through
+ * the rewind callback (or rewinds the upstream source), seek() restarts it and drops the steps
+ * before the target as the producer makes them (no underrun is counted). Without a rewinder, a
+ * looped stream just ends and seek() fails without touching the ring. The player never indexes a
+ * stream (isReplayable() is false): its duration is unknown and player.seek() fails.
+ *
+ * Example usage (a long compressed score through a 16 steps ring = 64 bytes of SRAM):
+ *
+ * Step ring[16];
+ * CompressedScoreSource score(LONG_SCORE, ctx);
+ * StreamingSource stream(ring, 16);
+ * stream.setProducer(score);
+ * stream.refill();
+ * player.play(stream);
+ * void loop() { player.update(); stream.refill(); }
+ */
+class StreamingSource: public IStepSource
+{
+    private:
+
+        Step* buffer_;                  // ring storage (caller managed)
+        uint16_t capacity_;             // slots in the ring
+        uint16_t head_;                 // oldest buffered step
+        uint16_t count_;                // steps buffered
+
+        StepProducer producer_;         // refills the ring
+        void (*rewinder_)(void*);       // restarts the producer, nullptr: cannot loop
+        void* context_;                 // producer context
+        bool ended_;                    // the producer has no more steps
+        bool consumed_;                 // next() was called since the last restart
+
+        uint16_t underruns_;            // next() found the ring empty (saturates)
+        uint32_t underrunMs_;           // rest inserted while starving
+        uint16_t lowWatermark_;         // fewest steps buffered seen by next()
+        uint32_t produced_;             // steps written by the producer since the last restart
+
+        uint16_t produce_(uint16_t maxSteps);                                   // one producer call into the free slots
+        static uint16_t pullSource_(Step* dest, uint16_t maxSteps, bool& ended, void* context);  // producer over an IStepSource
+        static void rewindSource_(void* context);                               // rewinder over an IStepSource
+
+    public:
+
+    static constexpr uint16_t UNDERRUN_REST_MS = 10;     // rest played while the producer has nothing
+
+    /// @brief Constructor
+    /// @param buffer - ring storage. Must outlive the playback
+    /// @param capacity - slots in buffer
+    StreamingSource(Step* buffer, uint16_t capacity);
+
+    /// @brief Refill from a callback
+    /// @param producer - writes steps into the ring
+    /// @param context - passed back to producer and rewinder
+    /// @param rewinder - restarts the producer (rewind() / loop), nullptr if it cannot
+    void setProducer(StepProducer producer, void* context, void (*rewinder)(void*) = nullptr);
+
+    /// @brief Refill from another step source (decoded ahead of time instead of at the step boundary)
+    /// @param upstream - source to pull from. Must outlive the playback
+    void setProducer(IStepSource& upstream);
+
+    /// @brief Move steps from the producer into the free slots. Call it in idle time
+    /// @param maxSteps - steps to produce at most (bounds the time spent here)
+    /// @return uint16_t - steps added
+    uint16_t refill(uint16_t maxSteps = 0xFFFF);
+
+    /// @brief Steps buffered
+    uint16_t buffered() const;
+
+    /// @brief Check if the producer ended and every step was played
+    bool isDrained() const;
+
+    // --- Underrun counters ---
+
+    /// @brief Step boundaries that found the ring empty before the end of the stream
+    uint16_t underruns() const;
+
+    /// @brief Rest inserted while the producer had nothing, in ms
+    uint32_t underrunMs() const;
+
+    /// @brief Fewest steps buffered at a step boundary (capacity when never used)
+    uint16_t lowWatermark() const;
+
+    /// @brief Steps produced since the start of the stream
+    uint32_t produced() const;
+
+    /// @brief Clear the underrun counters
+    void resetCounters();
+
+    // === Implemented method form IStepSource ===
+
+    void rewind() override;
+    bool next(Step& step) override;
+    bool isReplayable() const override;
+    bool seek(size_t index) override;
+
+};
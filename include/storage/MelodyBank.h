@@ -0,0 +1,126 @@
+#pragma once
+
+#include <stdint.h>
+#include "core/Eeprom.h"
+#include "music/Score.h"
+#include "sources/CompressedScoreSource.h"
+
+/**
+ * @brief Persistent bank of user tones in the internal EEPROM
+ *
+ * @details
+ * Tones are scores compressed with the codec (about 6 bits per note), stored in fixed size
+ * records and played straight from EEPROM: bank.open() points a CompressedScoreSource at the
+ * record (MemorySpace::Eeprom), so a user tone costs no SRAM besides the decoder state.
+ *
+ * Record (SLOT_BYTES, the area is split into slots):
+ *
+ *      0       magic: VALID, 0x00 invalidated, 0xFF never written
+ *      1       tone number
+ *      2..3    sequence (LE), increases with every write of the bank
+ *      4..5    payload length (LE)
+ *      6..7    CRC-16 of bytes 1..5 and of the payload (LE)
+ *      8..     payload: encoded score
+ *
+ * Wear leveling: a tone is never rewritten in place. Each store() goes to the next slot in
+ * rotation that does not hold a live tone, and only then is the previous copy invalidated (one
+ * byte). Writes therefore spread over every slot not holding a tone that never changes, and an
+ * interrupted write (power loss) leaves the previous copy valid: the new one has no magic or a
+ * bad CRC, and when both survive the higher sequence wins (mount() invalidates the other one).
+ *
+ * The directory (tone -> slot) is rebuilt in SRAM by mount() from the record headers, one byte
+ * per tone. Records with a bad CRC are skipped and counted (corruptRecords()).
+ *
+ * Example usage:
+ *
+ * MelodyBank bank;                            // whole EEPROM: 8 slots of 128 bytes, 4 tones
+ * CompressedScoreSource userTone(nullptr, ctx);
+ *
+ * void setup() { bank.mount(); }
+ * void onSaveTone(const score::ScoreNote* notes, uint16_t n) { bank.store(0, notes, n); }
+ * void onAlert() { if (bank.open(0, userTone)) player.play(userTone); }
+ */
+class MelodyBank
+{
+    public:
+
+        static constexpr uint16_t SLOT_BYTES = 128;                             // record size
+        static constexpr uint8_t HEADER_BYTES = 8;                              // record header
+        static constexpr uint16_t MAX_PAYLOAD = SLOT_BYTES - HEADER_BYTES;      // encoded score bytes (~150 notes)
+        static constexpr uint8_t MAX_TONES = 8;                                 // directory entries
+        static constexpr uint8_t NO_SLOT = 0xFF;
+
+        /// @brief Constructor (nothing is read until mount())
+        /// @param baseAddress - first EEPROM byte of the bank
+        /// @param sizeBytes - bytes of EEPROM given to the bank (whole slots are used)
+        /// @param tones - tone numbers 0..tones-1, at most MAX_TONES and fewer than the slots
+        MelodyBank(uint16_t baseAddress = 0, uint16_t sizeBytes = eeprom::SIZE, uint8_t tones = 4);
+
+        /// @brief Scan the records and rebuild the directory
+        /// @return uint8_t - tones found
+        uint8_t mount();
+
+        /// @brief Encode a score and store it as a tone (replaces the previous one)
+        /// @details Encodes on the stack (MAX_PAYLOAD bytes)
+        /// @param tone - tone number
+        /// @param notes - score
+        /// @param count - notes in the score
+        /// @return false if the tone number is invalid, the score does not fit or the write did not verify
+        bool store(uint8_t tone, const score::ScoreNote* notes, uint16_t count);
+
+        /// @brief Store an already encoded score (codec::encodeScore() output) as a tone
+        /// @param tone - tone number
+        /// @param encoded - encoded bytes, header included
+        /// @param length - bytes, at most MAX_PAYLOAD
+        /// @return false if the tone number is invalid, the score does not fit or the write did not verify
+        bool storeEncoded(uint8_t tone, const uint8_t* encoded, uint16_t length);
+
+        /// @brief Delete a tone
+        /// @return false if there was no such tone
+        bool erase(uint8_t tone);
+
+        /// @brief Check if a tone is stored
+        bool contains(uint8_t tone) const;
+
+        /// @brief Encoded size of a tone in bytes (0 if absent)
+        uint16_t encodedSize(uint8_t tone) const;
+
+        /// @brief EEPROM address of the encoded score of a tone, for MemorySpace::Eeprom (nullptr if absent)
+        const uint8_t* scoreData(uint8_t tone) const;
+
+        /// @brief Point a source at a tone, to play it straight from EEPROM
+        /// @return false if the tone is absent (the source is left untouched)
+        bool open(uint8_t tone, CompressedScoreSource& source) const;
+
+        /// @brief Records skipped by the last mount() because of a bad CRC
+        uint8_t corruptRecords() const;
+
+        /// @brief Slots of the bank
+        uint8_t slotCount() const;
+
+    private:
+
+        /// @brief EEPROM address of a slot
+        uint16_t slotAddress(uint8_t slot) const;
+
+        /// @brief Read a little endian 16 bits value
+        static uint16_t readWord(uint16_t address);
+
+        /// @brief Write a little endian 16 bits value
+        static void writeWord(uint16_t address, uint16_t value);
+
+        /// @brief Check the record of a slot
+        /// @return false if it is empty, invalidated or corrupt
+        bool readRecord(uint8_t slot, uint8_t& tone, uint16_t& sequence, uint16_t& length, bool& corrupt) const;
+
+        /// @brief Next slot in rotation that holds no live tone
+        uint8_t nextFreeSlot() const;
+
+        uint16_t base_;                 // first EEPROM byte of the bank
+        uint8_t slots_;                 // records in the bank
+        uint8_t tones_;                 // tone numbers in use
+        uint8_t directory_[MAX_TONES];  // slot of each tone, NO_SLOT if absent
+        uint16_t nextSequence_;         // sequence of the next record written
+        uint8_t writeSlot_;             // where the rotation continues
+        uint8_t corrupt_;               // bad CRC records seen by mount()
+};
@@ -5,7 +5,9 @@
 Delay::Delay(unsigned long delayTime) : 
 _delayTime(delayTime),
 _previousTime(0),
-_disarm(false)
+_disarm(false),
+_wheel(nullptr),
+_fired(false)
 {}
 
 /** set the target time delay and start counting */
@@ -13,17 +15,28 @@ void Delay::init(){
   this->_disarm = false;
   this->_delayTime = _delayTime;
   this->_previousTime = micros();
+  arm();
 }
 
 void Delay::init(unsigned long delayTime){
   this->_disarm = false;
   this->_delayTime = delayTime;
   _previousTime = micros();
+  arm();
 }
 
 
 /** Calculate if the delay time has elapsed*/
 bool Delay::isDelayTimeElapsed(){ 
+  // The wheel tracks the deadline: no clock read
+  if(_wheel != nullptr)
+  {
+    if(_disarm || !_fired) return false;
+
+    restartTimer();
+    return true;
+  }
+
   unsigned long now = micros();
   
   // If the timer has not been stop 
@@ -53,14 +66,113 @@ bool Delay::isDelayTimeElapsed(){
  */
 void Delay::stopDelay(){
   _disarm = true;
+  if(_wheel != nullptr) _wheel->cancel(_wheelTimer);
 }
 
 /** when the time delay has elapse we update the time counter*/
 void Delay::restartTimer(){
   this->_previousTime = micros();
+  arm();
+}
+
+/**
+ * @brief Check if the delay time has elapsed without restarting the timer
+ * 
+ * @details Unlike isDelayTimeElapsed() the reference timestamp is kept, so the
+ * deadline can be used to chain the next interval.
+ * 
+ * @return true - the delay has elapsed
+ * @return false - not yet, or the delay is disarmed
+ */
+bool Delay::hasElapsed() const
+{
+  if(_disarm) return false;
+  if(_wheel != nullptr) return _fired;
+
+  return (micros() - _previousTime >= _delayTime);
+}
+
+/**
+ * @brief Get the time since the start of the current interval
+ * 
+ * @return unsigned long - us, 0 if the delay is disarmed
+ */
+unsigned long Delay::elapsed() const
+{
+  if(_disarm) return 0;
+
+  return micros() - _previousTime;
+}
+
+/**
+ * @brief Start the next interval exactly at the deadline of the current one
+ * 
+ * @details
+ * restartTimer() takes "now" as reference, so any lateness of the caller is added to the
+ * next interval and accumulates. chain() takes the previous deadline as reference instead,
+ * so a sequence of intervals stays aligned with the time it was started.
+ * 
+ * @param nextDelayTime - duration of the next interval in us
+ */
+void Delay::chain(unsigned long nextDelayTime)
+{
+  this->_previousTime += this->_delayTime;
+  this->_delayTime = nextDelayTime;
+  this->_disarm = false;
+  arm();
 }
 
 /** Set new Delay Value for the Class*/
 void Delay::updateDelayTime(unsigned long newDelayTime){
   this->_delayTime = newDelayTime;
+  if(!_disarm) arm();
+}
+
+/**
+ * @brief Let a timer wheel track the deadline
+ * 
+ * @details From now on hasElapsed() and isDelayTimeElapsed() read a flag set from
+ * TimerWheel::poll(), so the loop does not read micros() once per Delay. A running
+ * interval is moved to the wheel (or back to micros() polling with nullptr).
+ * 
+ * @param wheel - wheel polled by the application, nullptr to detach
+ */
+void Delay::attach(TimerWheel* wheel)
+{
+  if(_wheel != nullptr) _wheel->cancel(_wheelTimer);
+
+  this->_wheel = wheel;
+  this->_wheelTimer.callback = &Delay::onWheelExpired;
+  this->_wheelTimer.context = this;
+
+  if(!_disarm) arm();
+}
+
+/**
+ * @brief Register the deadline of the current interval in the wheel
+ * 
+ * @details A deadline already passed (e.g. chain() after a late check) is flagged right away,
+ * so the caller sees it in the same call, like with micros() polling.
+ */
+void Delay::arm()
+{
+  if(_wheel == nullptr) return;
+
+  unsigned long deadline = _previousTime + _delayTime;
+
+  if((long)(micros() - deadline) >= 0)
+  {
+    _wheel->cancel(_wheelTimer);
+    _fired = true;
+    return;
+  }
+
+  _fired = false;
+  _wheel->scheduleAtUs(_wheelTimer, deadline);
+}
+
+/** Wheel callback: the deadline is reached */
+void Delay::onWheelExpired(void* context)
+{
+  static_cast<Delay*>(context)->_fired = true;
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "Timer/TimerWheel.h"
+#include <Arduino.h>
+
+/**
+ * @brief Construct a new Timer Wheel, tick 0 starts now
+ *
+ * @param tickUs - length of a tick in us
+ */
+TimerWheel::TimerWheel(uint32_t tickUs) :
+tickUs_(tickUs > 0 ? tickUs : 1),
+current_(0),
+baseUs_(micros())
+{
+    for (uint8_t level = 0; level < LEVELS; ++level)
+    {
+        for (uint8_t slot = 0; slot < SLOTS; ++slot) slots_[level][slot] = nullptr;
+    }
+}
+
+/**
+ * @brief Run every tick whose time has come
+ *
+ * @details Subtraction only (no division): each elapsed tick moves baseUs_ by one tick length.
+ * After a long blocking call the missed ticks are run one after another.
+ */
+void TimerWheel::poll()
+{
+    unsigned long now = micros();
+
+    while ((long)(now - baseUs_) >= 0)
+    {
+        runTick();
+        ++current_;
+        baseUs_ += tickUs_;
+    }
+}
+
+/**
+ * @brief Arm a timer relative to the current tick
+ *
+ * @param timer - timer to arm (re-armed if already armed)
+ * @param delayTicks - ticks from now, 0 fires at the next poll()
+ */
+void TimerWheel::schedule(WheelTimer& timer, uint32_t delayTicks)
+{
+    cancel(timer);
+
+    timer.expiryTick = current_ + delayTicks;
+    place(timer);
+}
+
+/**
+ * @brief Arm a timer at an absolute micros() time
+ *
+ * @details The deadline is rounded up to the first tick at or after it, so chained deadlines
+ * keep their exact us reference and only the firing is quantized.
+ *
+ * @param timer - timer to arm
+ * @param deadlineUs - micros() timestamp
+ */
+void TimerWheel::scheduleAtUs(WheelTimer& timer, unsigned long deadlineUs)
+{
+    long ahead = (long)(deadlineUs - baseUs_);
+    uint32_t ticks = (ahead > 0) ? ((uint32_t)ahead + tickUs_ - 1) / tickUs_ : 0;
+
+    schedule(timer, ticks);
+}
+
+/**
+ * @brief Disarm a timer
+ *
+ * @param timer - timer to unlink (nothing happens if it is not armed)
+ */
+void TimerWheel::cancel(WheelTimer& timer)
+{
+    if (timer.pprev == nullptr) return;
+
+    *timer.pprev = timer.next;
+    if (timer.next != nullptr) timer.next->pprev = timer.pprev;
+
+    timer.next = nullptr;
+    timer.pprev = nullptr;
+}
+
+/**
+ * @brief Get the next tick to run
+ *
+ * @return uint32_t - tick counter (wraps after 2^32 ticks)
+ */
+uint32_t TimerWheel::now() const
+{
+    return current_;
+}
+
+/**
+ * @brief Get the length of a tick
+ *
+ * @return uint32_t - us
+ */
+uint32_t TimerWheel::tickUs() const
+{
+    return tickUs_;
+}
+
+/**
+ * @brief Link a timer in its slot
+ *
+ * @details The level is the first one whose range covers the distance to the expiry, the slot
+ * is given by the expiry bits of that level. Expired timers go to the slot run next.
+ *
+ * @param timer - timer to link (not in any list)
+ */
+void TimerWheel::place(WheelTimer& timer)
+{
+    int32_t ahead = (int32_t)(timer.expiryTick - current_);
+    if (ahead < 0)
+    {
+        timer.expiryTick = current_;
+        ahead = 0;
+    }
+
+    uint8_t level = 0;
+    while (level < LEVELS - 1 && (uint32_t)ahead >= ((uint32_t)SLOTS << (level * SLOT_BITS))) ++level;
+
+    uint8_t slot;
+    if ((uint32_t)ahead >= ((uint32_t)SLOTS << (level * SLOT_BITS)) && level == LEVELS - 1)
+    {
+        // Past the horizon: wait in the slot cascaded last, it is placed again from there
+        slot = (uint8_t)(((current_ >> (level * SLOT_BITS)) - 1) & (SLOTS - 1));
+    }
+    else
+    {
+        slot = (timer.expiryTick >> (level * SLOT_BITS)) & (SLOTS - 1);
+    }
+
+    WheelTimer*& head = slots_[level][slot];
+    timer.next = head;
+    timer.pprev = &head;
+    if (head != nullptr) head->pprev = &timer.next;
+    head = &timer;
+}
+
+/**
+ * @brief Run the tick current_
+ *
+ * @details
+ *  1. When the low bits roll over, the matching slot of the next level comes down one level
+ *     (and so on up the levels)
+ *  2. Every timer in the level 0 slot of this tick fires. It is unlinked before its callback,
+ *     so the callback can schedule it again
+ */
+void TimerWheel::runTick()
+{
+    // 1. Cascade
+    for (uint8_t level = 1; level < LEVELS; ++level)
+    {
+        if ((current_ & ((1UL << (level * SLOT_BITS)) - 1)) != 0) break;
+        cascade(level);
+    }
+
+    // 2. Fire
+    WheelTimer*& head = slots_[0][current_ & (SLOTS - 1)];
+    while (head != nullptr)
+    {
+        WheelTimer* timer = head;
+        cancel(*timer);
+
+        if (timer->callback != nullptr) timer->callback(timer->context);
+    }
+}
+
+/**
+ * @brief Move the timers of the current slot of a level to the lower levels
+ *
+ * @param level - level to cascade (1..LEVELS-1)
+ */
+void TimerWheel::cascade(uint8_t level)
+{
+    WheelTimer*& head = slots_[level][(current_ >> (level * SLOT_BITS)) & (SLOTS - 1)];
+    WheelTimer* timer = head;
+    head = nullptr;
+
+    while (timer != nullptr)
+    {
+        WheelTimer* next = timer->next;
+        place(*timer);
+        timer = next;
+    }
+}
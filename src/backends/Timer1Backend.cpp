@@ -0,0 +1,293 @@
+#include "backends/Timer1Backend.h"
+
+namespace
+{
+    constexpr uint32_t CYCLES_PER_US = F_CPU / 1000000UL;
+
+    // Timer1 prescalers, index + 1 = CS1x bits
+    constexpr uint16_t PRESCALERS[] = {1, 8, 64, 256, 1024};
+    constexpr uint8_t PRESCALER_COUNT = sizeof(PRESCALERS) / sizeof(PRESCALERS[0]);
+}
+
+/**
+ * @brief Compute the timer setting of a step
+ *
+ * @details
+ *  1. Tone: smallest prescaler N where OCR = F_CPU / (2 * N * f) - 1 fits in 16 bits (best
+ *     frequency resolution). Rest: fixed REST_TICK_HZ compare rate, output disconnected
+ *  2. Matches = duration / match length, rounded to whole wave periods for a tone. What the
+ *     rounding adds or removes is carried to the next step, so over a melody the error stays
+ *     under one match instead of adding up
+ *
+ * @param freqHz - frequency of the tone, 0 for a rest
+ * @param durationUs - real duration of the step
+ * @param carryCycles - rounding error carried between steps (nullptr: none)
+ * @return timer1::Timing
+ */
+timer1::Timing timer1::timingFor(uint16_t freqHz, uint32_t durationUs, int32_t* carryCycles)
+{
+    Timing timing;
+
+    // 1. Compare rate
+    if (freqHz == 0)
+    {
+        timing.csBits = 2;                                              // N = 8
+        timing.ocr = (uint16_t)(F_CPU / (8UL * REST_TICK_HZ) - 1);
+        timing.toggle = false;
+    }
+    else
+    {
+        uint8_t i = 0;
+        uint32_t ticks = (F_CPU + freqHz) / (2UL * freqHz);             // rounded, N = 1
+        while (ticks > 0x10000UL && i + 1 < PRESCALER_COUNT)
+        {
+            ++i;
+            ticks = (F_CPU / PRESCALERS[i] + freqHz) / (2UL * freqHz);
+        }
+        if (ticks > 0x10000UL) ticks = 0x10000UL;
+        if (ticks < 2) ticks = 2;
+
+        timing.csBits = i + 1;
+        timing.ocr = (uint16_t)(ticks - 1);
+        timing.toggle = true;
+    }
+
+    // 2. Length in matches (durationUs * CYCLES_PER_US fits in 31 bits up to ~134 s at 16 MHz)
+    uint32_t perMatch = cyclesPerMatch(timing);
+    int32_t target = (int32_t)(durationUs * CYCLES_PER_US) + (carryCycles ? *carryCycles : 0);
+    uint32_t cycles = (target > 0) ? (uint32_t)target : 0;
+
+    if (timing.toggle)
+    {
+        uint32_t periods = (cycles + perMatch) / (2UL * perMatch);     // rounded
+        timing.matches = (periods > 0) ? periods * 2 : 2;
+    }
+    else
+    {
+        uint32_t matches = (cycles + perMatch / 2) / perMatch;
+        timing.matches = (matches > 0) ? matches : 1;
+    }
+
+    if (carryCycles) *carryCycles = target - (int32_t)(timing.matches * perMatch);
+
+    return timing;
+}
+
+/**
+ * @brief CPU cycles between two compare matches
+ *
+ * @param timing - timer setting
+ * @return uint32_t - N * (OCR1A + 1)
+ */
+uint32_t timer1::cyclesPerMatch(const Timing& timing)
+{
+    return (uint32_t)PRESCALERS[timing.csBits - 1] * ((uint32_t)timing.ocr + 1);
+}
+
+
+#if defined(__AVR__) && defined(OCR1A) && defined(TIMSK1) && defined(BUZZER_USE_TIMER1)
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+    #define TIMER1_OC1A_PIN 11
+#else
+    #define TIMER1_OC1A_PIN 9
+#endif
+
+timer1::Timing Timer1Backend::window_[Timer1Backend::BATCH_WINDOW];
+volatile uint8_t Timer1Backend::head_ = 0;
+volatile uint8_t Timer1Backend::count_ = 0;
+volatile uint8_t Timer1Backend::completed_ = 0;
+volatile uint32_t Timer1Backend::remaining_ = 0;
+volatile bool Timer1Backend::endless_ = false;
+int32_t Timer1Backend::carryCycles_ = 0;
+
+constexpr uint8_t Timer1Backend::BATCH_WINDOW;
+
+ISR(TIMER1_COMPA_vect)
+{
+    Timer1Backend::onCompareMatch();
+}
+
+/**
+ * @brief Config the OC1A pin as OUTPUT and stop the timer
+ */
+void Timer1Backend::begin()
+{
+    pinMode(TIMER1_OC1A_PIN, OUTPUT);
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        halt();
+    }
+}
+
+/**
+ * @brief Play a continuous tone (plain backend use)
+ *
+ * @param frequencyHz - frequency of the wave
+ */
+void Timer1Backend::start(uint16_t frequencyHz)
+{
+    timer1::Timing timing = timer1::timingFor(frequencyHz, 0);
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        halt();
+        endless_ = true;
+        load(timing);
+    }
+}
+
+/**
+ * @brief Silence and drop the scheduled steps
+ */
+void Timer1Backend::stop()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        halt();
+    }
+}
+
+/**
+ * @brief Get how many steps can still be pushed
+ *
+ * @return uint8_t
+ */
+uint8_t Timer1Backend::freeSlots() const
+{
+    return BATCH_WINDOW - count_;
+}
+
+/**
+ * @brief Schedule a step after the ones already pushed
+ *
+ * @details The timer setting is computed here, the ISR only copies it to the registers.
+ *
+ * @param step - frequency (0 = rest) and real duration
+ */
+void Timer1Backend::push(const BatchStep& step)
+{
+    if (count_ == BATCH_WINDOW) return;
+    if (count_ == 0) carryCycles_ = 0;                  // new sequence: nothing to catch up
+
+    timer1::Timing timing = timer1::timingFor(step.freqHz, step.durationUs, &carryCycles_);
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (endless_) halt();
+
+        uint8_t tail = head_ + count_;
+        if (tail >= BATCH_WINDOW) tail -= BATCH_WINDOW;
+        window_[tail] = timing;
+
+        // Idle: the step starts now
+        if (count_++ == 0)
+        {
+            remaining_ = timing.matches;
+            load(timing);
+        }
+    }
+}
+
+/**
+ * @brief Get the steps finished since the last call
+ *
+ * @return uint8_t
+ */
+uint8_t Timer1Backend::takeCompleted()
+{
+    uint8_t done;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        done = completed_;
+        completed_ = 0;
+    }
+
+    return done;
+}
+
+/**
+ * @brief Get how long the current step has been playing
+ *
+ * @return uint32_t - us, 0 when idle
+ */
+uint32_t Timer1Backend::elapsedUs() const
+{
+    uint32_t cycles = 0;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (count_ > 0)
+        {
+            const timer1::Timing& timing = window_[head_];
+            cycles = (timing.matches - remaining_) * timer1::cyclesPerMatch(timing)
+                   + (uint32_t)TCNT1 * PRESCALERS[timing.csBits - 1];
+        }
+    }
+
+    return cycles / CYCLES_PER_US;
+}
+
+/**
+ * @brief Count one compare match, move to the next step when the current one is over
+ *
+ * @details TCNT1 was just cleared by the match (CTC), so the next step starts on the exact
+ * cycle the previous one ended: loading it costs no time of either step.
+ */
+void Timer1Backend::onCompareMatch()
+{
+    if (endless_ || count_ == 0) return;
+    if (--remaining_ != 0) return;
+
+    // Step over
+    ++completed_;
+    if (++head_ == BATCH_WINDOW) head_ = 0;
+
+    if (--count_ == 0)
+    {
+        halt();                         // window ran dry: silence until the next push
+        return;
+    }
+
+    remaining_ = window_[head_].matches;
+    load(window_[head_]);
+}
+
+/**
+ * @brief Program Timer1 for a step
+ *
+ * @param timing - compare value, prescaler and output mode
+ */
+void Timer1Backend::load(const timer1::Timing& timing)
+{
+    OCR1A = timing.ocr;
+    TCCR1A = timing.toggle ? _BV(COM1A0) : 0;           // toggle OC1A on match, or pin back to PORT(low)
+    TCCR1B = _BV(WGM12) | timing.csBits;                // CTC on OCR1A
+    TIMSK1 |= _BV(OCIE1A);
+}
+
+/**
+ * @brief Stop Timer1, disconnect OC1A (pin low) and drop the window
+ */
+void Timer1Backend::halt()
+{
+    TIMSK1 &= ~_BV(OCIE1A);
+    TCCR1B = 0;
+    TCCR1A = 0;
+    TCNT1 = 0;
+    TIFR1 = _BV(OCF1A);
+    digitalWrite(TIMER1_OC1A_PIN, LOW);
+
+    head_ = 0;
+    count_ = 0;
+    remaining_ = 0;
+    endless_ = false;
+}
+
+#endif
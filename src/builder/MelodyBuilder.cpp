@@ -117,7 +117,7 @@ MelodyBuilder& MelodyBuilder::appendScore(const score::ScoreNote *score, size_t
 */
 MelodyBuilder& MelodyBuilder::appendScore(score::ScoreView view)
 {
-    appendScore(view.data, view.count);
+    return appendScore(view.data, view.count);
 }
 
 
@@ -156,16 +156,9 @@ MelodyBuilder &MelodyBuilder::addNote(uint16_t hz,uint8_t denom)
     uint32_t playMs = durationMs;
     uint32_t restMs = 0;
 
-    // if there is a gap between notes, add it to the duration
-    if(hz>0 && ctx_.gapMs > 0 && playMs > MelodyContext::MIN_PLAY_MS)
-    {
-        // 1. compute the max gap allow so the tone is audible
-        uint32_t maxGap = playMs - MelodyContext::MIN_PLAY_MS;      
-
-        // 2. clamp the restMs to the maxGap if the requested gap is too large
-        restMs = (ctx_.gapMs > maxGap) ? maxGap : ctx_.gapMs;
-        playMs -= restMs;
-    }
+    // if there is a gap between notes, cut it from the end of the note (clamped so the tone is audible)
+    restMs = timing::articulationGapMs(durationMs, ctx_.gapMs);
+    playMs -= restMs;
 
     // if there is a gap to leave we split the note into play + rest
     pushStep_(hz, playMs);                  // Push the step to the melody buffer
@@ -238,6 +231,28 @@ Melody MelodyBuilder::build() const
     return Melody{buffer_, length_};
 }
 
+/**
+ * @brief Build a melody with the steps added since a mark
+ * 
+ * @details
+ * Lets several phrases share one buffer: take a mark with size() before composing a phrase,
+ * then buildFrom(mark) returns a Melody that only views that phrase.
+ * 
+ * Example usage:
+ * size_t mark = builder.size();
+ * builder.addNote(notes::G5, durations::Quarter).addNote(notes::D5, durations::Quarter);
+ * Melody phraseA = builder.buildFrom(mark);
+ * 
+ * @param firstStep - index of the first step of the melody (a previous size())
+ * @return Melody - view over [firstStep, size()), empty if firstStep is past the end
+ */
+Melody MelodyBuilder::buildFrom(size_t firstStep) const
+{
+    if (firstStep >= length_) return Melody{buffer_ + length_, 0};
+
+    return Melody{buffer_ + firstStep, length_ - firstStep};
+}
+
 /**
  * @brief Check if the builder did not overflow it's capacity so more Steps can be added
  * 
@@ -322,13 +337,8 @@ uint32_t MelodyBuilder::denomToMs_(uint8_t denom, uint16_t bpm)
         return 0;
     }
 
-    const uint32_t numerator = 60000UL * 4UL;                 // 240000
-    const uint32_t divisor   = (uint32_t)bpm * (uint32_t)denom;
-
-    uint32_t noteMs = numerator / divisor;  // note_durationMs = (60000 / BPM) * (4 / denom)
-
-    // never return 0ms (avoids zero-length steps at high BPM / small notes)
-    if (noteMs == 0) noteMs = 1;
+    // note_durationMs = (60000 / BPM) * (4 / denom), never 0ms
+    uint32_t noteMs = timing::denomToMs(denom, bpm);
 
     LOGD("denomToMs bpm=%u denom=%u -> %lu", bpm, denom, (unsigned long)noteMs);
 
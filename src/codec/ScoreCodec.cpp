@@ -0,0 +1,298 @@
+#include "codec/ScoreCodec.h"
+#include "music/Pitch.h"
+#include "core/Progmem.h"
+#include "core/Eeprom.h"
+
+namespace codec {
+
+    namespace {
+
+        /**
+         * @brief Packs fields MSB first into a byte buffer, remembering overflow
+         */
+        class BitWriter
+        {
+            public:
+
+            BitWriter(uint8_t* out, size_t capacity):
+            out_(out), capacity_(capacity), length_(0), bitsUsed_(8), ok_(true)
+            {}
+
+            void put(uint16_t value, uint8_t bits)
+            {
+                while (bits-- > 0)
+                {
+                    // open a new byte when the current one is full
+                    if (bitsUsed_ == 8)
+                    {
+                        if (length_ >= capacity_) { ok_ = false; return; }
+                        out_[length_++] = 0;
+                        bitsUsed_ = 0;
+                    }
+
+                    if ((value >> bits) & 0x01) out_[length_ - 1] |= (uint8_t)(0x80 >> bitsUsed_);
+                    ++bitsUsed_;
+                }
+            }
+
+            size_t length() const { return ok_ ? length_ : 0; }
+
+            private:
+
+            uint8_t* out_;
+            size_t capacity_;
+            size_t length_;
+            uint8_t bitsUsed_;
+            bool ok_;
+        };
+
+        /// @brief Duration code of a power of two denom, DENOM_CODE_RAW otherwise
+        uint8_t denomCode(uint8_t denom)
+        {
+            for (uint8_t code = 0; code < DENOM_CODE_RAW; ++code)
+            {
+                if (denom == (1 << code)) return code;
+            }
+            return DENOM_CODE_RAW;
+        }
+
+    } // namespace
+
+    /**
+     * @brief Encode a score with the format described in ScoreCodec.h
+     * 
+     * @param notes - notes to encode
+     * @param count - number of notes
+     * @param out - output buffer
+     * @param capacity - size of the output buffer in bytes
+     * @return size_t - bytes written, 0 if the output buffer is too small
+     */
+    size_t encodeScore(const score::ScoreNote* notes, uint16_t count, uint8_t* out, size_t capacity)
+    {
+        // Validate input
+        if ((notes == nullptr && count > 0) || out == nullptr || count > MAX_NOTES || capacity < MAX_HEADER_SIZE) return 0;
+
+        // 1. Header: note count, 1 byte for short scores
+        uint8_t headerSize = 1;
+        if (count < 0x80)
+        {
+            out[0] = (uint8_t)count;
+        }
+        else
+        {
+            out[0] = (uint8_t)(0x80 | (count & 0x7F));
+            out[1] = (uint8_t)(count >> 7);
+            headerSize = 2;
+        }
+
+        BitWriter writer(out + headerSize, capacity - headerSize);
+        uint8_t prevIndex = pitch::A4_INDEX;
+        uint8_t prevDenom = 0;      // no previous rhythm
+
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            const score::ScoreNote& note = notes[i];
+
+            // 2. Rhythm: 1 bit when it repeats
+            if (note.denom == prevDenom && i > 0)
+            {
+                writer.put(0, 1);
+            }
+            else
+            {
+                uint8_t code = denomCode(note.denom);
+                writer.put(1, 1);
+                writer.put(code, DENOM_CODE_BITS);
+                if (code == DENOM_CODE_RAW) writer.put(note.denom, 8);
+                prevDenom = note.denom;
+            }
+
+            // 3. Pitch: rest, small delta, absolute index or raw Hz
+            if (note.hz == 0)
+            {
+                writer.put(0x02, 2);
+                continue;
+            }
+
+            uint8_t index = pitch::fromHz(note.hz);
+            int16_t delta = (int16_t)index - (int16_t)prevIndex;
+
+            if (index != pitch::NONE && delta >= DELTA_MIN && delta <= DELTA_MAX)
+            {
+                writer.put(0, 1);
+                writer.put((uint16_t)(delta & 0x0F), DELTA_BITS);
+                prevIndex = index;
+            }
+            else if (index != pitch::NONE)
+            {
+                writer.put(0x03, 2);
+                writer.put(index, INDEX_BITS);
+                prevIndex = index;
+            }
+            else
+            {
+                writer.put(0x03, 2);
+                writer.put(INDEX_RAW_HZ, INDEX_BITS);
+                writer.put(note.hz, 16);
+            }
+        }
+
+        size_t bodyLength = writer.length();
+        if (bodyLength == 0 && count > 0) return 0;     // overflow
+
+        return headerSize + bodyLength;
+    }
+
+
+    /**
+     * @brief Construct a new Score Decoder
+     * 
+     * @param data - encoded score (header included)
+     * @param space - memory where data lives
+     */
+    ScoreDecoder::ScoreDecoder(const uint8_t* data, MemorySpace space):
+    data_(data),
+    space_(space),
+    count_(0),
+    headerSize_(1),
+    remaining_(0),
+    offset_(0),
+    byte_(0),
+    bitsLeft_(0),
+    prevIndex_(pitch::A4_INDEX),
+    prevDenom_(0)
+    {
+        // Header: note count
+        if (data_ != nullptr)
+        {
+            count_ = fetch_(0);
+            if (count_ & 0x80)
+            {
+                count_ = (count_ & 0x7F) | ((uint16_t)fetch_(1) << 7);
+                headerSize_ = 2;
+            }
+        }
+
+        rewind();
+    }
+
+    /**
+     * @brief Go back to the first note
+     */
+    void ScoreDecoder::rewind()
+    {
+        remaining_ = count_;
+        offset_ = headerSize_;
+        bitsLeft_ = 0;
+        prevIndex_ = pitch::A4_INDEX;
+        prevDenom_ = 0;
+    }
+
+    /**
+     * @brief Decode the next note
+     * 
+     * @details Cost per note: 1..4 bits of rhythm and 2..25 bits of pitch, at most 5 bytes fetched
+     * 
+     * @param note - output note
+     * @return true - a note was decoded
+     * @return false - end of the score
+     */
+    bool ScoreDecoder::next(score::ScoreNote& note)
+    {
+        if (remaining_ == 0) return false;
+        --remaining_;
+
+        // 1. Rhythm
+        if (readBits_(1))
+        {
+            uint8_t code = (uint8_t)readBits_(DENOM_CODE_BITS);
+            prevDenom_ = (code == DENOM_CODE_RAW) ? (uint8_t)readBits_(8) : (uint8_t)(1 << code);
+        }
+        note.denom = prevDenom_;
+
+        // 2. Pitch
+        if (readBits_(1) == 0)
+        {
+            // sign extend the 4 bits delta
+            int8_t delta = (int8_t)readBits_(DELTA_BITS);
+            if (delta & 0x08) delta -= 16;
+
+            prevIndex_ = (uint8_t)(prevIndex_ + delta);
+            note.hz = pitch::toHz(prevIndex_);
+        }
+        else if (readBits_(1) == 0)
+        {
+            note.hz = 0;    // rest
+        }
+        else
+        {
+            uint8_t index = (uint8_t)readBits_(INDEX_BITS);
+            if (index == INDEX_RAW_HZ)
+            {
+                note.hz = readBits_(16);
+            }
+            else
+            {
+                prevIndex_ = index;
+                note.hz = pitch::toHz(index);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Get the number of notes in the encoded score
+     * 
+     * @return uint16_t 
+     */
+    uint16_t ScoreDecoder::count() const
+    {
+        return count_;
+    }
+
+    //////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+    /**
+     * @brief Read one encoded byte from its memory space
+     * 
+     * @param offset - byte offset from the start of the encoded score
+     * @return uint8_t 
+     */
+    uint8_t ScoreDecoder::fetch_(uint16_t offset) const
+    {
+        switch (space_)
+        {
+            case MemorySpace::Flash:    return pgm_read_byte(data_ + offset);
+            case MemorySpace::Eeprom:   return eeprom::readByte((uint16_t)(reinterpret_cast<uintptr_t>(data_) + offset));
+            case MemorySpace::Ram:
+            default:                    return data_[offset];
+        }
+    }
+
+    /**
+     * @brief Read the next bits of the stream, MSB first
+     * 
+     * @param bits - number of bits to read (1..16)
+     * @return uint16_t - value right aligned
+     */
+    uint16_t ScoreDecoder::readBits_(uint8_t bits)
+    {
+        uint16_t value = 0;
+
+        while (bits-- > 0)
+        {
+            if (bitsLeft_ == 0)
+            {
+                byte_ = fetch_(offset_++);
+                bitsLeft_ = 8;
+            }
+
+            --bitsLeft_;
+            value = (uint16_t)((value << 1) | ((byte_ >> bitsLeft_) & 0x01));
+        }
+
+        return value;
+    }
+
+} // namespace codec
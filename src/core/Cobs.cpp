@@ -0,0 +1,167 @@
+#include "core/Cobs.h"
+
+namespace cobs
+{
+    /**
+     * @brief Construct a new Encoder, the code of the first block is reserved
+     *
+     * @param out - output buffer
+     * @param capacity - its size
+     */
+    Encoder::Encoder(uint8_t* out, size_t capacity):
+    out_(out),
+    capacity_(out != nullptr ? capacity : 0),
+    length_(1),
+    codeIndex_(0),
+    code_(1),
+    ok_(capacity_ > 0)
+    {}
+
+    /**
+     * @brief Encode one byte
+     *
+     * @details A zero ends the block (its code says where the zero was). A block of 254 data
+     * bytes ends too, with code 0xFF that stands for no zero.
+     *
+     * @param byte - byte of the frame
+     */
+    void Encoder::put(uint8_t byte)
+    {
+        if (byte == 0)
+        {
+            closeBlock_();
+            return;
+        }
+
+        if (length_ < capacity_) out_[length_] = byte;
+        else ok_ = false;
+        ++length_;
+
+        if (++code_ == 0xFF) closeBlock_();
+    }
+
+    /**
+     * @brief Close the last block
+     *
+     * @return size_t - encoded length, 0 on overflow
+     */
+    size_t Encoder::finish()
+    {
+        if (ok_) out_[codeIndex_] = code_;
+        return ok_ ? length_ : 0;
+    }
+
+    /**
+     * @brief Write the code of the current block and reserve the next one
+     */
+    void Encoder::closeBlock_()
+    {
+        if (codeIndex_ < capacity_) out_[codeIndex_] = code_;
+
+        codeIndex_ = length_++;
+        code_ = 1;
+        if (length_ > capacity_) ok_ = false;
+    }
+
+    /**
+     * @brief Construct a new Decoder
+     */
+    Decoder::Decoder():
+    remaining_(0),
+    code_(0xFF),
+    started_(false)
+    {}
+
+    /**
+     * @brief Start a new frame
+     */
+    void Decoder::reset()
+    {
+        remaining_ = 0;
+        code_ = 0xFF;
+        started_ = false;
+    }
+
+    /**
+     * @brief Decode one encoded byte
+     *
+     * @details
+     * A block code announces code - 1 data bytes followed by a zero, except for code 0xFF and the
+     * last block of the frame. The zero is produced when the next code arrives, so the one at the
+     * end of the frame is never produced.
+     *
+     * @param in - encoded byte
+     * @param out - decoded byte
+     * @return true - out holds a decoded byte
+     */
+    bool Decoder::push(uint8_t in, uint8_t& out)
+    {
+        // Data byte of the current block
+        if (remaining_ > 0)
+        {
+            --remaining_;
+            out = in;
+            return true;
+        }
+
+        // Block code: the previous block ended with a zero unless it was a full one
+        bool zero = started_ && code_ != 0xFF;
+        code_ = in;
+        remaining_ = in - 1;
+        started_ = true;
+
+        if (zero) out = 0;
+        return zero;
+    }
+
+    /**
+     * @brief Check if the frame can end here
+     *
+     * @return true - every announced byte arrived
+     */
+    bool Decoder::isComplete() const
+    {
+        return started_ && remaining_ == 0;
+    }
+
+    /**
+     * @brief Encode a whole buffer
+     *
+     * @param data - bytes to encode
+     * @param length - their count
+     * @param out - output buffer
+     * @param capacity - its size
+     * @return size_t - encoded length, 0 if out is too small
+     */
+    size_t encode(const uint8_t* data, size_t length, uint8_t* out, size_t capacity)
+    {
+        Encoder encoder(out, capacity);
+        for (size_t i = 0; i < length; ++i) encoder.put(data[i]);
+        return encoder.finish();
+    }
+
+    /**
+     * @brief Decode a whole frame
+     *
+     * @param data - encoded bytes, delimiters excluded
+     * @param length - their count
+     * @param out - output buffer
+     * @param capacity - its size
+     * @return size_t - decoded length, 0 if malformed or out is too small
+     */
+    size_t decode(const uint8_t* data, size_t length, uint8_t* out, size_t capacity)
+    {
+        Decoder decoder;
+        size_t decoded = 0;
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            uint8_t byte;
+            if (data[i] == 0) return 0;
+            if (!decoder.push(data[i], byte)) continue;
+            if (decoded >= capacity) return 0;
+            out[decoded++] = byte;
+        }
+        return decoder.isComplete() ? decoded : 0;
+    }
+}
@@ -0,0 +1,50 @@
+#include "core/Eeprom.h"
+
+#if !defined(__AVR__)
+
+namespace
+{
+    struct EmulatedEeprom
+    {
+        uint8_t bytes[eeprom::SIZE];
+        uint32_t writes[eeprom::SIZE];
+
+        EmulatedEeprom()
+        {
+            for (uint16_t i = 0; i < eeprom::SIZE; ++i)
+            {
+                bytes[i] = 0xFF;        // erased
+                writes[i] = 0;
+            }
+        }
+    };
+
+    EmulatedEeprom& memory()
+    {
+        static EmulatedEeprom instance;
+        return instance;
+    }
+}
+
+namespace eeprom
+{
+    uint8_t readByte(uint16_t address)
+    {
+        return (address < SIZE) ? memory().bytes[address] : 0xFF;
+    }
+
+    void updateByte(uint16_t address, uint8_t value)
+    {
+        if (address >= SIZE || memory().bytes[address] == value) return;
+
+        memory().bytes[address] = value;
+        ++memory().writes[address];
+    }
+
+    uint32_t writeCount(uint16_t address)
+    {
+        return (address < SIZE) ? memory().writes[address] : 0;
+    }
+}
+
+#endif
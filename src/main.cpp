@@ -27,6 +27,8 @@
 #include "builder/MelodyBuilder.h"        // DataModel layer: To generate a melody the player can execute
 #include "core/Types.h"                   // What the player actually. Sheet music notes in the digital realm
 #include "player/BuzzerPlayer.h"          // Engine class( Schedule + Presets)
+#include "sources/CompressedScoreSource.h" // Compressed scores decoded while playing
+#include "sources/ArrangementSource.h"    // Songs as phrase references(AABA...)
 #include "presetTones/Presets.h"          // Preset stored tones( success, warning, error ...)
 #include "logger/Logger.h"                // For debugging 
 #include "../lib/avr_algorithms.h"
@@ -66,7 +68,7 @@ A) Uncomment this block to Play a preset Score sequence(recommended for common U
  melody = builder.clearMelody(true)
     .setTempo(120)
     .gap(20)
-    .appendScore(presets::getPresetById(PresetId::Startup))
+    .appendScore(presets::getPreset<PresetId::Startup>())
     .build(); 
 
 */
@@ -139,6 +141,54 @@ melody = builder.clearMelody(true)
   .build();
 */
 
+/////////////////////////////////////////////////////////////
+
+// ---  OPTION D: Stream a compressed score from flash(no Step buffer needed)
+/*
+// Bytes generated on the host with tools/scorepack (here: presets::success())
+static const uint8_t PACKED_SUCCESS[] PROGMEM = {
+    0x04, 0xB1, 0x89, 0x43, 0x92, 0x80
+};
+MelodyContext packedCtx;
+packedCtx.bpm = 120;
+packedCtx.gapMs = 20;
+static CompressedScoreSource packedSuccess(PACKED_SUCCESS, packedCtx);
+
+player.play(packedSuccess);
+return;
+*/
+
+/////////////////////////////////////////////////////////////
+
+// ---  OPTION E: Arrangement(AABA) of phrases stored once
+/*
+builder.clearMelody(true).setTempo(76).gap(15);
+
+size_t mark = builder.size();
+builder.addNote(notes::G5, durations::Quarter)
+  .addNote(notes::D5, durations::Quarter)
+  .addNote(notes::B5, durations::Quarter);
+static Melody phraseA = builder.buildFrom(mark);
+
+mark = builder.size();
+builder.addNote(notes::D5, durations::Eighth)
+  .addNote(notes::C5, durations::Eighth)
+  .addNote(notes::B5, durations::Eighth)
+  .addNote(notes::A5, durations::Eighth)
+  .addNote(notes::G5, durations::Half);
+static Melody phraseB = builder.buildFrom(mark);
+
+static const PhraseRef songRefs[] = {
+  {&phraseA, 2, 0},     // A A
+  {&phraseB, 1, 0},     // B
+  {&phraseA, 1, 5}      // A, a fourth up
+};
+static ArrangementSource song(Arrangement{songRefs, sizeof(songRefs) / sizeof(songRefs[0])});
+
+player.play(song, true);
+return;
+*/
+
 /////////////////////////////////////////////////////////////
  
  //  Play the melody created for the builder
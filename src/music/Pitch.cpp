@@ -0,0 +1,113 @@
+#include "music/Pitch.h"
+#include "music/Notes.h"
+#include "core/Progmem.h"
+
+namespace pitch {
+
+    // Chromatic frequency table: one row per octave, C..B
+    static const uint16_t PITCH_TABLE[COUNT] PROGMEM = {
+        notes::C0, notes::Cs0_Db0, notes::D0, notes::Ds0_Eb0, notes::E0, notes::F0, notes::Fs0_Gb0, notes::G0, notes::Gs0_Ab0, notes::A0, notes::As0_Bb0, notes::B0_,
+        notes::C1, notes::Cs1_Db1, notes::D1, notes::Ds1_Eb1, notes::E1, notes::F1, notes::Fs1_Gb1, notes::G1, notes::Gs1_Ab1, notes::A1, notes::As1_Bb1, notes::B1_,
+        notes::C2, notes::Cs2_Db2, notes::D2, notes::Ds2_Eb2, notes::E2, notes::F2, notes::Fs2_Gb2, notes::G2, notes::Gs2_Ab2, notes::A2, notes::As2_Bb2, notes::B2,
+        notes::C3, notes::Cs3_Db3, notes::D3, notes::Ds3_Eb3, notes::E3, notes::F3, notes::Fs3_Gb3, notes::G3, notes::Gs3_Ab3, notes::A3, notes::As3_Bb3, notes::B3,
+        notes::C4, notes::Cs4_Db4, notes::D4, notes::Ds4_Eb4, notes::E4, notes::F4, notes::Fs4_Gb4, notes::G4, notes::Gs4_Ab4, notes::A4, notes::As4_Bb4, notes::B4,
+        notes::C5, notes::Cs5_Db5, notes::D5, notes::Ds5_Eb5, notes::E5, notes::F5, notes::Fs5_Gb5, notes::G5, notes::Gs5_Ab5, notes::A5, notes::As5_Bb5, notes::B5,
+        notes::C6, notes::Cs6_Db6, notes::D6, notes::Ds6_Eb6, notes::E6, notes::F6, notes::Fs6_Gb6, notes::G6, notes::Gs6_Ab6, notes::A6, notes::As6_Bb6, notes::B6,
+        notes::C7, notes::Cs7_Db7, notes::D7, notes::Ds7_Eb7, notes::E7, notes::F7, notes::Fs7_Gb7, notes::G7, notes::Gs7_Ab7, notes::A7, notes::As7_Bb7, notes::B7,
+        notes::C8, notes::Cs8_Db8, notes::D8, notes::Ds8_Eb8, notes::E8, notes::F8, notes::Fs8_Gb8, notes::G8, notes::Gs8_Ab8, notes::A8, notes::As8_Bb8, notes::B8,
+    };
+
+    /**
+     * @brief Frequency in Hz of a chromatic index
+     * 
+     * @param index - chromatic index (C0 = 0)
+     * @return uint16_t - Frequency in Hz, 0 if out of range
+     */
+    uint16_t toHz(uint8_t index)
+    {
+        if (index >= COUNT) return notes::REST;
+
+        return pgm_read_word(&PITCH_TABLE[index]);
+    }
+
+    /**
+     * @brief Chromatic index of a frequency
+     * 
+     * @details The table is sorted in ascending frequency, so a binary search finds the
+     * index in at most 7 reads from flash.
+     * 
+     * @param hz - Frequency in Hz
+     * @return uint8_t - chromatic index, NONE if the frequency is not in the table
+     */
+    uint8_t fromHz(uint16_t hz)
+    {
+        uint8_t low  = 0;
+        uint8_t high = COUNT;
+
+        while (low < high)
+        {
+            uint8_t mid = (low + high) / 2;
+            uint16_t midHz = pgm_read_word(&PITCH_TABLE[mid]);
+
+            if (midHz == hz) return mid;
+            if (midHz < hz) low = mid + 1;
+            else high = mid;
+        }
+
+        return NONE;
+    }
+
+    // 2^(n/12) for n = 0..11 in Q1.15 fixed point: one octave of equal temperament ratios
+    static const uint16_t SEMITONE_RATIO_Q15[12] PROGMEM = {
+        32768, 34716, 36781, 38968, 41285, 43740, 46341, 49097, 52016, 55109, 58386, 61858
+    };
+
+    /**
+     * @brief Shift a frequency by a number of semitones
+     * 
+     * @details
+     *  - Frequencies of the notes:: table are moved along the table, so the result is exactly the
+     *    note the score would have used.
+     *  - Any other frequency is scaled by 2^(n/12): one multiply by a Q15 ratio for the semitones
+     *    inside the octave, plus a shift per octave. No floating point.
+     * 
+     * @param hz - Frequency in Hz (0 = REST)
+     * @param semitones - interval, negative to go down
+     * @return uint16_t - transposed frequency in Hz
+     */
+    uint16_t transpose(uint16_t hz, int8_t semitones)
+    {
+        if (hz == 0 || semitones == 0) return hz;
+
+        // 1. Exact path: walk the chromatic table
+        uint8_t index = fromHz(hz);
+        int16_t target = (int16_t)index + semitones;
+        if (index != NONE && target >= 0 && target < COUNT) return toHz((uint8_t)target);
+
+        // 2. Ratio path: split the interval into octaves + semitones(0..11)
+        int8_t octaves = semitones / 12;
+        int8_t rest = semitones % 12;
+        if (rest < 0)
+        {
+            rest += 12;
+            --octaves;
+        }
+
+        uint32_t scaled = ((uint32_t)hz * pgm_read_word(&SEMITONE_RATIO_Q15[rest]) + 0x4000UL) >> 15;
+
+        if (octaves > 0)
+        {
+            scaled = (octaves >= 16) ? 0xFFFFUL : (scaled << octaves);
+        }
+        else if (octaves < 0)
+        {
+            uint8_t shift = (uint8_t)(-octaves);
+            scaled = (shift >= 17) ? 0 : ((scaled + (1UL << (shift - 1))) >> shift);
+        }
+
+        // never turn a tone into a REST, saturate on overflow
+        if (scaled == 0) scaled = 1;
+        return (scaled > 0xFFFFUL) ? 0xFFFF : (uint16_t)scaled;
+    }
+
+} // namespace pitch
@@ -0,0 +1,315 @@
+#include "player/MelodyPool.h"
+#include "logger/Logger.h"
+
+constexpr uint8_t MelodyHandle::INVALID_SLOT;
+constexpr uint8_t MelodyPool::BLOCK_STEPS;
+constexpr uint8_t MelodyPool::END_OF_CHAIN;
+
+namespace
+{
+    const MelodyHandle NULL_HANDLE = { MelodyHandle::INVALID_SLOT, 0 };
+}
+
+/**
+ * @brief Construct a new Melody Pool over application storage
+ *
+ * @details Every block goes to the free list and every slot is free.
+ *
+ * @param blocks - arena, blockCount * BLOCK_STEPS steps
+ * @param links - next block of each block
+ * @param blockCount - blocks in the arena
+ * @param slots - melody table
+ * @param slotCount - melodies the pool can hold
+ */
+MelodyPool::MelodyPool(Step* blocks, uint8_t* links, uint8_t blockCount, Slot* slots, uint8_t slotCount):
+blocks_(blocks),
+links_(links),
+blockCount_(blockCount < END_OF_CHAIN ? blockCount : END_OF_CHAIN - 1),
+slots_(slots),
+slotCount_(slotCount < MelodyHandle::INVALID_SLOT ? slotCount : MelodyHandle::INVALID_SLOT - 1),
+freeHead_(END_OF_CHAIN),
+freeBlocks_(0)
+{
+    if (blocks_ == nullptr || links_ == nullptr) blockCount_ = 0;
+    if (slots_ == nullptr) slotCount_ = 0;
+
+    for (uint8_t b = blockCount_; b > 0; --b)
+    {
+        links_[b - 1] = freeHead_;
+        freeHead_ = b - 1;
+    }
+    freeBlocks_ = blockCount_;
+
+    for (uint8_t s = 0; s < slotCount_; ++s)
+    {
+        slots_[s].count = 0;
+        slots_[s].firstBlock = END_OF_CHAIN;
+        slots_[s].refs = 0;
+        slots_[s].generation = 0;
+    }
+}
+
+/**
+ * @brief Copy a built melody into the pool
+ *
+ * @param melody - steps to copy
+ * @return MelodyHandle - one reference held by the caller, null if there is no room
+ */
+MelodyHandle MelodyPool::add(const Melody& melody)
+{
+    if (melody.steps == nullptr || melody.count == 0 || melody.count > 0xFFFF) return NULL_HANDLE;
+
+    uint8_t slot = allocate((uint16_t)melody.count);
+    if (slot == END_OF_CHAIN) return NULL_HANDLE;
+
+    // Copy block by block along the chain
+    uint8_t block = slots_[slot].firstBlock;
+    for (size_t i = 0; i < melody.count; ++i)
+    {
+        uint8_t offset = i % BLOCK_STEPS;
+        if (i > 0 && offset == 0) block = links_[block];
+        blocks_[(uint16_t)block * BLOCK_STEPS + offset] = melody.steps[i];
+    }
+
+    LOGD("pool add slot=%u steps=%u", (unsigned)slot, (unsigned)melody.count);
+    return MelodyHandle{ slot, slots_[slot].generation };
+}
+
+/**
+ * @brief Copy the steps produced by a source into the pool
+ *
+ * @details
+ * The length is not known up front: a free slot is taken, then blocks are taken from the free
+ * list as the steps come. If the arena runs out the partial chain goes back to the free list.
+ *
+ * @param source - finite source
+ * @return MelodyHandle - one reference held by the caller, null if there is no room
+ */
+MelodyHandle MelodyPool::add(IStepSource& source)
+{
+    uint8_t slot = allocate(0);
+    if (slot == END_OF_CHAIN) return NULL_HANDLE;
+
+    Slot& entry = slots_[slot];
+    uint8_t last = END_OF_CHAIN;
+    Step step;
+
+    source.rewind();
+    while (source.next(step))
+    {
+        uint8_t offset = entry.count % BLOCK_STEPS;
+        if (offset == 0)
+        {
+            // New block: out of room gives everything back
+            if (freeHead_ == END_OF_CHAIN)
+            {
+                freeChain(entry.firstBlock);
+                entry.firstBlock = END_OF_CHAIN;
+                entry.count = 0;
+                entry.refs = 0;
+                return NULL_HANDLE;
+            }
+
+            uint8_t block = freeHead_;
+            freeHead_ = links_[block];
+            --freeBlocks_;
+            links_[block] = END_OF_CHAIN;
+
+            if (last == END_OF_CHAIN) entry.firstBlock = block;
+            else links_[last] = block;
+            last = block;
+        }
+
+        blocks_[(uint16_t)last * BLOCK_STEPS + offset] = step;
+        ++entry.count;
+    }
+
+    if (entry.count == 0)
+    {
+        entry.refs = 0;
+        return NULL_HANDLE;
+    }
+
+    LOGD("pool add slot=%u steps=%u", (unsigned)slot, (unsigned)entry.count);
+    return MelodyHandle{ slot, entry.generation };
+}
+
+/**
+ * @brief Take one more reference to a melody
+ *
+ * @param handle - melody to reference
+ * @return true - referenced, release() it when done
+ * @return false - stale handle or 255 references already
+ */
+bool MelodyPool::acquire(MelodyHandle handle)
+{
+    if (!isValid(handle) || slots_[handle.slot].refs == 0xFF) return false;
+
+    ++slots_[handle.slot].refs;
+    return true;
+}
+
+/**
+ * @brief Drop a reference
+ *
+ * @details The last reference frees the blocks and bumps the generation of the slot, so every
+ * copy of the handle becomes stale. A stale handle is ignored.
+ *
+ * @param handle - melody to release
+ */
+void MelodyPool::release(MelodyHandle handle)
+{
+    if (!isValid(handle)) return;
+
+    Slot& entry = slots_[handle.slot];
+    if (--entry.refs > 0) return;
+
+    freeChain(entry.firstBlock);
+    entry.firstBlock = END_OF_CHAIN;
+    entry.count = 0;
+    ++entry.generation;
+
+    LOGD("pool free slot=%u", (unsigned)handle.slot);
+}
+
+/**
+ * @brief Check if the handle still refers to its melody
+ *
+ * @param handle - handle to check
+ * @return true - the melody is alive
+ */
+bool MelodyPool::isValid(MelodyHandle handle) const
+{
+    if (handle.slot >= slotCount_) return false;
+
+    const Slot& entry = slots_[handle.slot];
+    return entry.refs > 0 && entry.generation == handle.generation;
+}
+
+/**
+ * @brief Get the steps of a melody
+ *
+ * @param handle - melody
+ * @return uint16_t - 0 if the handle is stale
+ */
+uint16_t MelodyPool::stepCount(MelodyHandle handle) const
+{
+    return isValid(handle) ? slots_[handle.slot].count : 0;
+}
+
+/**
+ * @brief Get the references held on a melody
+ *
+ * @param handle - melody
+ * @return uint8_t - 0 if the handle is stale
+ */
+uint8_t MelodyPool::refCount(MelodyHandle handle) const
+{
+    return isValid(handle) ? slots_[handle.slot].refs : 0;
+}
+
+/**
+ * @brief Get the blocks not used by any melody
+ *
+ * @return uint8_t
+ */
+uint8_t MelodyPool::freeBlocks() const
+{
+    return freeBlocks_;
+}
+
+/**
+ * @brief Get the first block of a melody
+ *
+ * @param handle - melody
+ * @return uint8_t - END_OF_CHAIN if the handle is stale
+ */
+uint8_t MelodyPool::firstBlock(MelodyHandle handle) const
+{
+    return isValid(handle) ? slots_[handle.slot].firstBlock : END_OF_CHAIN;
+}
+
+/**
+ * @brief Get the block following a block of a chain
+ *
+ * @param block - block of a chain
+ * @return uint8_t - END_OF_CHAIN after the last one
+ */
+uint8_t MelodyPool::nextBlock(uint8_t block) const
+{
+    return (block < blockCount_) ? links_[block] : END_OF_CHAIN;
+}
+
+/**
+ * @brief Get the steps of a block
+ *
+ * @param block - block index
+ * @return const Step* - BLOCK_STEPS steps
+ */
+const Step* MelodyPool::blockSteps(uint8_t block) const
+{
+    return blocks_ + (uint16_t)block * BLOCK_STEPS;
+}
+
+//////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+/**
+ * @brief Reserve a free slot and the blocks of count steps
+ *
+ * @details
+ *  1. Check there are enough free blocks, so nothing has to be undone
+ *  2. Find a free slot
+ *  3. Move the blocks from the free list to the chain of the slot
+ *
+ * @param count - steps to hold (0: slot only, blocks are added by the caller)
+ * @return uint8_t - slot with one reference, END_OF_CHAIN if there is no room
+ */
+uint8_t MelodyPool::allocate(uint16_t count)
+{
+    // 1. Blocks
+    uint16_t needed = (count + BLOCK_STEPS - 1) / BLOCK_STEPS;
+    if (needed > freeBlocks_) return END_OF_CHAIN;
+
+    // 2. Slot
+    uint8_t slot = 0;
+    while (slot < slotCount_ && slots_[slot].refs > 0) ++slot;
+    if (slot == slotCount_) return END_OF_CHAIN;
+
+    // 3. Chain
+    Slot& entry = slots_[slot];
+    entry.count = count;
+    entry.refs = 1;
+    entry.firstBlock = END_OF_CHAIN;
+
+    uint8_t last = END_OF_CHAIN;
+    for (uint16_t i = 0; i < needed; ++i)
+    {
+        uint8_t block = freeHead_;
+        freeHead_ = links_[block];
+        links_[block] = END_OF_CHAIN;
+
+        if (last == END_OF_CHAIN) entry.firstBlock = block;
+        else links_[last] = block;
+        last = block;
+    }
+    freeBlocks_ -= needed;
+
+    return slot;
+}
+
+/**
+ * @brief Give a chain of blocks back to the free list
+ *
+ * @param block - first block of the chain (END_OF_CHAIN: nothing)
+ */
+void MelodyPool::freeChain(uint8_t block)
+{
+    while (block != END_OF_CHAIN)
+    {
+        uint8_t next = links_[block];
+        links_[block] = freeHead_;
+        freeHead_ = block;
+        ++freeBlocks_;
+        block = next;
+    }
+}
@@ -0,0 +1,271 @@
+#include "player/TempoPll.h"
+
+constexpr uint8_t TempoPll::LOCK_PULSES;
+constexpr uint8_t TempoPll::LOCK_WINDOW_SHIFT;
+constexpr uint8_t TempoPll::TIMEOUT_PERIODS;
+constexpr uint16_t TempoPll::MAX_TRIM_Q8;
+
+namespace
+{
+    constexpr uint8_t MAX_MISSED_PULSES = 8;        // later than this: start a new acquisition
+
+    /// @brief num / den in q0.16 (num < den), 32 bits only: both are shifted until den fits 16 bits
+    uint16_t fractionQ16(uint32_t num, uint32_t den)
+    {
+        while (den >= 0x10000UL)
+        {
+            num >>= 1;
+            den >>= 1;
+        }
+        return (uint16_t)((num << 16) / den);
+    }
+}
+
+/**
+ * @brief Construct a new Tempo Pll
+ *
+ * @param pulsesPerBeat - pulses in one beat
+ * @param phaseShift - phase gain shift
+ * @param freqShift - tempo gain shift
+ */
+TempoPll::TempoPll(uint8_t pulsesPerBeat, uint8_t phaseShift, uint8_t freqShift):
+pulsesPerBeat_(pulsesPerBeat > 0 ? pulsesPerBeat : 1),
+phaseShift_(phaseShift),
+freqShift_(freqShift),
+pulseCount_(0),
+inWindow_(0),
+locked_(false),
+periodQ8_(0),
+lastPulseUs_(0),
+nextUs_(0),
+beatUs0_(0),
+pulseInBeat_(0),
+lastErrorUs_(0),
+slips_(0)
+{}
+
+/**
+ * @brief Forget the estimate
+ */
+void TempoPll::reset()
+{
+    pulseCount_ = 0;
+    inWindow_ = 0;
+    locked_ = false;
+    periodQ8_ = 0;
+    pulseInBeat_ = 0;
+    lastErrorUs_ = 0;
+    slips_ = 0;
+}
+
+/**
+ * @brief Feed one pulse
+ *
+ * @details
+ *  1. Acquisition: the first pulse is a reference, the second one gives the first period
+ *  2. Interval since the last pulse: about k periods means k - 1 pulses were missed (the
+ *     prediction moves on), less than half a period is a glitch (dropped)
+ *  3. Phase error against the prediction. Off by more than a quarter period twice in a row is a
+ *     tempo jump, not jitter: the period restarts from the measured interval (beat count kept)
+ *  4. Loop filter: tempo and phase corrections, next prediction
+ *  5. Lock: LOCK_PULSES in a row inside period / 8, lost on a tempo jump
+ *
+ * @param atUs - micros() time of the pulse
+ */
+void TempoPll::pulse(unsigned long atUs)
+{
+    // 1. Acquisition
+    bool timedOut = (pulseCount_ > 1) && (atUs - lastPulseUs_) > (periodQ8_ >> 8) * TIMEOUT_PERIODS;
+    if (pulseCount_ == 0 || timedOut)
+    {
+        reset();
+        pulseCount_ = 1;
+        lastPulseUs_ = atUs;
+        beatUs0_ = atUs;
+        pulseInBeat_ = (pulsesPerBeat_ > 1) ? 1 : 0;
+        return;
+    }
+    if (pulseCount_ == 1)
+    {
+        periodQ8_ = (uint32_t)(atUs - lastPulseUs_) << 8;
+        pulseCount_ = 2;
+        lastPulseUs_ = atUs;
+        nextUs_ = atUs + (periodQ8_ >> 8);
+        if (pulseInBeat_ == 0) beatUs0_ = atUs;
+        if (++pulseInBeat_ >= pulsesPerBeat_) pulseInBeat_ = 0;
+        return;
+    }
+
+    // 2. Missed pulses / glitch
+    uint32_t period = periodQ8_ >> 8;
+    uint32_t interval = atUs - lastPulseUs_;
+    if (interval < period / 2) return;
+
+    uint8_t missed = 0;
+    while (interval > period + period / 2 && missed < MAX_MISSED_PULSES)
+    {
+        if (pulseInBeat_ == 0) beatUs0_ = nextUs_;
+        if (++pulseInBeat_ >= pulsesPerBeat_) pulseInBeat_ = 0;
+        nextUs_ += period;
+        interval -= period;
+        ++missed;
+    }
+    lastPulseUs_ = atUs;
+
+    // 3. Phase error, tempo jump
+    int32_t e = (int32_t)(atUs - nextUs_);
+    int32_t slipLimit = (int32_t)(period / 4);
+
+    if (e > slipLimit || e < -slipLimit)
+    {
+        if (++slips_ >= 2)
+        {
+            periodQ8_ = interval << 8;
+            nextUs_ = atUs;
+            e = 0;
+            slips_ = 0;
+            inWindow_ = 0;
+            locked_ = false;
+        }
+    }
+    else
+    {
+        slips_ = 0;
+    }
+    lastErrorUs_ = e;
+
+    // 4. Loop filter (arithmetic shifts keep the sign)
+    unsigned long corrected = nextUs_ + (e >> phaseShift_);
+    int32_t dPeriodQ8 = (int32_t)((uint32_t)e << 8) >> freqShift_;
+    if (dPeriodQ8 < 0 && (uint32_t)(-dPeriodQ8) >= periodQ8_ / 2) dPeriodQ8 = -(int32_t)(periodQ8_ / 2);
+    periodQ8_ += dPeriodQ8;
+
+    if (pulseInBeat_ == 0) beatUs0_ = corrected;
+    if (++pulseInBeat_ >= pulsesPerBeat_) pulseInBeat_ = 0;
+    nextUs_ = corrected + (periodQ8_ >> 8);
+
+    // 5. Lock
+    uint32_t window = (periodQ8_ >> 8) >> LOCK_WINDOW_SHIFT;
+    if ((uint32_t)(e < 0 ? -e : e) <= window)
+    {
+        if (inWindow_ < LOCK_PULSES) ++inWindow_;
+        if (inWindow_ >= LOCK_PULSES) locked_ = true;
+    }
+    else
+    {
+        inWindow_ = 0;
+    }
+}
+
+/**
+ * @brief Make the next pulse the start of a beat
+ */
+void TempoPll::alignBeat()
+{
+    pulseInBeat_ = 0;
+}
+
+/**
+ * @brief Check if the loop follows the pulse
+ *
+ * @param nowUs - micros()
+ * @return true - locked and the last pulse is recent
+ */
+bool TempoPll::isLocked(unsigned long nowUs) const
+{
+    if (!locked_) return false;
+
+    return (nowUs - lastPulseUs_) <= (periodQ8_ >> 8) * TIMEOUT_PERIODS;
+}
+
+/**
+ * @brief Get the estimated beat length
+ *
+ * @return uint32_t - us, 0 before two pulses
+ */
+uint32_t TempoPll::beatUs() const
+{
+    return (periodQ8_ >> 8) * pulsesPerBeat_;
+}
+
+/**
+ * @brief Get the estimated tempo
+ *
+ * @return uint32_t - BPM q8.8, 0 before two pulses
+ */
+uint32_t TempoPll::bpmQ8() const
+{
+    uint32_t beat = beatUs();
+    if (beat == 0) return 0;
+
+    return ((60000000UL / beat) << 8) + (((60000000UL % beat) << 8) / beat);
+}
+
+/**
+ * @brief Get the phase error of the last pulse
+ *
+ * @return int32_t - us, positive when the pulse came after the prediction
+ */
+int32_t TempoPll::lastErrorUs() const
+{
+    return lastErrorUs_;
+}
+
+/**
+ * @brief Get the position in the current beat
+ *
+ * @param nowUs - micros()
+ * @return uint16_t - 0 on the beat, 32768 half way to the next one
+ */
+uint16_t TempoPll::beatPhaseQ16(unsigned long nowUs) const
+{
+    uint32_t beat = beatUs();
+    if (beat == 0) return 0;
+
+    // Signed: just before the corrected beat time is the end of the previous beat
+    int32_t since = (int32_t)(nowUs - beatUs0_);
+    while (since < 0) since += (int32_t)beat;
+
+    return fractionQ16((uint32_t)since % beat, beat);
+}
+
+/**
+ * @brief Playback rate that makes a melody follow the pulse
+ *
+ * @details
+ *  1. Tempo: rate = melody beat / pulse beat
+ *  2. Phase: compare where the melody is in its beat with where the pulse is, wrapped to half a
+ *     beat either way, and trim the rate to catch up in about two beats. The trim is bounded by
+ *     MAX_TRIM_Q8, so the melody never jumps, it only plays slightly faster or slower
+ *
+ * @param melodyBpm - tempo the melody was built with
+ * @param melodyPosMs - position of the melody
+ * @param nowUs - micros()
+ * @return uint16_t - q8.8 rate, 0x0100 while there is no estimate
+ */
+uint16_t TempoPll::playbackRateFor(uint16_t melodyBpm, uint32_t melodyPosMs, unsigned long nowUs) const
+{
+    uint32_t pulseBeat = beatUs();
+    if (pulseBeat == 0 || melodyBpm == 0) return 0x0100;
+
+    // 1. Tempo ratio
+    uint32_t melodyBeat = 60000000UL / melodyBpm;
+    uint32_t num = melodyBeat, den = pulseBeat;
+    while (num >= 0x1000000UL) { num >>= 1; den >>= 1; }
+    uint32_t rateQ8 = (den > 0) ? (num << 8) / den : 0xFFFF;
+    if (rateQ8 > 0xFFFF) rateQ8 = 0xFFFF;
+
+    // 2. Phase trim: positive when the pulse is ahead of the melody
+    uint32_t inBeatUs = ((melodyPosMs % melodyBeat) * 1000UL) % melodyBeat;
+    int16_t diff = (int16_t)(beatPhaseQ16(nowUs) - fractionQ16(inBeatUs, melodyBeat));
+
+    int32_t trimQ8 = ((int32_t)(rateQ8 >> 1) * diff) >> 16;    // diff / 2 of the rate
+    int32_t maxTrim = (int32_t)((rateQ8 * MAX_TRIM_Q8) >> 8);
+    if (trimQ8 > maxTrim) trimQ8 = maxTrim;
+    if (trimQ8 < -maxTrim) trimQ8 = -maxTrim;
+
+    int32_t rate = (int32_t)rateQ8 + trimQ8;
+    if (rate < 1) rate = 1;
+    if (rate > 0xFFFF) rate = 0xFFFF;
+    return (uint16_t)rate;
+}
@@ -0,0 +1,144 @@
+#include "player/TimeIndex.h"
+
+/**
+ * @brief Construct a new Time Index
+ * 
+ * @param endTimes - storage for the prefix sums (nullptr: total duration only)
+ * @param capacity - entries endTimes can hold
+ */
+TimeIndex::TimeIndex(uint32_t* endTimes, size_t capacity):
+endTimes_(endTimes),
+capacity_(endTimes ? capacity : 0),
+count_(0),
+totalMs_(0),
+valid_(false),
+complete_(false)
+{}
+
+/**
+ * @brief Forget the indexed melody
+ */
+void TimeIndex::invalidate()
+{
+    valid_ = false;
+}
+
+/**
+ * @brief Check if the index describes the current melody
+ * 
+ * @return true - it was built and not invalidated since
+ */
+bool TimeIndex::isValid() const
+{
+    return valid_;
+}
+
+/**
+ * @brief Read the whole source once and fill the prefix sums
+ * 
+ * @details
+ * One linear pass: O(n) once per melody, then every query is O(log n).
+ * Endless sources stop the scan at MAX_SCAN_STEPS and are flagged as incomplete.
+ * 
+ * @param source - steps to index
+ */
+void TimeIndex::build(IStepSource& source)
+{
+    count_ = 0;
+    totalMs_ = 0;
+    complete_ = false;
+
+    source.rewind();
+
+    Step step;
+    while (count_ < MAX_SCAN_STEPS)
+    {
+        if (!source.next(step))
+        {
+            complete_ = true;
+            break;
+        }
+
+        totalMs_ += step.durationMs;
+        if (count_ < capacity_) endTimes_[count_] = totalMs_;
+        ++count_;
+    }
+
+    if (!complete_) totalMs_ = 0;      // unknown duration
+    valid_ = true;
+}
+
+/**
+ * @brief Check if the prefix sums can be used for O(log n) lookups
+ * 
+ * @return true - every step fit in the storage
+ */
+bool TimeIndex::hasPrefix() const
+{
+    return valid_ && complete_ && count_ <= capacity_;
+}
+
+/**
+ * @brief Check if the duration of the melody is known
+ * 
+ * @return true - the scan reached the end of the source
+ */
+bool TimeIndex::isComplete() const
+{
+    return valid_ && complete_;
+}
+
+/**
+ * @brief Get the total duration of the indexed melody
+ * 
+ * @return uint32_t - ms, 0 if unknown
+ */
+uint32_t TimeIndex::totalMs() const
+{
+    return valid_ ? totalMs_ : 0;
+}
+
+/**
+ * @brief Get the number of steps of the indexed melody
+ * 
+ * @return size_t 
+ */
+size_t TimeIndex::stepCount() const
+{
+    return valid_ ? count_ : 0;
+}
+
+/**
+ * @brief Binary search of the step playing at a time position
+ * 
+ * @param ms - position from the start of the melody
+ * @return size_t - first step whose end time is after ms, stepCount() if past the end
+ */
+size_t TimeIndex::stepAt(uint32_t ms) const
+{
+    size_t low = 0;
+    size_t high = count_;
+
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+
+        if (endTimes_[mid] <= ms) low = mid + 1;
+        else high = mid;
+    }
+
+    return low;
+}
+
+/**
+ * @brief Get the start time of a step
+ * 
+ * @param idx - step index
+ * @return uint32_t - ms from the start of the melody
+ */
+uint32_t TimeIndex::stepStartMs(size_t idx) const
+{
+    if (idx == 0 || idx > count_) return 0;
+
+    return endTimes_[idx - 1];
+}
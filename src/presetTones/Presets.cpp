@@ -0,0 +1,201 @@
+#include "presetTones/Presets.h"
+#include "core/Progmem.h"
+
+namespace
+{
+    // --- Runtime table: the only copy of the registry the program reads, kept in flash ---
+
+    // One name per preset, expanded from PRESET_LIST: NAME_Success, NAME_Error, ...
+#define PRESET_NAME(id, name, tone) constexpr char NAME_##id[] PROGMEM = name;
+    PRESET_LIST(PRESET_NAME)
+#undef PRESET_NAME
+
+    /// @brief Preset as stored in flash, read back with pgm_read_*()
+    struct StoredPreset
+    {
+        const score::ScoreNote* notes;
+        uint16_t count;
+        const char* name;               // lower case, unique (Serial commands)
+    };
+
+    using presets::REGISTRY;
+
+    // One line per preset, expanded from PRESET_LIST in PresetId order: each row takes its score
+    // from the REGISTRY entry of its own id and its name from the same list line
+    constexpr StoredPreset PRESET_TABLE[] PROGMEM = {
+#define PRESET_ROW(id, name, tone) \
+        {REGISTRY[static_cast<uint8_t>(PresetId::id)].notes, REGISTRY[static_cast<uint8_t>(PresetId::id)].count, NAME_##id},
+        PRESET_LIST(PRESET_ROW)
+#undef PRESET_ROW
+    };
+
+    static_assert(sizeof(PRESET_TABLE) / sizeof(PRESET_TABLE[0]) == presets::PRESET_COUNT, "PRESET_TABLE needs exactly one line per PresetId");
+
+    // --- Compile time perfect hash of the preset names ---
+    //  FNV-1a (32 bits, ASCII case folded) seeded through the offset basis, folded to NAME_BITS bits.
+    //  findSeed() tries seeds until the names land in distinct buckets, the compiler does the search.
+    //  A name listed twice can never land in distinct buckets: it fails the NAME_SEED static_assert.
+
+    constexpr uint8_t NAME_BITS = 4;
+    constexpr uint8_t NAME_BUCKETS = 1 << NAME_BITS;
+    constexpr uint8_t NO_PRESET = 0xFF;
+    constexpr uint32_t MAX_SEED = 64;           // seeds tried before giving up (then grow NAME_BITS)
+
+    static_assert(NAME_BUCKETS >= 2 * presets::PRESET_COUNT, "grow NAME_BITS: the name table should stay at most half full");
+
+    constexpr char fold(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+
+    /// @brief FNV-1a of a null terminated string (compile time)
+    constexpr uint32_t hashName(const char* s, uint32_t h)
+    {
+        return *s == '\0' ? h : hashName(s + 1, (uint32_t)((h ^ (uint8_t)fold(*s)) * 16777619UL));
+    }
+
+    constexpr uint8_t bucketOf(uint32_t h)
+    {
+        return (uint8_t)((h ^ (h >> 16)) & (NAME_BUCKETS - 1));
+    }
+
+    constexpr uint8_t nameBucket(uint8_t preset, uint32_t seed)
+    {
+        return bucketOf(hashName(PRESET_TABLE[preset].name, 2166136261UL ^ seed));
+    }
+
+    /// @brief No preset after i shares the bucket of preset i
+    constexpr bool bucketFree(uint32_t seed, uint8_t i, uint8_t j)
+    {
+        return j >= presets::PRESET_COUNT || (nameBucket(i, seed) != nameBucket(j, seed) && bucketFree(seed, i, j + 1));
+    }
+
+    constexpr bool perfect(uint32_t seed, uint8_t i = 0)
+    {
+        return i >= presets::PRESET_COUNT || (bucketFree(seed, i, i + 1) && perfect(seed, i + 1));
+    }
+
+    constexpr uint32_t findSeed(uint32_t seed = 0)
+    {
+        return seed >= MAX_SEED ? MAX_SEED : (perfect(seed) ? seed : findSeed(seed + 1));
+    }
+
+    constexpr uint32_t NAME_SEED = findSeed();
+    static_assert(NAME_SEED < MAX_SEED, "no perfect hash seed for the preset names: grow NAME_BITS");
+
+    /// @brief Preset whose name lands in a bucket
+    constexpr uint8_t bucketOwner(uint8_t bucket, uint8_t i = 0)
+    {
+        return i >= presets::PRESET_COUNT ? NO_PRESET : (nameBucket(i, NAME_SEED) == bucket ? i : bucketOwner(bucket, i + 1));
+    }
+
+    static_assert(NAME_BUCKETS == 16, "NAME_TABLE lists one initializer per bucket");
+    const uint8_t NAME_TABLE[NAME_BUCKETS] PROGMEM = {
+        bucketOwner(0),  bucketOwner(1),  bucketOwner(2),  bucketOwner(3),
+        bucketOwner(4),  bucketOwner(5),  bucketOwner(6),  bucketOwner(7),
+        bucketOwner(8),  bucketOwner(9),  bucketOwner(10), bucketOwner(11),
+        bucketOwner(12), bucketOwner(13), bucketOwner(14), bucketOwner(15)
+    };
+}
+
+namespace presets
+{
+    /**
+     * @brief Get the ScoreView of a preset
+     *
+     * @param id - Preset id
+     * @return score::ScoreView - score of the preset, empty for an unknown id
+     */
+    score::ScoreView getPresetById(PresetId id)
+    {
+        uint8_t index = static_cast<uint8_t>(id);
+        if (index >= PRESET_COUNT) return score::ScoreView{nullptr, 0};
+
+        const StoredPreset* entry = &PRESET_TABLE[index];
+        return score::ScoreView{
+            (const score::ScoreNote*)pgm_read_ptr(&entry->notes),
+            (uint16_t)pgm_read_word(&entry->count)
+        };
+    }
+
+    /**
+     * @brief Copy the name of a preset out of flash
+     *
+     * @param id - Preset id
+     * @param out - output buffer
+     * @param capacity - its size
+     * @return size_t - characters copied
+     */
+    size_t getPresetName(PresetId id, char* out, size_t capacity)
+    {
+        if (out == nullptr || capacity == 0) return 0;
+
+        size_t length = 0;
+        uint8_t index = static_cast<uint8_t>(id);
+        if (index < PRESET_COUNT)
+        {
+            const char* name = (const char*)pgm_read_ptr(&PRESET_TABLE[index].name);
+            for (char c; length + 1 < capacity && (c = (char)pgm_read_byte(name + length)) != '\0'; ++length) out[length] = c;
+        }
+
+        out[length] = '\0';
+        return length;
+    }
+
+    /**
+     * @brief Find a preset by name in constant time
+     *
+     * @details
+     *  1. Hash the input like the names were hashed at compile time
+     *  2. Its bucket holds the only preset it can be
+     *  3. Confirm with one compare (an unknown word can land on a used bucket)
+     *
+     * @param name - characters of the name
+     * @param length - characters in name
+     * @param id - output preset
+     * @return true - found
+     */
+    bool findPresetByName(const char* name, size_t length, PresetId& id)
+    {
+        if (name == nullptr) return false;
+
+        // 1. Hash
+        uint32_t h = 2166136261UL ^ NAME_SEED;
+        for (size_t i = 0; i < length; ++i)
+        {
+            h = (uint32_t)((h ^ (uint8_t)fold(name[i])) * 16777619UL);
+        }
+
+        // 2. Candidate
+        uint8_t preset = pgm_read_byte(&NAME_TABLE[bucketOf(h)]);
+        if (preset == NO_PRESET) return false;
+
+        // 3. Confirm
+        const char* expected = (const char*)pgm_read_ptr(&PRESET_TABLE[preset].name);
+        for (size_t i = 0; i < length; ++i)
+        {
+            char c = (char)pgm_read_byte(expected + i);
+            if (c == '\0' || fold(name[i]) != c) return false;
+        }
+        if (pgm_read_byte(expected + length) != '\0') return false;
+
+        id = static_cast<PresetId>(preset);
+        return true;
+    }
+
+    /**
+     * @brief Find a preset by a null terminated name
+     *
+     * @param name - name
+     * @param id - output preset
+     * @return true - found
+     */
+    bool findPresetByName(const char* name, PresetId& id)
+    {
+        if (name == nullptr) return false;
+
+        size_t length = 0;
+        while (name[length] != '\0') ++length;
+        return findPresetByName(name, length, id);
+    }
+}
@@ -0,0 +1,72 @@
+#include "protocol/UploadProtocol.h"
+#include "core/Cobs.h"
+#include "core/Crc16.h"
+
+namespace upload
+{
+    /**
+     * @brief Build a frame
+     *
+     * @details
+     *  1. Leading delimiter
+     *  2. COBS of type, seq, body and CRC, encoded straight into out (no raw copy of the frame)
+     *  3. Trailing delimiter
+     *
+     * @param type - frame type
+     * @param seq - sequence number
+     * @param body - body bytes
+     * @param bodyLength - their count
+     * @param out - output buffer
+     * @param capacity - its size
+     * @return size_t - bytes to send, 0 if out is too small
+     */
+    size_t encodeFrame(uint8_t type, uint8_t seq, const uint8_t* body, size_t bodyLength, uint8_t* out, size_t capacity)
+    {
+        if (out == nullptr || capacity < 2) return 0;
+
+        // 1. Leading delimiter
+        out[0] = DELIMITER;
+
+        // 2. COBS, the last byte is kept for the trailing delimiter
+        cobs::Encoder encoder(out + 1, capacity - 2);
+        uint16_t crc = crc16::update(crc16::INIT, type);
+        crc = crc16::update(crc, seq);
+        encoder.put(type);
+        encoder.put(seq);
+
+        for (size_t i = 0; i < bodyLength; ++i)
+        {
+            crc = crc16::update(crc, body[i]);
+            encoder.put(body[i]);
+        }
+        encoder.put((uint8_t)crc);
+        encoder.put((uint8_t)(crc >> 8));
+
+        size_t length = encoder.finish();
+        if (length == 0) return 0;
+
+        // 3. Trailing delimiter
+        out[1 + length] = DELIMITER;
+        return length + 2;
+    }
+
+    /**
+     * @brief Decode a whole frame and check its CRC
+     *
+     * @param data - COBS bytes, delimiters excluded
+     * @param length - their count
+     * @param out - type, seq and body
+     * @param capacity - its size
+     * @return size_t - decoded length without the CRC, 0 if malformed or bad CRC
+     */
+    size_t decodeFrame(const uint8_t* data, size_t length, uint8_t* out, size_t capacity)
+    {
+        size_t decoded = cobs::decode(data, length, out, capacity);
+        if (decoded < HEAD_BYTES + CRC_BYTES) return 0;
+
+        size_t payload = decoded - CRC_BYTES;
+        if (crc16::compute(out, payload) != readU16(out + payload)) return 0;
+
+        return payload;
+    }
+}
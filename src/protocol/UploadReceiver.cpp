@@ -0,0 +1,425 @@
+#include "protocol/UploadReceiver.h"
+#include "core/Crc16.h"
+
+using upload::FrameType;
+using upload::Kind;
+using upload::Status;
+
+constexpr uint8_t UploadReceiver::HEAD_CAPTURE;
+constexpr uint16_t UploadReceiver::MAX_FRAME_BYTES;
+
+namespace {
+
+    const UploadEvent NO_EVENT = {UploadEvent::Type::None, 0, false};
+
+}
+
+/**
+ * @brief Construct a new Upload Receiver
+ *
+ * @param buffer - step buffer the uploads are written to
+ * @param capacity - its size in steps
+ */
+UploadReceiver::UploadReceiver(Step* buffer, uint16_t capacity):
+buffer_(buffer),
+capacity_(buffer != nullptr ? capacity : 0),
+sink_(nullptr),
+sinkContext_(nullptr),
+scoreHandler_(nullptr),
+scoreContext_(nullptr),
+crc_(crc16::INIT),
+lag_{0, 0},
+lagCount_(0),
+index_(0),
+head_{0, 0, 0, 0, 0},
+stepBytes_{0, 0, 0, 0, 0, 0},
+writing_(false),
+active_(false),
+kind_(Kind::Steps),
+total_(0),
+received_(0),
+committed_(0),
+hasLast_(false),
+lastType_(0),
+lastSeq_(0),
+lastStatus_(Status::Ok),
+goodFrames_(0),
+crcErrors_(0),
+framingErrors_(0)
+{}
+
+/**
+ * @brief Set where replies go
+ *
+ * @param sink - writes the reply bytes
+ * @param context - passed back to sink
+ */
+void UploadReceiver::setReplySink(ByteSink sink, void* context)
+{
+    sink_ = sink;
+    sinkContext_ = context;
+}
+
+/**
+ * @brief Set who stores uploaded scores
+ *
+ * @param handler - stores a score as a tone
+ * @param context - passed back to handler
+ */
+void UploadReceiver::setScoreHandler(ScoreHandler handler, void* context)
+{
+    scoreHandler_ = handler;
+    scoreContext_ = context;
+}
+
+/**
+ * @brief Process one received byte
+ *
+ * @details
+ *  1. Delimiter: the frame ends, check and apply it
+ *  2. COBS decode; a block code may produce nothing
+ *  3. The decoded byte enters the CRC lag, the one leaving it is part of type, seq or body
+ *
+ * @param byte - byte from the Serial line
+ * @return UploadEvent - what the frame asks for, None until it ends
+ */
+UploadEvent UploadReceiver::feed(uint8_t byte)
+{
+    // 1. Delimiter
+    if (byte == upload::DELIMITER) return endFrame_();
+
+    // 2. COBS decode
+    uint8_t decoded;
+    if (!decoder_.push(byte, decoded)) return NO_EVENT;
+
+    // 3. CRC lag
+    if (lagCount_ < upload::CRC_BYTES)
+    {
+        lag_[lagCount_++] = decoded;
+        return NO_EVENT;
+    }
+
+    uint8_t out = lag_[0];
+    lag_[0] = lag_[1];
+    lag_[1] = decoded;
+    processByte_(out);
+
+    return NO_EVENT;
+}
+
+/**
+ * @brief Get the last uploaded melody
+ *
+ * @return Melody - steps of the step buffer, empty while an upload is in progress
+ */
+Melody UploadReceiver::melody() const
+{
+    return Melody{buffer_, committed_};
+}
+
+/**
+ * @brief Get the progress of the current upload
+ *
+ * @return uint16_t - steps or bytes accepted
+ */
+uint16_t UploadReceiver::received() const
+{
+    return received_;
+}
+
+/**
+ * @brief Get the frames accepted
+ *
+ * @return uint16_t - frames with a good CRC
+ */
+uint16_t UploadReceiver::goodFrames() const
+{
+    return goodFrames_;
+}
+
+/**
+ * @brief Get the frames dropped because of a bad CRC
+ *
+ * @return uint16_t - count
+ */
+uint16_t UploadReceiver::crcErrors() const
+{
+    return crcErrors_;
+}
+
+/**
+ * @brief Get the frames dropped because truncated or too long
+ *
+ * @return uint16_t - count
+ */
+uint16_t UploadReceiver::framingErrors() const
+{
+    return framingErrors_;
+}
+
+//////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+/**
+ * @brief Process a byte of type, seq or body
+ *
+ * @details
+ *  1. CRC and capture of the first bytes (type, seq, DATA offset, BEGIN / COMMIT arguments)
+ *  2. Once the DATA offset is known: the payload is stored only if the frame extends the upload
+ *  3. DATA payload goes straight to the step buffer (a Step every 6 bytes) or the score staging
+ *
+ * @param byte - decoded byte
+ */
+void UploadReceiver::processByte_(uint8_t byte)
+{
+    // 1. CRC and head
+    crc_ = crc16::update(crc_, byte);
+    uint16_t index = index_;
+    if (index_ <= MAX_FRAME_BYTES) ++index_;
+    if (index < HEAD_CAPTURE) head_[index] = byte;
+
+    if (head_[0] != (uint8_t)FrameType::Data || index < upload::HEAD_BYTES + 1) return;
+
+    // 2. Offset complete
+    uint16_t offset = upload::readU16(head_ + upload::HEAD_BYTES);
+    if (index == upload::HEAD_BYTES + 1)
+    {
+        writing_ = active_ && offset == received_;
+        return;
+    }
+    if (!writing_ || index >= MAX_FRAME_BYTES) return;
+
+    // 3. Payload
+    uint16_t position = index - (upload::HEAD_BYTES + 2);
+    if (kind_ == Kind::Steps)
+    {
+        uint8_t part = position % upload::STEP_WIRE_BYTES;
+        uint16_t target = offset + position / upload::STEP_WIRE_BYTES;
+        stepBytes_[part] = byte;
+
+        if (part == upload::STEP_WIRE_BYTES - 1 && target < total_)
+        {
+            buffer_[target].freqHz = upload::readU16(stepBytes_);
+            buffer_[target].durationMs = (uint32_t)upload::readU16(stepBytes_ + 2)
+                                       | ((uint32_t)upload::readU16(stepBytes_ + 4) << 16);
+        }
+    }
+    else if ((uint32_t)offset + position < total_)
+    {
+        rawBuffer_()[offset + position] = byte;
+    }
+}
+
+/**
+ * @brief End of frame
+ *
+ * @details
+ *  1. Empty frame (two delimiters in a row): nothing
+ *  2. Truncated or too long: framing error; bad CRC: CRC error. No reply, the host resends.
+ *  3. Retransmission of the last frame: same reply again, not applied twice
+ *  4. Apply and reply
+ *
+ * @return UploadEvent - what the frame asks for
+ */
+UploadEvent UploadReceiver::endFrame_()
+{
+    UploadEvent event = NO_EVENT;
+
+    // 1. Empty frame
+    if (lagCount_ == 0 && index_ == 0)
+    {
+        resetFrame_();
+        return event;
+    }
+
+    // 2. Checks
+    if (!decoder_.isComplete() || index_ < upload::HEAD_BYTES || index_ > MAX_FRAME_BYTES)
+    {
+        ++framingErrors_;
+        resetFrame_();
+        return event;
+    }
+    if (crc_ != upload::readU16(lag_))
+    {
+        ++crcErrors_;
+        resetFrame_();
+        return event;
+    }
+    ++goodFrames_;
+
+    // 3. Retransmission
+    uint8_t type = head_[0];
+    uint8_t seq = head_[1];
+    if (hasLast_ && type == lastType_ && seq == lastSeq_)
+    {
+        reply_(type, seq, lastStatus_);
+        resetFrame_();
+        return event;
+    }
+
+    // 4. Apply
+    Status status = Status::Ok;
+    event = handleFrame_(status);
+
+    hasLast_ = true;
+    lastType_ = type;
+    lastSeq_ = seq;
+    lastStatus_ = status;
+
+    reply_(type, seq, status);
+    resetFrame_();
+    return event;
+}
+
+/**
+ * @brief Apply a frame that passed the CRC check
+ *
+ * @param status - reply status
+ * @return UploadEvent - what the frame asks for
+ */
+UploadEvent UploadReceiver::handleFrame_(Status& status)
+{
+    UploadEvent event = NO_EVENT;
+    uint16_t bodyLength = index_ - upload::HEAD_BYTES;
+
+    switch ((FrameType)head_[0])
+    {
+        case FrameType::Ping:
+            break;
+
+        case FrameType::Begin:
+        {
+            uint16_t total = upload::readU16(head_ + 3);
+            uint32_t limit = (head_[2] == (uint8_t)Kind::Steps) ? capacity_ : (uint32_t)capacity_ * sizeof(Step);
+
+            active_ = false;
+            if (bodyLength != 3 || head_[2] > (uint8_t)Kind::Score || total == 0 || total > limit)
+            {
+                status = Status::BadRange;
+                break;
+            }
+
+            active_ = true;
+            kind_ = (Kind)head_[2];
+            total_ = total;
+            received_ = 0;
+            committed_ = 0;
+            event.type = UploadEvent::Type::UploadStarted;
+            break;
+        }
+
+        case FrameType::Data:
+        {
+            if (!active_)
+            {
+                status = Status::BadState;
+                break;
+            }
+
+            uint16_t payload = bodyLength - 2;
+            uint16_t offset = upload::readU16(head_ + upload::HEAD_BYTES);
+            uint16_t count = (kind_ == Kind::Steps) ? payload / upload::STEP_WIRE_BYTES : payload;
+
+            if (bodyLength < 2 || (kind_ == Kind::Steps && payload % upload::STEP_WIRE_BYTES != 0)
+                || offset != received_ || (uint32_t)offset + count > total_)
+            {
+                status = Status::BadRange;
+                break;
+            }
+
+            received_ += count;
+            break;
+        }
+
+        case FrameType::Commit:
+        {
+            if (!active_ || received_ != total_ || bodyLength != 1)
+            {
+                status = Status::BadState;
+                break;
+            }
+
+            if (kind_ == Kind::Steps)
+            {
+                active_ = false;
+                committed_ = total_;
+                event.type = UploadEvent::Type::MelodyReady;
+                event.loop = head_[2] != 0;
+                break;
+            }
+
+            if (scoreHandler_ == nullptr || !scoreHandler_(head_[2], rawBuffer_(), total_, scoreContext_))
+            {
+                status = Status::StoreFailed;
+                break;
+            }
+
+            active_ = false;
+            event.type = UploadEvent::Type::ScoreStored;
+            event.tone = head_[2];
+            break;
+        }
+
+        case FrameType::Play:
+            if (bodyLength != 1)
+            {
+                status = Status::BadRange;
+                break;
+            }
+            event.type = UploadEvent::Type::PlayTone;
+            event.tone = head_[2];
+            break;
+
+        case FrameType::Stop:
+            event.type = UploadEvent::Type::Stop;
+            break;
+
+        default:
+            status = Status::Unknown;
+            break;
+    }
+
+    return event;
+}
+
+/**
+ * @brief Send a reply
+ *
+ * @param type - type of the frame answered
+ * @param seq - its seq
+ * @param status - result
+ */
+void UploadReceiver::reply_(uint8_t type, uint8_t seq, Status status)
+{
+    if (sink_ == nullptr) return;
+
+    uint8_t body[upload::REPLY_BODY_BYTES];
+    body[0] = (uint8_t)status;
+    upload::writeU16(body + 1, received_);
+
+    uint8_t frame[upload::maxFrameSize(upload::REPLY_BODY_BYTES)];
+    size_t length = upload::encodeFrame(upload::REPLY_FLAG | type, seq, body, sizeof(body), frame, sizeof(frame));
+    if (length > 0) sink_(frame, length, sinkContext_);
+}
+
+/**
+ * @brief Forget the current frame
+ */
+void UploadReceiver::resetFrame_()
+{
+    decoder_.reset();
+    crc_ = crc16::INIT;
+    lagCount_ = 0;
+    index_ = 0;
+    head_[0] = 0;
+    writing_ = false;
+}
+
+/**
+ * @brief Raw view of the step buffer
+ *
+ * @return uint8_t* - capacity * sizeof(Step) bytes
+ */
+uint8_t* UploadReceiver::rawBuffer_() const
+{
+    return reinterpret_cast<uint8_t*>(buffer_);
+}
@@ -0,0 +1,64 @@
+#include "sources/ArrangementSource.h"
+#include "music/Pitch.h"
+
+/**
+ * @brief Construct a new Arrangement Source
+ * 
+ * @param arrangement - phrase references to walk
+ */
+ArrangementSource::ArrangementSource(const Arrangement& arrangement):
+arrangement_(arrangement),
+refIdx_(0),
+pass_(0),
+stepIdx_(0)
+{}
+
+/**
+ * @brief Go back to the first step of the first phrase
+ */
+void ArrangementSource::rewind()
+{
+    refIdx_ = 0;
+    pass_ = 0;
+    stepIdx_ = 0;
+}
+
+/**
+ * @brief Produce the next step of the song
+ * 
+ * @details
+ *  1. When the current phrase is finished, repeat it or move to the next reference
+ *     (empty phrases and references with repeat = 0 are skipped)
+ *  2. Copy the step of the phrase, transposed if the reference asks for it
+ * 
+ * @param step - output Step
+ * @return true - a step was produced
+ * @return false - end of the arrangement
+ */
+bool ArrangementSource::next(Step& step)
+{
+    if (arrangement_.refs == nullptr) return false;
+
+    while (refIdx_ < arrangement_.count)
+    {
+        const PhraseRef& ref = arrangement_.refs[refIdx_];
+        const Melody* phrase = ref.phrase;
+
+        // 1. Step of the current repetition
+        if (phrase != nullptr && phrase->steps != nullptr && pass_ < ref.repeat && stepIdx_ < phrase->count)
+        {
+            step = phrase->steps[stepIdx_++];
+            if (ref.transpose != 0) step.freqHz = pitch::transpose(step.freqHz, ref.transpose);
+            return true;
+        }
+
+        // 2. Phrase finished: repeat it or move to the next reference
+        stepIdx_ = 0;
+        if (phrase != nullptr && phrase->count > 0 && ++pass_ < ref.repeat) continue;
+
+        pass_ = 0;
+        ++refIdx_;
+    }
+
+    return false;
+}
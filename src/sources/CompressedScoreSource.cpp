@@ -0,0 +1,54 @@
+#include "sources/CompressedScoreSource.h"
+
+/**
+ * @brief Construct a new Compressed Score Source
+ * 
+ * @param data - encoded score
+ * @param ctx - tempo and articulation gap used to convert the notes
+ * @param space - memory where data lives
+ */
+CompressedScoreSource::CompressedScoreSource(const uint8_t* data, const MelodyContext& ctx, codec::MemorySpace space):
+NoteStepSource(ctx),
+decoder_(data, space)
+{}
+
+/**
+ * @brief Point the source to another encoded score and rewind it
+ * 
+ * @param data - encoded score
+ * @param space - memory where data lives
+ */
+void CompressedScoreSource::reset(const uint8_t* data, codec::MemorySpace space)
+{
+    decoder_ = codec::ScoreDecoder(data, space);
+    rewind();
+}
+
+/**
+ * @brief Get the number of notes in the encoded score
+ * 
+ * @return uint16_t 
+ */
+uint16_t CompressedScoreSource::noteCount() const
+{
+    return decoder_.count();
+}
+
+/**
+ * @brief Decode the next note of the score
+ * 
+ * @param note - output note
+ * @return false when the score is exhausted
+ */
+bool CompressedScoreSource::nextNote_(score::ScoreNote& note)
+{
+    return decoder_.next(note);
+}
+
+/**
+ * @brief Go back to the first note of the score
+ */
+void CompressedScoreSource::rewindNotes_()
+{
+    decoder_.rewind();
+}
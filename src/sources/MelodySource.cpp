@@ -0,0 +1,57 @@
+#include "sources/MelodySource.h"
+
+/**
+ * @brief Construct an empty Melody Source (next() returns false until reset() is called)
+ */
+MelodySource::MelodySource():
+melody_(Melody{nullptr, 0}),
+nextIdx_(0)
+{}
+
+/**
+ * @brief Point the source to a new melody and rewind it
+ * 
+ * @param melody - melody to walk. Only the view is copied, the Steps must outlive the playback
+ */
+void MelodySource::reset(const Melody& melody)
+{
+    melody_ = melody;
+    nextIdx_ = 0;
+}
+
+/**
+ * @brief Go back to the first step of the melody
+ */
+void MelodySource::rewind()
+{
+    nextIdx_ = 0;
+}
+
+/**
+ * @brief Copy the next step of the melody
+ * 
+ * @param step - output Step
+ * @return true - if there was a step
+ * @return false - end of the melody (or no melody)
+ */
+bool MelodySource::next(Step& step)
+{
+    if (melody_.steps == nullptr || nextIdx_ >= melody_.count) return false;
+
+    step = melody_.steps[nextIdx_++];
+    return true;
+}
+
+/**
+ * @brief Jump to a step of the melody in O(1)
+ * 
+ * @param index - step the next call to next() returns
+ * @return false - if index is past the end of the melody
+ */
+bool MelodySource::seek(size_t index)
+{
+    if (index > melody_.count) return false;
+
+    nextIdx_ = index;
+    return true;
+}
@@ -0,0 +1,172 @@
+#include "sources/MetronomeSource.h"
+
+namespace
+{
+    constexpr uint32_t US_PER_WHOLE_NOTE_AT_1BPM = 240000000UL;    // 60 s * 4 quarters
+}
+
+/**
+ * @brief Construct a new Metronome Source
+ *
+ * @param config - tempo, time signature, click pitches and length
+ */
+MetronomeSource::MetronomeSource(const MetronomeConfig& config):
+config_(config),
+pending_(config),
+hasPending_(false),
+beatUs_(0),
+beatRemainder_(0),
+fractionAcc_(0),
+restUs_(0),
+beatInBar_(0),
+lastExtraUs_(0),
+beats_(0)
+{
+    applyConfig_(config);
+}
+
+/**
+ * @brief Change the settings from the next beat on
+ *
+ * @param config - new settings
+ */
+void MetronomeSource::setConfig(const MetronomeConfig& config)
+{
+    pending_ = config;
+    hasPending_ = true;
+}
+
+/**
+ * @brief Get the settings of the next beat
+ *
+ * @return const MetronomeConfig&
+ */
+const MetronomeConfig& MetronomeSource::config() const
+{
+    return hasPending_ ? pending_ : config_;
+}
+
+/**
+ * @brief Get how many clicks were produced
+ *
+ * @return uint32_t
+ */
+uint32_t MetronomeSource::beats() const
+{
+    return beats_;
+}
+
+/**
+ * @brief Start again from a downbeat
+ */
+void MetronomeSource::rewind()
+{
+    if (hasPending_)
+    {
+        applyConfig_(pending_);
+        hasPending_ = false;
+    }
+
+    fractionAcc_ = 0;
+    restUs_ = 0;
+    beatInBar_ = 0;
+    lastExtraUs_ = 0;
+    beats_ = 0;
+}
+
+/**
+ * @brief Produce the next click or rest
+ *
+ * @details
+ *  1. A rest is pending: emit it (the rest of the beat after the click)
+ *  2. New beat: apply a pending config, compute the exact beat length (whole us + accumulated
+ *     fraction), emit the click and keep the remaining time as the next rest
+ *
+ * @param step - output Step, its sub-ms part in lastStepExtraUs()
+ * @return true - always, the metronome never ends
+ */
+bool MetronomeSource::next(Step& step)
+{
+    uint32_t us;
+
+    // 1. End of the beat
+    if (restUs_ > 0)
+    {
+        us = restUs_;
+        restUs_ = 0;
+        step.freqHz = 0;
+    }
+    // 2. Next beat
+    else
+    {
+        if (hasPending_)
+        {
+            applyConfig_(pending_);
+            hasPending_ = false;
+        }
+        if (beatInBar_ >= config_.beatsPerBar) beatInBar_ = 0;
+
+        uint32_t beatUs = beatUs_;
+        fractionAcc_ += beatRemainder_;
+        if (fractionAcc_ >= (uint32_t)config_.bpm * config_.beatUnit)
+        {
+            fractionAcc_ -= (uint32_t)config_.bpm * config_.beatUnit;
+            ++beatUs;
+        }
+
+        uint32_t clickUs = (uint32_t)config_.clickMs * 1000UL;
+        if (clickUs > beatUs / 2) clickUs = beatUs / 2;
+
+        step.freqHz = (beatInBar_ == 0) ? config_.accentHz : config_.beatHz;
+        us = clickUs;
+        restUs_ = beatUs - clickUs;
+
+        ++beatInBar_;
+        ++beats_;
+    }
+
+    step.durationMs = us / 1000UL;
+    lastExtraUs_ = (uint16_t)(us % 1000UL);
+    return true;
+}
+
+/**
+ * @brief Get the sub-ms part of the last step
+ *
+ * @return uint16_t - us
+ */
+uint16_t MetronomeSource::lastStepExtraUs() const
+{
+    return lastExtraUs_;
+}
+
+/**
+ * @brief Check if the clicks can be indexed
+ *
+ * @return false - endless: no duration, position queries must not scan it
+ */
+bool MetronomeSource::isReplayable() const
+{
+    return false;
+}
+
+/**
+ * @brief Compute the beat length of a config
+ *
+ * @details beat = 240000000 / (bpm * beatUnit) us, kept as quotient + remainder so the
+ * fraction is carried from beat to beat instead of being dropped.
+ *
+ * @param config - settings to use from now on
+ */
+void MetronomeSource::applyConfig_(const MetronomeConfig& config)
+{
+    config_ = config;
+    if (config_.bpm == 0) config_.bpm = 1;
+    if (config_.beatUnit == 0) config_.beatUnit = 4;
+    if (config_.beatsPerBar == 0) config_.beatsPerBar = 1;
+
+    uint32_t divisor = (uint32_t)config_.bpm * config_.beatUnit;
+    beatUs_ = US_PER_WHOLE_NOTE_AT_1BPM / divisor;
+    beatRemainder_ = US_PER_WHOLE_NOTE_AT_1BPM % divisor;
+    if (fractionAcc_ >= divisor) fractionAcc_ = 0;
+}
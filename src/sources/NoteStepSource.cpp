@@ -0,0 +1,81 @@
+#include "sources/NoteStepSource.h"
+#include "music/Timing.h"
+
+/**
+ * @brief Construct a new Note Step Source
+ * 
+ * @param ctx - tempo and articulation gap used to convert notes to Steps
+ */
+NoteStepSource::NoteStepSource(const MelodyContext& ctx):
+ctx_(ctx),
+pendingRestMs_(0)
+{}
+
+/**
+ * @brief Change the tempo/gap used to convert the next notes
+ * 
+ * @param ctx - new conversion context
+ */
+void NoteStepSource::setContext(const MelodyContext& ctx)
+{
+    ctx_ = ctx;
+}
+
+/**
+ * @brief Get the context used to convert notes
+ * 
+ * @return const MelodyContext& 
+ */
+const MelodyContext& NoteStepSource::context() const
+{
+    return ctx_;
+}
+
+/**
+ * @brief Go back to the first note and drop any pending articulation rest
+ */
+void NoteStepSource::rewind()
+{
+    pendingRestMs_ = 0;
+    rewindNotes_();
+}
+
+/**
+ * @brief Produce the next Step
+ * 
+ * @details
+ *  1. If the previous note was split(tone + gap) emit its rest first
+ *  2. Otherwise read the next note and convert it, the same way MelodyBuilder::addNote() does.
+ *     Notes with an invalid duration are skipped.
+ * 
+ * @param step - output Step
+ * @return true - a Step was produced
+ * @return false - the score is exhausted
+ */
+bool NoteStepSource::next(Step& step)
+{
+    // 1. Articulation rest of the previous note
+    if (pendingRestMs_ > 0)
+    {
+        step = Step{0, pendingRestMs_};
+        pendingRestMs_ = 0;
+        return true;
+    }
+
+    // 2. Convert the next valid note
+    score::ScoreNote note;
+    while (nextNote_(note))
+    {
+        uint32_t durationMs = timing::denomToMs(note.denom, ctx_.bpm);
+        if (durationMs == 0) continue;      // invalid duration: skip it
+
+        // Silence is not articulated
+        uint32_t restMs = (note.hz > 0) ? timing::articulationGapMs(durationMs, ctx_.gapMs) : 0;
+
+        step = Step{note.hz, durationMs - restMs};
+        pendingRestMs_ = restMs;
+        return true;
+    }
+
+    return false;
+}
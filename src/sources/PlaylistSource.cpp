@@ -0,0 +1,240 @@
+#include "sources/PlaylistSource.h"
+
+/**
+ * @brief Construct a playlist of built melodies
+ * 
+ * @param melodies - entries
+ * @param count - number of entries
+ * @param order - in order or shuffled
+ * @param seed - shuffle seed
+ */
+PlaylistSource::PlaylistSource(const Melody* melodies, size_t count, PlaylistOrder order, uint16_t seed):
+melodies_(melodies),
+sources_(nullptr),
+count_(melodies ? count : 0),
+repeats_(nullptr),
+order_(order),
+melodyAdapter_(),
+current_(nullptr),
+played_(0),
+entryIdx_(0),
+pass_(0),
+playedMask_(0),
+passSeed_(seed),
+rng_(seed)
+{}
+
+/**
+ * @brief Construct a playlist of step sources
+ * 
+ * @param sources - entries
+ * @param count - number of entries
+ * @param order - in order or shuffled
+ * @param seed - shuffle seed
+ */
+PlaylistSource::PlaylistSource(IStepSource* const* sources, size_t count, PlaylistOrder order, uint16_t seed):
+melodies_(nullptr),
+sources_(sources),
+count_(sources ? count : 0),
+repeats_(nullptr),
+order_(order),
+melodyAdapter_(),
+current_(nullptr),
+played_(0),
+entryIdx_(0),
+pass_(0),
+playedMask_(0),
+passSeed_(seed),
+rng_(seed)
+{}
+
+/**
+ * @brief Set how many times in a row each entry plays
+ * 
+ * @details Takes effect from the next entry: call it before play().
+ * 
+ * @param repeats - one count per entry, 0 skips the entry (nullptr: every entry once)
+ */
+void PlaylistSource::setRepeats(const uint8_t* repeats)
+{
+    repeats_ = repeats;
+}
+
+/**
+ * @brief Get the index of the entry being played
+ * 
+ * @return size_t 
+ */
+size_t PlaylistSource::currentEntry() const
+{
+    return entryIdx_;
+}
+
+/**
+ * @brief Go back to the start of the current pass (same shuffle order)
+ */
+void PlaylistSource::rewind()
+{
+    current_ = nullptr;
+    played_ = 0;
+    pass_ = 0;
+    playedMask_ = 0;
+    rng_ = XorShift16(passSeed_);
+}
+
+/**
+ * @brief Start a new pass of the playlist (a new shuffle order)
+ * 
+ * @return true - shuffled: the order changed
+ * @return false - in order: same steps again
+ */
+bool PlaylistSource::nextPass()
+{
+    if (order_ == PlaylistOrder::Shuffle)
+    {
+        XorShift16 seeds(passSeed_);
+        passSeed_ = seeds.next();
+    }
+
+    rewind();
+    return (order_ == PlaylistOrder::Shuffle && count_ > 1);
+}
+
+/**
+ * @brief Produce the next step, moving to the next entry when the current one ends
+ * 
+ * @details
+ *  1. Step of the current entry
+ *  2. Entry over: play it again until its repeat count is reached
+ *  3. Then the next entry of the pass
+ * 
+ * @param step - output Step
+ * @return true - a step was produced
+ * @return false - every entry of this pass was played
+ */
+bool PlaylistSource::next(Step& step)
+{
+    // Empty and skipped entries are passed over: at most count_ entries are tried
+    while (true)
+    {
+        // 1. Current entry
+        if (current_ != nullptr && current_->next(step)) return true;
+
+        // 2. Repeat
+        if (current_ != nullptr && ++pass_ < repeatsOf_(entryIdx_))
+        {
+            startEntry_();
+            continue;
+        }
+
+        // 3. Next entry
+        if (!startNextEntry_()) return false;
+    }
+}
+
+/**
+ * @brief Check if the playlist can be replayed
+ * 
+ * @return true - melodies, or step sources that are all replayable themselves
+ */
+bool PlaylistSource::isReplayable() const
+{
+    if (sources_ == nullptr) return true;
+
+    for (size_t i = 0; i < count_; ++i)
+    {
+        if (sources_[i] != nullptr && !sources_[i]->isReplayable()) return false;
+    }
+    return true;
+}
+
+//////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+/**
+ * @brief Pick the next entry of the pass and rewind it
+ * 
+ * @return true - current_ points to the new entry (nullptr if it is empty or repeated 0 times)
+ * @return false - all the entries of the pass were played
+ */
+bool PlaylistSource::startNextEntry_()
+{
+    if (played_ >= count_)
+    {
+        current_ = nullptr;
+        return false;
+    }
+
+    entryIdx_ = (order_ == PlaylistOrder::Shuffle) ? pickShuffled_() : played_;
+    ++played_;
+    pass_ = 0;
+
+    if (repeatsOf_(entryIdx_) == 0)
+    {
+        current_ = nullptr;
+        return true;
+    }
+
+    startEntry_();
+    return true;
+}
+
+/**
+ * @brief Point current_ at the start of the current entry
+ */
+void PlaylistSource::startEntry_()
+{
+    if (melodies_ != nullptr)
+    {
+        melodyAdapter_.reset(melodies_[entryIdx_]);
+        current_ = &melodyAdapter_;
+    }
+    else
+    {
+        current_ = sources_[entryIdx_];
+        if (current_ != nullptr) current_->rewind();
+    }
+}
+
+/**
+ * @brief Get how many times in a row an entry plays
+ * 
+ * @param entry - entry index
+ * @return uint8_t - its repeat count, 1 without setRepeats()
+ */
+uint8_t PlaylistSource::repeatsOf_(size_t entry) const
+{
+    return (repeats_ != nullptr) ? repeats_[entry] : 1;
+}
+
+/**
+ * @brief Pick the next entry in shuffle order
+ * 
+ * @details
+ * Up to 32 entries a bit mask guarantees every entry plays once per pass (a real shuffle).
+ * Longer playlists pick at random, only avoiding to repeat the previous entry.
+ * 
+ * @return size_t - entry index
+ */
+size_t PlaylistSource::pickShuffled_()
+{
+    if (count_ <= SHUFFLE_MASK_BITS)
+    {
+        // n-th entry not played yet in this pass
+        size_t nth = rng_.below((uint16_t)(count_ - played_));
+        for (size_t i = 0; i < count_; ++i)
+        {
+            uint32_t bit = (1UL << i);
+            if (playedMask_ & bit) continue;
+            if (nth-- == 0)
+            {
+                playedMask_ |= bit;
+                return i;
+            }
+        }
+        return 0;   // unreachable while played_ < count_
+    }
+
+    size_t pick = rng_.below((uint16_t)count_);
+    if (pick == entryIdx_ && played_ > 0) pick = (pick + 1) % count_;
+    return pick;
+}
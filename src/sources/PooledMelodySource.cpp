@@ -0,0 +1,122 @@
+#include "sources/PooledMelodySource.h"
+
+/**
+ * @brief Construct an empty Pooled Melody Source (next() returns false until reset() is called)
+ *
+ * @param pool - pool the melodies come from
+ */
+PooledMelodySource::PooledMelodySource(MelodyPool& pool):
+pool_(pool),
+handle_(MelodyHandle{ MelodyHandle::INVALID_SLOT, 0 }),
+block_(MelodyPool::END_OF_CHAIN),
+offset_(0),
+nextIdx_(0),
+count_(0)
+{}
+
+/**
+ * @brief Destroy the Pooled Melody Source, releasing its melody
+ */
+PooledMelodySource::~PooledMelodySource()
+{
+    clear();
+}
+
+/**
+ * @brief Reference a melody and rewind
+ *
+ * @details The new reference is taken before the old one is dropped, so resetting to the melody
+ * already held never frees it.
+ *
+ * @param handle - melody to play
+ * @return true - the source now plays it
+ * @return false - stale handle, the source is empty
+ */
+bool PooledMelodySource::reset(MelodyHandle handle)
+{
+    bool ok = pool_.acquire(handle);
+    clear();
+    if (!ok) return false;
+
+    handle_ = handle;
+    count_ = pool_.stepCount(handle);
+    rewind();
+    return true;
+}
+
+/**
+ * @brief Release the melody
+ */
+void PooledMelodySource::clear()
+{
+    if (!handle_.isNull()) pool_.release(handle_);
+
+    handle_ = MelodyHandle{ MelodyHandle::INVALID_SLOT, 0 };
+    block_ = MelodyPool::END_OF_CHAIN;
+    offset_ = 0;
+    nextIdx_ = 0;
+    count_ = 0;
+}
+
+/**
+ * @brief Get the melody referenced
+ *
+ * @return MelodyHandle - null when empty
+ */
+MelodyHandle PooledMelodySource::handle() const
+{
+    return handle_;
+}
+
+/**
+ * @brief Go back to the first step of the melody
+ */
+void PooledMelodySource::rewind()
+{
+    block_ = pool_.firstBlock(handle_);
+    offset_ = 0;
+    nextIdx_ = 0;
+}
+
+/**
+ * @brief Copy the next step of the melody
+ *
+ * @param step - output Step
+ * @return true - if there was a step
+ * @return false - end of the melody (or no melody)
+ */
+bool PooledMelodySource::next(Step& step)
+{
+    if (nextIdx_ >= count_ || block_ == MelodyPool::END_OF_CHAIN) return false;
+
+    step = pool_.blockSteps(block_)[offset_];
+    ++nextIdx_;
+    if (++offset_ == MelodyPool::BLOCK_STEPS)
+    {
+        offset_ = 0;
+        block_ = pool_.nextBlock(block_);
+    }
+    return true;
+}
+
+/**
+ * @brief Jump to a step of the melody
+ *
+ * @details Follows the chain one block at a time: O(index / BLOCK_STEPS).
+ *
+ * @param index - step the next call to next() returns
+ * @return false - if index is past the end of the melody
+ */
+bool PooledMelodySource::seek(size_t index)
+{
+    if (index > count_) return false;
+
+    rewind();
+    for (size_t skip = index / MelodyPool::BLOCK_STEPS; skip > 0; --skip)
+    {
+        block_ = pool_.nextBlock(block_);
+    }
+    offset_ = index % MelodyPool::BLOCK_STEPS;
+    nextIdx_ = (uint16_t)index;
+    return true;
+}
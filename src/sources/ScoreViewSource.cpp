@@ -0,0 +1,46 @@
+#include "sources/ScoreViewSource.h"
+
+/**
+ * @brief Construct a new Score View Source
+ * 
+ * @param view - notes to play
+ * @param ctx - tempo and articulation gap used to convert the notes
+ */
+ScoreViewSource::ScoreViewSource(score::ScoreView view, const MelodyContext& ctx):
+NoteStepSource(ctx),
+view_(view),
+nextIdx_(0)
+{}
+
+/**
+ * @brief Point the source to another score and rewind it
+ * 
+ * @param view - notes to play
+ */
+void ScoreViewSource::reset(score::ScoreView view)
+{
+    view_ = view;
+    rewind();
+}
+
+/**
+ * @brief Read the next note of the view
+ * 
+ * @param note - output note
+ * @return false when the view is exhausted
+ */
+bool ScoreViewSource::nextNote_(score::ScoreNote& note)
+{
+    if (view_.data == nullptr || nextIdx_ >= view_.count) return false;
+
+    note = view_.data[nextIdx_++];
+    return true;
+}
+
+/**
+ * @brief Go back to the first note of the view
+ */
+void ScoreViewSource::rewindNotes_()
+{
+    nextIdx_ = 0;
+}
@@ -0,0 +1,343 @@
+#include "sources/StreamingSource.h"
+#include "logger/Logger.h"
+
+constexpr uint16_t StreamingSource::UNDERRUN_REST_MS;
+
+/**
+ * @brief Construct a new Streaming Source
+ *
+ * @param buffer - ring storage
+ * @param capacity - slots in buffer
+ */
+StreamingSource::StreamingSource(Step* buffer, uint16_t capacity):
+buffer_(buffer),
+capacity_(buffer != nullptr ? capacity : 0),
+head_(0),
+count_(0),
+producer_(nullptr),
+rewinder_(nullptr),
+context_(nullptr),
+ended_(true),
+consumed_(false),
+underruns_(0),
+underrunMs_(0),
+lowWatermark_(capacity_),
+produced_(0)
+{}
+
+/**
+ * @brief Refill from a callback
+ *
+ * @details The ring is emptied: the steps of the previous producer are dropped.
+ *
+ * @param producer - writes steps into the ring
+ * @param context - passed back to producer and rewinder
+ * @param rewinder - restarts the producer, nullptr if it cannot
+ */
+void StreamingSource::setProducer(StepProducer producer, void* context, void (*rewinder)(void*))
+{
+    producer_ = producer;
+    rewinder_ = rewinder;
+    context_ = context;
+
+    head_ = 0;
+    count_ = 0;
+    ended_ = (producer == nullptr);
+    consumed_ = false;
+    produced_ = 0;
+}
+
+/**
+ * @brief Refill from another step source
+ *
+ * @param upstream - source to pull from
+ */
+void StreamingSource::setProducer(IStepSource& upstream)
+{
+    upstream.rewind();
+    setProducer(&StreamingSource::pullSource_, &upstream, &StreamingSource::rewindSource_);
+}
+
+/**
+ * @brief Move steps from the producer into the free slots
+ *
+ * @details The free slots can wrap around the end of the ring: the producer is then called
+ * twice, once per contiguous part.
+ *
+ * @param maxSteps - steps to produce at most
+ * @return uint16_t - steps added
+ */
+uint16_t StreamingSource::refill(uint16_t maxSteps)
+{
+    uint16_t added = 0;
+
+    for (uint8_t part = 0; part < 2 && added < maxSteps; ++part)
+    {
+        uint16_t got = produce_(maxSteps - added);
+        if (got == 0) break;
+        added += got;
+    }
+    return added;
+}
+
+/**
+ * @brief Get the steps buffered
+ *
+ * @return uint16_t
+ */
+uint16_t StreamingSource::buffered() const
+{
+    return count_;
+}
+
+/**
+ * @brief Check if the stream is over
+ *
+ * @return true - the producer ended and the ring is empty
+ */
+bool StreamingSource::isDrained() const
+{
+    return ended_ && count_ == 0;
+}
+
+/**
+ * @brief Get the step boundaries that found the ring empty
+ *
+ * @return uint16_t - saturates at 65535
+ */
+uint16_t StreamingSource::underruns() const
+{
+    return underruns_;
+}
+
+/**
+ * @brief Get the rest inserted while starving
+ *
+ * @return uint32_t - ms
+ */
+uint32_t StreamingSource::underrunMs() const
+{
+    return underrunMs_;
+}
+
+/**
+ * @brief Get the fewest steps buffered at a step boundary
+ *
+ * @return uint16_t
+ */
+uint16_t StreamingSource::lowWatermark() const
+{
+    return lowWatermark_;
+}
+
+/**
+ * @brief Get the steps produced since the start of the stream
+ *
+ * @return uint32_t
+ */
+uint32_t StreamingSource::produced() const
+{
+    return produced_;
+}
+
+/**
+ * @brief Clear the underrun counters
+ */
+void StreamingSource::resetCounters()
+{
+    underruns_ = 0;
+    underrunMs_ = 0;
+    lowWatermark_ = capacity_;
+}
+
+/**
+ * @brief Go back to the start of the stream
+ *
+ * @details
+ * The player rewinds a source when it starts playing it: a ring filled before play() and not
+ * read yet is already at the start, so it is kept. Otherwise the ring is emptied, the producer
+ * restarted and the ring filled again (if it has a rewinder, else the stream stays ended).
+ */
+void StreamingSource::rewind()
+{
+    if (!consumed_) return;
+
+    head_ = 0;
+    count_ = 0;
+    consumed_ = false;
+    produced_ = 0;
+
+    ended_ = (producer_ == nullptr || rewinder_ == nullptr);
+    if (ended_) return;
+
+    // Loop: the first steps are needed right now, not at the next refill()
+    rewinder_(context_);
+    refill();
+}
+
+/**
+ * @brief Take the next step out of the ring
+ *
+ * @details
+ *  1. Track the low watermark
+ *  2. Empty ring before the end of the stream (underrun): call the producer now, and if it has
+ *     nothing either, play a short rest instead of ending the playback
+ *  3. Pop the oldest step
+ *
+ * @param step - output Step
+ * @return true - a step (or an underrun rest) was produced
+ * @return false - the stream ended and every step was played
+ */
+bool StreamingSource::next(Step& step)
+{
+    consumed_ = true;
+
+    // 1. Watermark (the ring running dry at the end of the stream is not a starvation)
+    if (!ended_ && count_ < lowWatermark_) lowWatermark_ = count_;
+
+    // 2. Underrun
+    if (count_ == 0)
+    {
+        if (ended_) return false;
+
+        if (underruns_ < 0xFFFF) ++underruns_;
+        refill();
+
+        if (count_ == 0)
+        {
+            if (ended_) return false;
+
+            LOGD("stream underrun");
+            step.freqHz = 0;
+            step.durationMs = UNDERRUN_REST_MS;
+            underrunMs_ += UNDERRUN_REST_MS;
+            return true;
+        }
+    }
+
+    // 3. Oldest step
+    step = buffer_[head_];
+    if (++head_ == capacity_) head_ = 0;
+    --count_;
+    return true;
+}
+
+/**
+ * @brief Check if the stream can be indexed
+ *
+ * @details Even with a rewinder, reading it to the end would run the whole producer at once
+ * (twice: to index it, then to get back to the playback position) inside a position query.
+ *
+ * @return false - a stream is only read forward
+ */
+bool StreamingSource::isReplayable() const
+{
+    return false;
+}
+
+/**
+ * @brief Jump to a step of the stream
+ *
+ * @details Loop sections use it. Without a rewinder the steps before the ring are gone: nothing
+ * is touched.
+ *  1. Restart the producer on an empty ring
+ *  2. Drop the steps before index straight from the producer: skipping is not playing, so no
+ *     underrun, watermark or underrun rest is counted (a rest would also count as a step)
+ *  3. Fill the ring from index
+ *
+ * @param index - step the next call to next() returns
+ * @return false - no rewinder, or the producer ended or had nothing before index (the ring is
+ *  then left empty)
+ */
+bool StreamingSource::seek(size_t index)
+{
+    if (producer_ == nullptr || rewinder_ == nullptr) return false;
+
+    // 1. Restart
+    head_ = 0;
+    count_ = 0;
+    produced_ = 0;
+    ended_ = false;
+    consumed_ = (index > 0);
+    rewinder_(context_);
+
+    // 2. Skip
+    for (size_t skipped = 0; skipped < index; )
+    {
+        if (count_ == 0 && produce_(capacity_) == 0) return false;
+
+        uint16_t drop = (index - skipped < count_) ? (uint16_t)(index - skipped) : count_;
+        head_ += drop;
+        if (head_ >= capacity_) head_ -= capacity_;
+        count_ -= drop;
+        skipped += drop;
+    }
+
+    // 3. Refill
+    refill();
+    return true;
+}
+
+//////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+/**
+ * @brief Call the producer once on the contiguous free slots after the last buffered step
+ *
+ * @param maxSteps - steps to produce at most
+ * @return uint16_t - steps added
+ */
+uint16_t StreamingSource::produce_(uint16_t maxSteps)
+{
+    if (ended_ || count_ == capacity_) return 0;
+
+    // Free slots from the tail to the end of the ring, or to the head when it wrapped
+    uint16_t tail = head_ + count_;
+    if (tail >= capacity_) tail -= capacity_;
+    uint16_t free = (tail >= head_) ? capacity_ - tail : head_ - tail;
+    if (free > maxSteps) free = maxSteps;
+
+    bool ended = false;
+    uint16_t got = producer_(buffer_ + tail, free, ended, context_);
+    if (got > free) got = free;
+
+    count_ += got;
+    produced_ += got;
+    if (ended) ended_ = true;
+    return got;
+}
+
+/**
+ * @brief Producer over an IStepSource: pull up to maxSteps
+ *
+ * @param dest - free slots
+ * @param maxSteps - slots available
+ * @param ended - set when the upstream source is exhausted
+ * @param context - the upstream IStepSource
+ * @return uint16_t - steps written
+ */
+uint16_t StreamingSource::pullSource_(Step* dest, uint16_t maxSteps, bool& ended, void* context)
+{
+    IStepSource* upstream = static_cast<IStepSource*>(context);
+
+    uint16_t n = 0;
+    while (n < maxSteps)
+    {
+        if (!upstream->next(dest[n]))
+        {
+            ended = true;
+            break;
+        }
+        ++n;
+    }
+    return n;
+}
+
+/**
+ * @brief Rewinder over an IStepSource
+ *
+ * @param context - the upstream IStepSource
+ */
+void StreamingSource::rewindSource_(void* context)
+{
+    static_cast<IStepSource*>(context)->rewind();
+}
@@ -0,0 +1,397 @@
+#include "storage/MelodyBank.h"
+#include "codec/ScoreCodec.h"
+#include "core/Crc16.h"
+#include "logger/Logger.h"
+
+constexpr uint16_t MelodyBank::SLOT_BYTES;
+constexpr uint8_t MelodyBank::HEADER_BYTES;
+constexpr uint16_t MelodyBank::MAX_PAYLOAD;
+constexpr uint8_t MelodyBank::MAX_TONES;
+constexpr uint8_t MelodyBank::NO_SLOT;
+
+namespace
+{
+    // Record header offsets
+    constexpr uint8_t OFF_MAGIC     = 0;
+    constexpr uint8_t OFF_TONE      = 1;
+    constexpr uint8_t OFF_SEQUENCE  = 2;
+    constexpr uint8_t OFF_LENGTH    = 4;
+    constexpr uint8_t OFF_CRC       = 6;
+
+    constexpr uint8_t MAGIC_VALID       = 0xA5;
+    constexpr uint8_t MAGIC_INVALIDATED = 0x00;
+
+    /// @brief a was written after b (sequences wrap)
+    bool isNewer(uint16_t a, uint16_t b)
+    {
+        return (int16_t)(a - b) > 0;
+    }
+}
+
+/**
+ * @brief Construct a new Melody Bank
+ *
+ * @param baseAddress - first EEPROM byte of the bank
+ * @param sizeBytes - bytes of EEPROM given to the bank
+ * @param tones - tone numbers in use
+ */
+MelodyBank::MelodyBank(uint16_t baseAddress, uint16_t sizeBytes, uint8_t tones):
+base_(baseAddress),
+slots_(0),
+tones_(0),
+nextSequence_(0),
+writeSlot_(0),
+corrupt_(0)
+{
+    // Whole slots inside the EEPROM
+    uint16_t available = (baseAddress < eeprom::SIZE) ? eeprom::SIZE - baseAddress : 0;
+    if (sizeBytes > available) sizeBytes = available;
+    uint16_t slots = sizeBytes / SLOT_BYTES;
+    slots_ = (slots < NO_SLOT) ? (uint8_t)slots : NO_SLOT - 1;
+
+    // One spare slot at least, so a tone is never rewritten in place
+    if (tones > MAX_TONES) tones = MAX_TONES;
+    if (slots_ == 0) tones = 0;
+    else if (tones >= slots_) tones = slots_ - 1;
+    tones_ = tones;
+
+    for (uint8_t t = 0; t < MAX_TONES; ++t) directory_[t] = NO_SLOT;
+}
+
+/**
+ * @brief Scan the records and rebuild the directory
+ *
+ * @details
+ *  1. Read every record header and check its CRC
+ *  2. Per tone keep the newest valid record. Two copies only exist after a store interrupted
+ *     before it retired the previous copy: the older one is invalidated now, or erase() of the
+ *     tone would bring it back at the next mount()
+ *  3. The rotation continues after the newest record of the bank
+ *
+ * @return uint8_t - tones found
+ */
+uint8_t MelodyBank::mount()
+{
+    uint16_t newest[MAX_TONES];
+    bool any = false;
+    uint16_t maxSequence = 0;
+    uint8_t maxSlot = 0;
+
+    corrupt_ = 0;
+    for (uint8_t t = 0; t < MAX_TONES; ++t) directory_[t] = NO_SLOT;
+
+    // 1. Headers
+    for (uint8_t slot = 0; slot < slots_; ++slot)
+    {
+        uint8_t tone;
+        uint16_t sequence, length;
+        bool corrupt;
+
+        if (!readRecord(slot, tone, sequence, length, corrupt))
+        {
+            if (corrupt) ++corrupt_;
+            continue;
+        }
+
+        if (!any || isNewer(sequence, maxSequence))
+        {
+            maxSequence = sequence;
+            maxSlot = slot;
+            any = true;
+        }
+
+        // 2. Newest copy of the tone, the other one is retired
+        if (tone >= tones_) continue;
+        if (directory_[tone] == NO_SLOT)
+        {
+            directory_[tone] = slot;
+            newest[tone] = sequence;
+            continue;
+        }
+
+        uint8_t older = slot;
+        if (isNewer(sequence, newest[tone]))
+        {
+            older = directory_[tone];
+            directory_[tone] = slot;
+            newest[tone] = sequence;
+        }
+        eeprom::updateByte(slotAddress(older) + OFF_MAGIC, MAGIC_INVALIDATED);
+        LOGD("bank: tone %u duplicate in slot %u retired", (unsigned)tone, (unsigned)older);
+    }
+
+    // 3. Rotation
+    nextSequence_ = any ? maxSequence + 1 : 0;
+    writeSlot_ = any ? (maxSlot + 1) % slots_ : 0;
+
+    uint8_t found = 0;
+    for (uint8_t t = 0; t < tones_; ++t)
+    {
+        if (directory_[t] != NO_SLOT) ++found;
+    }
+
+    LOGI("bank mounted: %u tones, %u corrupt records", (unsigned)found, (unsigned)corrupt_);
+    return found;
+}
+
+/**
+ * @brief Encode a score and store it as a tone
+ *
+ * @param tone - tone number
+ * @param notes - score
+ * @param count - notes in the score
+ * @return true - stored and verified
+ */
+bool MelodyBank::store(uint8_t tone, const score::ScoreNote* notes, uint16_t count)
+{
+    uint8_t encoded[MAX_PAYLOAD];
+
+    size_t length = codec::encodeScore(notes, count, encoded, sizeof(encoded));
+    if (length == 0) return false;
+
+    return storeEncoded(tone, encoded, (uint16_t)length);
+}
+
+/**
+ * @brief Store an encoded score as a tone
+ *
+ * @details
+ *  1. Pick the next slot in rotation that holds no live tone
+ *  2. Invalidate it first, then write payload and header, and the magic byte last: until then
+ *     the slot is not a record, so an interrupted write never shadows the previous copy
+ *  3. Read it back (CRC)
+ *  4. Invalidate the previous copy of the tone and update the directory
+ *
+ * @param tone - tone number
+ * @param encoded - encoded bytes
+ * @param length - bytes
+ * @return true - stored and verified
+ */
+bool MelodyBank::storeEncoded(uint8_t tone, const uint8_t* encoded, uint16_t length)
+{
+    if (tone >= tones_ || encoded == nullptr || length == 0 || length > MAX_PAYLOAD) return false;
+
+    // 1. Slot
+    uint8_t slot = nextFreeSlot();
+    if (slot == NO_SLOT) return false;
+    uint16_t address = slotAddress(slot);
+
+    // 2. Write, magic last
+    eeprom::updateByte(address + OFF_MAGIC, MAGIC_INVALIDATED);
+
+    uint16_t sequence = nextSequence_;
+    uint16_t crc = crc16::INIT;
+    crc = crc16::update(crc, tone);
+    crc = crc16::update(crc, (uint8_t)sequence);
+    crc = crc16::update(crc, (uint8_t)(sequence >> 8));
+    crc = crc16::update(crc, (uint8_t)length);
+    crc = crc16::update(crc, (uint8_t)(length >> 8));
+    crc = crc16::compute(encoded, length, crc);
+
+    for (uint16_t i = 0; i < length; ++i) eeprom::updateByte(address + HEADER_BYTES + i, encoded[i]);
+    eeprom::updateByte(address + OFF_TONE, tone);
+    writeWord(address + OFF_SEQUENCE, sequence);
+    writeWord(address + OFF_LENGTH, length);
+    writeWord(address + OFF_CRC, crc);
+    eeprom::updateByte(address + OFF_MAGIC, MAGIC_VALID);
+
+    // 3. Verify
+    uint8_t readTone;
+    uint16_t readSequence, readLength;
+    bool corrupt;
+    if (!readRecord(slot, readTone, readSequence, readLength, corrupt))
+    {
+        LOGI("bank: write of tone %u in slot %u did not verify", (unsigned)tone, (unsigned)slot);
+        eeprom::updateByte(address + OFF_MAGIC, MAGIC_INVALIDATED);
+        return false;
+    }
+
+    // 4. Retire the previous copy
+    if (directory_[tone] != NO_SLOT) eeprom::updateByte(slotAddress(directory_[tone]) + OFF_MAGIC, MAGIC_INVALIDATED);
+    directory_[tone] = slot;
+
+    ++nextSequence_;
+    writeSlot_ = (slot + 1) % slots_;
+
+    LOGD("bank: tone %u -> slot %u (%u bytes, seq %u)", (unsigned)tone, (unsigned)slot, (unsigned)length, (unsigned)sequence);
+    return true;
+}
+
+/**
+ * @brief Delete a tone
+ *
+ * @param tone - tone number
+ * @return true - it was stored
+ */
+bool MelodyBank::erase(uint8_t tone)
+{
+    if (!contains(tone)) return false;
+
+    eeprom::updateByte(slotAddress(directory_[tone]) + OFF_MAGIC, MAGIC_INVALIDATED);
+    directory_[tone] = NO_SLOT;
+    return true;
+}
+
+/**
+ * @brief Check if a tone is stored
+ *
+ * @param tone - tone number
+ * @return true - present
+ */
+bool MelodyBank::contains(uint8_t tone) const
+{
+    return tone < tones_ && directory_[tone] != NO_SLOT;
+}
+
+/**
+ * @brief Get the encoded size of a tone
+ *
+ * @param tone - tone number
+ * @return uint16_t - bytes, 0 if absent
+ */
+uint16_t MelodyBank::encodedSize(uint8_t tone) const
+{
+    return contains(tone) ? readWord(slotAddress(directory_[tone]) + OFF_LENGTH) : 0;
+}
+
+/**
+ * @brief Get the EEPROM address of the encoded score of a tone
+ *
+ * @param tone - tone number
+ * @return const uint8_t* - EEPROM address (MemorySpace::Eeprom), nullptr if absent
+ */
+const uint8_t* MelodyBank::scoreData(uint8_t tone) const
+{
+    if (!contains(tone)) return nullptr;
+
+    return reinterpret_cast<const uint8_t*>((uintptr_t)(slotAddress(directory_[tone]) + HEADER_BYTES));
+}
+
+/**
+ * @brief Point a source at a tone
+ *
+ * @param tone - tone number
+ * @param source - source to reset on the EEPROM record
+ * @return true - the source plays the tone
+ */
+bool MelodyBank::open(uint8_t tone, CompressedScoreSource& source) const
+{
+    const uint8_t* data = scoreData(tone);
+    if (data == nullptr) return false;
+
+    source.reset(data, codec::MemorySpace::Eeprom);
+    return true;
+}
+
+/**
+ * @brief Get the records skipped by the last mount()
+ *
+ * @return uint8_t
+ */
+uint8_t MelodyBank::corruptRecords() const
+{
+    return corrupt_;
+}
+
+/**
+ * @brief Get the slots of the bank
+ *
+ * @return uint8_t
+ */
+uint8_t MelodyBank::slotCount() const
+{
+    return slots_;
+}
+
+//////////////////////////////  PRIVATE HELPERS    ////////////////////////////////////////////////
+
+/**
+ * @brief Get the EEPROM address of a slot
+ *
+ * @param slot - slot index
+ * @return uint16_t
+ */
+uint16_t MelodyBank::slotAddress(uint8_t slot) const
+{
+    return base_ + (uint16_t)slot * SLOT_BYTES;
+}
+
+/**
+ * @brief Read a little endian 16 bits value
+ *
+ * @param address - EEPROM address of the low byte
+ * @return uint16_t
+ */
+uint16_t MelodyBank::readWord(uint16_t address)
+{
+    return (uint16_t)eeprom::readByte(address) | ((uint16_t)eeprom::readByte(address + 1) << 8);
+}
+
+/**
+ * @brief Write a little endian 16 bits value
+ *
+ * @param address - EEPROM address of the low byte
+ * @param value - value to write
+ */
+void MelodyBank::writeWord(uint16_t address, uint16_t value)
+{
+    eeprom::updateByte(address, (uint8_t)value);
+    eeprom::updateByte(address + 1, (uint8_t)(value >> 8));
+}
+
+/**
+ * @brief Check the record of a slot
+ *
+ * @param slot - slot index
+ * @param tone - output tone number
+ * @param sequence - output sequence
+ * @param length - output payload length
+ * @param corrupt - output: the slot claims a record but the CRC or the length is wrong
+ * @return true - valid record
+ */
+bool MelodyBank::readRecord(uint8_t slot, uint8_t& tone, uint16_t& sequence, uint16_t& length, bool& corrupt) const
+{
+    uint16_t address = slotAddress(slot);
+    corrupt = false;
+
+    if (eeprom::readByte(address + OFF_MAGIC) != MAGIC_VALID) return false;
+
+    tone = eeprom::readByte(address + OFF_TONE);
+    sequence = readWord(address + OFF_SEQUENCE);
+    length = readWord(address + OFF_LENGTH);
+
+    if (length == 0 || length > MAX_PAYLOAD)
+    {
+        corrupt = true;
+        return false;
+    }
+
+    uint16_t crc = crc16::INIT;
+    for (uint16_t i = OFF_TONE; i < OFF_CRC; ++i) crc = crc16::update(crc, eeprom::readByte(address + i));
+    for (uint16_t i = 0; i < length; ++i) crc = crc16::update(crc, eeprom::readByte(address + HEADER_BYTES + i));
+
+    if (crc != readWord(address + OFF_CRC))
+    {
+        corrupt = true;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Find the next slot in rotation that holds no live tone
+ *
+ * @return uint8_t - slot, NO_SLOT if the bank has none
+ */
+uint8_t MelodyBank::nextFreeSlot() const
+{
+    for (uint8_t i = 0; i < slots_; ++i)
+    {
+        uint8_t slot = (writeSlot_ + i) % slots_;
+
+        bool live = false;
+        for (uint8_t t = 0; t < tones_ && !live; ++t) live = (directory_[t] == slot);
+        if (!live) return slot;
+    }
+    return NO_SLOT;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Arduino stand-in for the native unit tests (pio test -e native)
+ *
+ * @details
+ * Only what the library uses: a clock the tests move by hand, tone() / noTone() recorded as the
+ * last frequency, no-op pins and a silent Serial (the logger prints through it).
+ * Header only, so every test suite gets it from the include path without a source to link.
+ */
+namespace arduino_shim
+{
+    /// @brief Current time of micros(), moved by the tests
+    inline unsigned long& nowUs()
+    {
+        static unsigned long us = 0;
+        return us;
+    }
+
+    /// @brief Frequency of the last tone() call, 0 after noTone()
+    inline unsigned int& toneHz()
+    {
+        static unsigned int hz = 0;
+        return hz;
+    }
+
+    struct SilentSerial
+    {
+        void begin(unsigned long) {}
+        size_t print(const char*) { return 0; }
+        size_t println(const char*) { return 0; }
+        int available() { return 0; }
+        int read() { return -1; }
+        size_t write(uint8_t) { return 1; }
+        size_t write(const uint8_t*, size_t length) { return length; }
+        explicit operator bool() const { return true; }
+    };
+
+    inline SilentSerial& serial()
+    {
+        static SilentSerial instance;
+        return instance;
+    }
+}
+
+#define OUTPUT  1
+#define INPUT   0
+#define HIGH    1
+#define LOW     0
+
+inline unsigned long micros() { return arduino_shim::nowUs(); }
+inline unsigned long millis() { return arduino_shim::nowUs() / 1000; }
+inline void delay(unsigned long ms) { arduino_shim::nowUs() += ms * 1000; }
+
+inline void tone(uint8_t, unsigned int hz, unsigned long = 0) { arduino_shim::toneHz() = hz; }
+inline void noTone(uint8_t) { arduino_shim::toneHz() = 0; }
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+#define Serial (arduino_shim::serial())
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <unity.h>
+#include "Arduino.h"
+#include "core/Types.h"
+#include "player/BatchBackend.h"
+#include "sources/StreamingSource.h"
+
+/**
+ * @brief Backends and clock helpers shared by the player test suites
+ *
+ * @details
+ * The backends record the frequency of every step they start sounding (0 when silenced), so a
+ * test compares what was heard with what the melody holds. heard() drops the silences and the
+ * repeat of a step resumed after a pause: the melodies of the tests use a distinct frequency per
+ * step, so what is left is the order of the steps.
+ */
+namespace test_support
+{
+    constexpr size_t MAX_EVENTS = 2048;
+    constexpr uint32_t TICK_US = 100;           // clock resolution of run()
+
+    /// @brief Frequencies started by a backend, in order, and when
+    struct Recorder
+    {
+        uint16_t events[MAX_EVENTS];
+        unsigned long atUs[MAX_EVENTS];
+        size_t count = 0;
+
+        void add(uint16_t hz, unsigned long us = micros())
+        {
+            if (count >= MAX_EVENTS) return;
+            atUs[count] = us;
+            events[count++] = hz;
+        }
+
+        /// @brief Steps heard, silences and resumed repeats removed
+        size_t heard(uint16_t* out, size_t capacity) const
+        {
+            size_t n = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (events[i] == 0 || (n > 0 && out[n - 1] == events[i])) continue;
+                if (n < capacity) out[n++] = events[i];
+            }
+            return n;
+        }
+    };
+
+    /// @brief Backend driven by the player timer (start / stop per step)
+    struct PlainBackend
+    {
+        Recorder log;
+
+        void start(uint16_t hz) { log.add(hz); }
+        void stop() { log.add(0); }
+        void tick() {}
+    };
+
+    /// @brief Batch backend with a window of 3 steps, timed by the shim clock
+    struct BatchBackend
+    {
+        static constexpr uint8_t BATCH_WINDOW = 3;
+
+        Recorder log;
+        BatchStep queue[BATCH_WINDOW];
+        uint8_t queued = 0;
+        uint8_t completed = 0;
+        unsigned long headStartUs = 0;
+
+        void start(uint16_t hz) { log.add(hz); }
+        void stop() { queued = 0; log.add(0); }
+
+        uint8_t freeSlots() const { return BATCH_WINDOW - queued; }
+        uint8_t takeCompleted() { uint8_t done = completed; completed = 0; return done; }
+        uint32_t elapsedUs() const { return queued > 0 ? micros() - headStartUs : 0; }
+
+        void push(const BatchStep& step)
+        {
+            queue[queued++] = step;
+            if (queued == 1) startHead(micros());
+        }
+
+        /// @brief Play: retire the steps whose time is over
+        void tick()
+        {
+            while (queued > 0 && micros() - headStartUs >= queue[0].durationUs)
+            {
+                unsigned long endUs = headStartUs + queue[0].durationUs;
+                for (uint8_t i = 1; i < queued; ++i) queue[i - 1] = queue[i];
+                --queued;
+                ++completed;
+
+                if (queued > 0) startHead(endUs);
+                else log.add(0);
+            }
+        }
+
+        /// @brief The head step starts at us (the end of the previous one when chained)
+        void startHead(unsigned long us)
+        {
+            headStartUs = us;
+            log.add(queue[0].freqHz, us);
+        }
+    };
+
+    /// @brief Run the player for ms, refilling a stream like loop() would
+    template<class Player, class Backend>
+    void run(Player& player, Backend& backend, uint32_t ms, StreamingSource* stream = nullptr)
+    {
+        unsigned long endUs = micros() + ms * 1000UL;
+        while (micros() < endUs)
+        {
+            backend.tick();
+            player.update();
+            if (stream != nullptr) stream->refill();
+            arduino_shim::nowUs() += TICK_US;
+        }
+    }
+
+    /// @brief Run the player until it stops (at most limitMs)
+    template<class Player, class Backend>
+    void runToEnd(Player& player, Backend& backend, StreamingSource* stream = nullptr, uint32_t limitMs = 60000)
+    {
+        for (uint32_t ms = 0; player.isPlaying() && ms < limitMs; ++ms) run(player, backend, 1, stream);
+    }
+
+    /// @brief Check the steps heard against the expected frequencies
+    inline void assertHeard(const Recorder& log, const uint16_t* expected, size_t count)
+    {
+        static uint16_t heard[MAX_EVENTS];
+        size_t n = log.heard(heard, MAX_EVENTS);
+
+        TEST_ASSERT_EQUAL(count, n);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, heard, count);
+    }
+
+    /// @brief Producer of a stream of steps 1, 2, ... count Hz (2 ms each)
+    struct CountingStream
+    {
+        uint16_t next = 0;
+        uint16_t count;
+
+        explicit CountingStream(uint16_t steps) : count(steps) {}
+
+        static uint16_t produce(Step* dest, uint16_t maxSteps, bool& ended, void* context)
+        {
+            CountingStream* self = static_cast<CountingStream*>(context);
+            uint16_t written = 0;
+            while (written < maxSteps && self->next < self->count)
+            {
+                ++self->next;
+                dest[written++] = Step{self->next, 2};
+            }
+            ended = (self->next >= self->count);
+            return written;
+        }
+
+        static void restart(void* context)
+        {
+            static_cast<CountingStream*>(context)->next = 0;
+        }
+    };
+}
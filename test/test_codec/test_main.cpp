@@ -0,0 +1,117 @@
+#include <unity.h>
+#include "codec/ScoreCodec.h"
+#include "music/Notes.h"
+#include "music/Durations.h"
+
+// Round trip of the compressed score format: every kind of pitch and rhythm code decodes back to
+// the note it was encoded from.
+
+namespace
+{
+    constexpr size_t BUFFER_SIZE = 1024;
+
+    /// @brief Encode, decode and compare
+    void checkRoundTrip(const score::ScoreNote* notes, uint16_t count, codec::MemorySpace space = codec::MemorySpace::Ram)
+    {
+        static uint8_t encoded[BUFFER_SIZE];
+        size_t size = codec::encodeScore(notes, count, encoded, sizeof(encoded));
+        TEST_ASSERT_TRUE(size > 0);
+
+        codec::ScoreDecoder decoder(encoded, space);
+        TEST_ASSERT_EQUAL_UINT16(count, decoder.count());
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            score::ScoreNote note;
+            for (uint16_t i = 0; i < count; ++i)
+            {
+                TEST_ASSERT_TRUE(decoder.next(note));
+                TEST_ASSERT_EQUAL_UINT16(notes[i].hz, note.hz);
+                TEST_ASSERT_EQUAL_UINT8(notes[i].denom, note.denom);
+            }
+            TEST_ASSERT_FALSE(decoder.next(note));
+            decoder.rewind();
+        }
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_steps_rests_and_repeated_rhythm()
+{
+    const score::ScoreNote notes[] = {
+        {notes::C5, durations::Eighth},
+        {notes::D5, durations::Eighth},
+        {notes::REST, durations::Eighth},
+        {notes::E5, durations::Quarter},
+        {notes::REST, durations::Quarter},
+        {notes::C5, durations::Half}
+    };
+    checkRoundTrip(notes, 6);
+}
+
+void test_leaps_raw_frequencies_and_raw_denoms()
+{
+    const score::ScoreNote notes[] = {
+        {notes::C2, durations::Whole},
+        {notes::C5, durations::ThirtySecond},       // leap: absolute index
+        {1234, 3},                                  // off the chromatic table, raw denom
+        {notes::C4, 3},
+        {notes::C4, durations::Sixteenth}
+    };
+    checkRoundTrip(notes, 5);
+}
+
+void test_step_wise_melody_is_smaller_than_its_score()
+{
+    static score::ScoreNote notes[64];
+    const uint16_t scale[] = {notes::C5, notes::D5, notes::E5, notes::F5, notes::G5, notes::F5, notes::E5, notes::D5};
+    for (uint16_t i = 0; i < 64; ++i) notes[i] = score::ScoreNote{scale[i % 8], durations::Eighth};
+
+    static uint8_t encoded[BUFFER_SIZE];
+    size_t size = codec::encodeScore(notes, 64, encoded, sizeof(encoded));
+    TEST_ASSERT_TRUE(size > 0);
+    TEST_ASSERT_TRUE(size < 64);                    // 6 bits a note, 3 bytes in a ScoreNote
+    checkRoundTrip(notes, 64, codec::MemorySpace::Flash);
+}
+
+void test_long_score_uses_the_two_bytes_header()
+{
+    static score::ScoreNote notes[300];
+    for (uint16_t i = 0; i < 300; ++i) notes[i] = score::ScoreNote{(i % 3) ? notes::C5 : notes::E5, durations::Sixteenth};
+    checkRoundTrip(notes, 300);
+}
+
+void test_small_buffer_is_rejected()
+{
+    const score::ScoreNote notes[] = {{notes::C5, durations::Quarter}, {notes::C2, durations::Half}};
+    uint8_t encoded[2];
+    TEST_ASSERT_EQUAL(0, codec::encodeScore(notes, 2, encoded, sizeof(encoded)));
+}
+
+void test_empty_score()
+{
+    uint8_t encoded[4];
+    TEST_ASSERT_TRUE(codec::encodeScore(nullptr, 0, encoded, sizeof(encoded)) > 0);
+
+    codec::ScoreDecoder decoder(encoded, codec::MemorySpace::Ram);
+    score::ScoreNote note;
+    TEST_ASSERT_EQUAL_UINT16(0, decoder.count());
+    TEST_ASSERT_FALSE(decoder.next(note));
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_steps_rests_and_repeated_rhythm);
+    RUN_TEST(test_leaps_raw_frequencies_and_raw_denoms);
+    RUN_TEST(test_step_wise_melody_is_smaller_than_its_score);
+    RUN_TEST(test_long_score_uses_the_two_bytes_header);
+    RUN_TEST(test_small_buffer_is_rejected);
+    RUN_TEST(test_empty_score);
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+#include <unity.h>
+#include "PlayerTestSupport.h"
+#include "core/SpscRing.h"
+#include "player/BuzzerPlayer.h"
+#include "player/PlayerCommandQueue.h"
+
+// SpscRing keeps the order and the capacity across the wrap of its free running indices, and the
+// command queue applies the posted commands to the player in order, only from update().
+
+using namespace test_support;
+
+typedef BasicBuzzerPlayer<PlainBackend> Player;
+
+template<uint8_t Capacity>
+using Commands = BasicPlayerCommandQueue<Capacity, Player>;
+
+namespace
+{
+    const Step MELODY[] = {{101, 100}, {102, 100}, {103, 100}};
+    const Step ALARM[] = {{201, 50}, {202, 50}};
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_ring_is_fifo_across_the_index_wrap()
+{
+    SpscRing<uint16_t, 8> ring;
+    uint16_t pushed = 0, popped = 0, value;
+
+    // 1000 elements through a ring of 8: the uint8_t indices wrap several times
+    while (popped < 1000)
+    {
+        while (pushed < 1000 && ring.push(pushed)) ++pushed;
+        TEST_ASSERT_TRUE(ring.size() <= 8);
+
+        for (uint8_t i = 0; i < 3 && ring.pop(value); ++i)
+        {
+            TEST_ASSERT_EQUAL_UINT16(popped, value);
+            ++popped;
+        }
+    }
+    TEST_ASSERT_TRUE(ring.isEmpty());
+    TEST_ASSERT_FALSE(ring.pop(value));
+}
+
+void test_ring_full_rejects_and_counts()
+{
+    SpscRing<uint8_t, 4> ring;
+    for (uint8_t i = 0; i < 4; ++i) TEST_ASSERT_TRUE(ring.push(i));
+
+    TEST_ASSERT_FALSE(ring.push(9));
+    TEST_ASSERT_FALSE(ring.push(9));
+    TEST_ASSERT_EQUAL_UINT8(2, ring.rejected());
+    TEST_ASSERT_EQUAL_UINT8(4, ring.size());
+
+    // The rejected elements were not written over the waiting ones
+    uint8_t value;
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        TEST_ASSERT_TRUE(ring.pop(value));
+        TEST_ASSERT_EQUAL_UINT8(i, value);
+    }
+}
+
+void test_ring_rejected_count_saturates()
+{
+    SpscRing<uint8_t, 1> ring;
+    ring.push(0);
+    for (uint16_t i = 0; i < 300; ++i) ring.push(1);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, ring.rejected());
+}
+
+void test_commands_wait_for_update()
+{
+    PlainBackend backend;
+    Player player(backend);
+    Commands<8> commands(player);
+
+    TEST_ASSERT_TRUE(commands.play(Melody{MELODY, 3}));
+    TEST_ASSERT_TRUE(commands.setPlaybackRate(512));
+    TEST_ASSERT_TRUE(commands.setTranspose(12));
+    TEST_ASSERT_EQUAL_UINT8(3, commands.pending());
+    TEST_ASSERT_FALSE(player.isPlaying());
+
+    TEST_ASSERT_EQUAL_UINT8(3, commands.drain());
+    TEST_ASSERT_TRUE(player.isPlaying());
+    TEST_ASSERT_EQUAL_UINT16(512, player.playbackRate());
+    TEST_ASSERT_EQUAL_INT(12, player.transpose());
+    TEST_ASSERT_EQUAL_UINT8(0, commands.pending());
+}
+
+void test_commands_apply_in_order()
+{
+    PlainBackend backend;
+    Player player(backend);
+    Commands<8> commands(player);
+
+    commands.play(Melody{MELODY, 3});
+    commands.update();
+    run(player, backend, 50);
+
+    commands.pause();
+    commands.update();
+    TEST_ASSERT_TRUE(player.isPaused());
+
+    // Resumed, then replaced by the alarm, then stopped: only the last command counts
+    commands.resume();
+    commands.play(Melody{ALARM, 2});
+    commands.stop();
+    commands.update();
+    TEST_ASSERT_FALSE(player.isPlaying());
+
+    commands.play(Melody{ALARM, 2});
+    for (uint32_t ms = 0; ms < 500; ++ms)
+    {
+        commands.update();
+        arduino_shim::nowUs() += 1000;
+    }
+
+    const uint16_t expected[] = {101, 201, 202};
+    assertHeard(backend.log, expected, 3);
+}
+
+void test_full_queue_rejects_posts()
+{
+    PlainBackend backend;
+    Player player(backend);
+    Commands<2> commands(player);
+
+    TEST_ASSERT_TRUE(commands.stop());
+    TEST_ASSERT_TRUE(commands.stop());
+    TEST_ASSERT_FALSE(commands.pause());
+    TEST_ASSERT_EQUAL_UINT8(1, commands.rejected());
+
+    commands.drain();
+    TEST_ASSERT_TRUE(commands.pause());
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_is_fifo_across_the_index_wrap);
+    RUN_TEST(test_ring_full_rejects_and_counts);
+    RUN_TEST(test_ring_rejected_count_saturates);
+    RUN_TEST(test_commands_wait_for_update);
+    RUN_TEST(test_commands_apply_in_order);
+    RUN_TEST(test_full_queue_rejects_posts);
+    return UNITY_END();
+}
@@ -0,0 +1,393 @@
+#include <unity.h>
+#include "PlayerTestSupport.h"
+#include "player/BuzzerPlayer.h"
+#include "player/TimeIndex.h"
+#include "codec/ScoreCodec.h"
+#include "music/Notes.h"
+#include "music/Durations.h"
+#include "sources/MelodySource.h"
+#include "sources/PlaylistSource.h"
+#include "sources/StreamingSource.h"
+#include "sources/MetronomeSource.h"
+#include "sources/ScoreViewSource.h"
+#include "sources/CompressedScoreSource.h"
+
+// Batch backend: pause(), seek() and interrupt() take the window back from the backend. The steps
+// it had not played are fed again, so every kind of source plays on without losing or repeating
+// a step (the step being heard when paused is resumed, heard() counts it once).
+
+using namespace test_support;
+
+typedef BasicBuzzerPlayer<BatchBackend> Player;
+
+namespace
+{
+    constexpr uint16_t CLICK_HZ = 5000;
+
+    const Step MELODY[] = {
+        {101, 10}, {102, 10}, {103, 10}, {104, 10},
+        {105, 10}, {106, 10}, {107, 10}, {108, 10}
+    };
+    const uint16_t MELODY_HZ[] = {101, 102, 103, 104, 105, 106, 107, 108};
+
+    const score::ScoreNote SCORE[] = {
+        {notes::C5, durations::Eighth},
+        {notes::D5, durations::Eighth},
+        {notes::E5, durations::Quarter},
+        {notes::F5, durations::Eighth},
+        {notes::G5, durations::Half}
+    };
+    const uint16_t SCORE_HZ[] = {notes::C5, notes::D5, notes::E5, notes::F5, notes::G5};
+
+    const Step PART_A[] = {{201, 10}, {202, 10}, {203, 10}};
+    const Step PART_B[] = {{301, 10}, {302, 10}, {303, 10}};
+    const Step PART_C[] = {{401, 10}, {402, 10}, {403, 10}};
+    const Melody PARTS[] = {{PART_A, 3}, {PART_B, 3}, {PART_C, 3}};
+
+    const Step ALERT[] = {{CLICK_HZ, 3}};
+
+    /// @brief Melody whose seek() can be made to fail (e.g. storage that went away)
+    struct FailingSeekSource : MelodySource
+    {
+        bool failSeek = false;
+
+        bool seek(size_t index) override { return !failSeek && MelodySource::seek(index); }
+    };
+
+    /// @brief Play a source to the end, pausing and resuming every periodMs
+    void playWithPauses(Player& player, BatchBackend& backend, IStepSource& source, uint32_t periodMs, StreamingSource* stream = nullptr)
+    {
+        player.play(source);
+        for (uint32_t ms = 0; player.isPlaying() && ms < 60000; ms += periodMs)
+        {
+            run(player, backend, periodMs, stream);
+            if (player.isPaused()) player.resume();
+            else player.pause();
+        }
+        if (player.isPaused()) player.resume();
+        runToEnd(player, backend, stream);
+    }
+
+    /// @brief Steps heard apart from the alert (the step it interrupted resumes after it), and how many times the alert started
+    size_t heardWithoutAlert(const Recorder& log, uint16_t* out, size_t capacity, size_t& alerts)
+    {
+        static uint16_t heard[MAX_EVENTS];
+        size_t n = log.heard(heard, MAX_EVENTS);
+        size_t kept = 0;
+
+        alerts = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (heard[i] == CLICK_HZ) ++alerts;
+            else if (kept > 0 && out[kept - 1] == heard[i]) continue;
+            else if (kept < capacity) out[kept++] = heard[i];
+        }
+        return kept;
+    }
+
+    void startStream(StreamingSource& stream, CountingStream& producer)
+    {
+        stream.setProducer(&CountingStream::produce, &producer);
+        stream.refill();
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_melody_pause_resume_keeps_every_step()
+{
+    BatchBackend backend;
+    Player player(backend);
+    MelodySource source;
+    source.reset(Melody{MELODY, 8});
+
+    playWithPauses(player, backend, source, 7);
+    assertHeard(backend.log, MELODY_HZ, 8);
+}
+
+void test_score_sources_pause_resume_keep_every_note()
+{
+    MelodyContext ctx;
+    ctx.bpm = 600;
+
+    {
+        BatchBackend backend;
+        Player player(backend);
+        ScoreViewSource source(score::ScoreView{SCORE, 5}, ctx);
+        playWithPauses(player, backend, source, 37);
+        assertHeard(backend.log, SCORE_HZ, 5);
+    }
+
+    {
+        static uint8_t encoded[32];
+        TEST_ASSERT_TRUE(codec::encodeScore(SCORE, 5, encoded, sizeof(encoded)) > 0);
+
+        BatchBackend backend;
+        Player player(backend);
+        CompressedScoreSource source(encoded, ctx, codec::MemorySpace::Ram);
+        playWithPauses(player, backend, source, 37);
+        assertHeard(backend.log, SCORE_HZ, 5);
+    }
+}
+
+void test_shuffled_playlist_pause_resume_keeps_its_order()
+{
+    uint16_t reference[16];
+    size_t count;
+    {
+        BatchBackend backend;
+        Player player(backend);
+        PlaylistSource playlist(PARTS, 3, PlaylistOrder::Shuffle, 99);
+        player.play(playlist);
+        runToEnd(player, backend);
+        count = backend.log.heard(reference, 16);
+    }
+    TEST_ASSERT_EQUAL(9, count);
+
+    BatchBackend backend;
+    Player player(backend);
+    PlaylistSource playlist(PARTS, 3, PlaylistOrder::Shuffle, 99);
+    playWithPauses(player, backend, playlist, 13);
+    assertHeard(backend.log, reference, count);
+}
+
+void test_stream_pause_resume_keeps_every_step()
+{
+    static Step ring[16];
+    static uint16_t expected[200];
+    for (uint16_t i = 0; i < 200; ++i) expected[i] = i + 1;
+
+    const uint32_t periods[] = {2, 7, 13};
+    for (uint8_t p = 0; p < 3; ++p)
+    {
+        CountingStream producer(200);
+        StreamingSource stream(ring, 16);
+        startStream(stream, producer);
+
+        BatchBackend backend;
+        Player player(backend);
+        playWithPauses(player, backend, stream, periods[p], &stream);
+        assertHeard(backend.log, expected, 200);
+    }
+}
+
+void test_stream_interrupt_resumes_without_losing_steps()
+{
+    static Step ring[16];
+    static uint16_t expected[200], heard[256];
+    for (uint16_t i = 0; i < 200; ++i) expected[i] = i + 1;
+
+    CountingStream producer(200);
+    StreamingSource stream(ring, 16);
+    startStream(stream, producer);
+    MelodySource alert;
+    alert.reset(Melody{ALERT, 1});
+
+    BatchBackend backend;
+    Player player(backend);
+    player.play(stream);
+    run(player, backend, 125, &stream);
+    player.interrupt(alert);
+    runToEnd(player, backend, &stream);
+
+    size_t alerts;
+    size_t n = heardWithoutAlert(backend.log, heard, 256, alerts);
+    TEST_ASSERT_EQUAL(1, alerts);
+    TEST_ASSERT_EQUAL(200, n);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, heard, 200);
+}
+
+void test_paused_interrupt_keeps_the_steps_taken_back()
+{
+    static uint16_t heard[32];
+    MelodySource alert;
+    alert.reset(Melody{ALERT, 1});
+
+    BatchBackend backend;
+    Player player(backend);
+    player.play(Melody{MELODY, 8});
+    run(player, backend, 25);
+    player.pause();
+    player.interrupt(alert);
+    run(player, backend, 20);
+
+    // The melody stays paused after the alert
+    TEST_ASSERT_TRUE(player.isPaused());
+    player.resume();
+    runToEnd(player, backend);
+
+    size_t alerts;
+    size_t n = heardWithoutAlert(backend.log, heard, 32, alerts);
+    TEST_ASSERT_EQUAL(1, alerts);
+    TEST_ASSERT_EQUAL(8, n);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(MELODY_HZ, heard, 8);
+}
+
+void test_seek_while_playing()
+{
+    BatchBackend backend;
+    Player player(backend);
+    player.play(Melody{MELODY, 8});
+    run(player, backend, 15);
+
+    TEST_ASSERT_TRUE(player.seek(55));
+    runToEnd(player, backend);
+
+    const uint16_t expected[] = {101, 102, 106, 107, 108};
+    assertHeard(backend.log, expected, 5);
+}
+
+void test_seek_while_paused_drops_the_steps_taken_back()
+{
+    BatchBackend backend;
+    Player player(backend);
+    player.play(Melody{MELODY, 8});
+    run(player, backend, 15);
+    player.pause();
+
+    TEST_ASSERT_EQUAL_UINT32(15, player.elapsedMs());
+    TEST_ASSERT_EQUAL_UINT32(80, player.totalMs());
+    TEST_ASSERT_TRUE(player.seek(55));
+    player.resume();
+    runToEnd(player, backend);
+
+    const uint16_t expected[] = {101, 102, 106, 107, 108};
+    assertHeard(backend.log, expected, 5);
+}
+
+void test_failed_seek_keeps_playing()
+{
+    BatchBackend backend;
+    Player player(backend);
+    uint32_t endTimes[8];
+    TimeIndex index(endTimes, 8);
+    player.attachTimeIndex(index);
+    FailingSeekSource source;
+    source.reset(Melody{MELODY, 8});
+    player.play(source);
+    run(player, backend, 15);
+
+    // Indexed first: only the seek to the step at 55 ms fails
+    TEST_ASSERT_EQUAL_UINT32(80, player.totalMs());
+    source.failSeek = true;
+    TEST_ASSERT_FALSE(player.seek(55));
+    TEST_ASSERT_FALSE(player.isPaused());
+    runToEnd(player, backend);
+
+    assertHeard(backend.log, MELODY_HZ, 8);
+}
+
+void test_pause_after_a_melody_swap_inside_the_window()
+{
+    const Step partA[] = {{100, 30}, {101, 30}, {102, 30}, {103, 30}};
+    const Step partB[] = {{200, 30}, {201, 30}, {202, 30}, {203, 30}};
+    const uint16_t expected[] = {100, 101, 102, 103, 200, 201, 202, 203};
+
+    // Paused while the last step of A is heard and B is already in the window, then on B
+    const uint32_t pauseAtMs[] = {95, 120};
+    for (uint8_t i = 0; i < 2; ++i)
+    {
+        BatchBackend backend;
+        Player player(backend);
+        player.play(Melody{partA, 4});
+        run(player, backend, 50);
+        player.queue(Melody{partB, 4}, SwapPoint::NextStep);
+        run(player, backend, pauseAtMs[i] - 50);
+
+        player.pause();
+        run(player, backend, 10);
+        player.resume();
+        runToEnd(player, backend);
+
+        assertHeard(backend.log, expected, 8);
+    }
+}
+
+void test_metronome_pause_resume_keeps_the_bar()
+{
+    BatchBackend backend;
+    Player player(backend);
+    MetronomeSource metronome;
+    player.play(metronome);
+
+    // Paused in the rest after the first beat, then 4 more beats
+    run(player, backend, 250);
+    player.pause();
+    TEST_ASSERT_FALSE(player.seek(0));
+    run(player, backend, 100);
+    player.resume();
+    run(player, backend, 2000);
+    player.stop();
+
+    MetronomeConfig config;
+    size_t clicks = 0;
+    for (size_t i = 0; i < backend.log.count; ++i)
+    {
+        uint16_t hz = backend.log.events[i];
+        if (hz == 0) continue;
+
+        TEST_ASSERT_EQUAL_UINT16((clicks % config.beatsPerBar == 0) ? config.accentHz : config.beatHz, hz);
+        ++clicks;
+    }
+    TEST_ASSERT_EQUAL(5, clicks);
+}
+
+void test_metronome_pause_resume_keeps_the_beat_timing()
+{
+    MetronomeConfig config;
+    config.bpm = 97;
+    config.beatUnit = 8;                        // beats of 309278.35 us: every step has a sub-ms part
+
+    BatchBackend backend;
+    Player player(backend);
+    MetronomeSource metronome(config);
+    player.play(metronome);
+
+    // Paused in the rest of the second beat, the third click already in the window
+    run(player, backend, 400);
+    unsigned long pausedAtUs = micros();
+    player.pause();
+    run(player, backend, 123);
+    unsigned long pauseUs = micros() - pausedAtUs;
+    player.resume();
+    run(player, backend, 2000);
+    player.stop();
+
+    // Every click on its exact deadline, the ones after the pause moved by the pause only
+    const Recorder& log = backend.log;
+    unsigned long originUs = 0;
+    uint32_t clicks = 0;
+    for (size_t i = 0; i < log.count; ++i)
+    {
+        if (log.events[i] == 0) continue;
+        if (clicks == 0) originUs = log.atUs[i];
+
+        uint32_t expectedUs = (uint32_t)((uint64_t)clicks * 240000000UL / ((uint32_t)config.bpm * config.beatUnit));
+        if (clicks >= 2) expectedUs += pauseUs;
+        TEST_ASSERT_EQUAL_UINT32(expectedUs, log.atUs[i] - originUs);
+        ++clicks;
+    }
+    TEST_ASSERT_EQUAL(8, clicks);
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_melody_pause_resume_keeps_every_step);
+    RUN_TEST(test_score_sources_pause_resume_keep_every_note);
+    RUN_TEST(test_shuffled_playlist_pause_resume_keeps_its_order);
+    RUN_TEST(test_stream_pause_resume_keeps_every_step);
+    RUN_TEST(test_stream_interrupt_resumes_without_losing_steps);
+    RUN_TEST(test_paused_interrupt_keeps_the_steps_taken_back);
+    RUN_TEST(test_seek_while_playing);
+    RUN_TEST(test_seek_while_paused_drops_the_steps_taken_back);
+    RUN_TEST(test_failed_seek_keeps_playing);
+    RUN_TEST(test_pause_after_a_melody_swap_inside_the_window);
+    RUN_TEST(test_metronome_pause_resume_keeps_the_bar);
+    RUN_TEST(test_metronome_pause_resume_keeps_the_beat_timing);
+    return UNITY_END();
+}
@@ -0,0 +1,139 @@
+#include <unity.h>
+#include "Arduino.h"
+#include "player/MelodyCache.h"
+#include "sources/PooledMelodySource.h"
+
+// A preset is converted once per (preset, tempo, gap), the least recently used entry makes room,
+// and an evicted melody lives on while a source still plays it.
+
+namespace
+{
+    MelodyContext tempo(uint16_t bpm)
+    {
+        MelodyContext ctx;
+        ctx.bpm = bpm;
+        return ctx;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_second_get_is_a_hit()
+{
+    StaticMelodyPool<16, 4> pool;
+    MelodyCache<4> cache(pool);
+
+    MelodyHandle first = cache.get(PresetId::Success);
+    MelodyHandle second = cache.get(PresetId::Success);
+
+    TEST_ASSERT_TRUE(pool.isValid(first));
+    TEST_ASSERT_EQUAL_UINT8(first.slot, second.slot);
+    TEST_ASSERT_EQUAL_UINT8(first.generation, second.generation);
+    TEST_ASSERT_EQUAL_UINT32(1, cache.misses());
+    TEST_ASSERT_EQUAL_UINT32(1, cache.hits());
+    TEST_ASSERT_EQUAL_UINT8(1, cache.size());
+}
+
+void test_tempo_and_gap_are_part_of_the_key()
+{
+    StaticMelodyPool<16, 4> pool;
+    MelodyCache<4> cache(pool);
+
+    MelodyContext gapped = tempo(120);
+    gapped.gapMs = 20;
+
+    cache.get(PresetId::Error, tempo(120));
+    cache.get(PresetId::Error, tempo(180));
+    cache.get(PresetId::Error, gapped);
+    cache.get(PresetId::Error, tempo(180));
+
+    TEST_ASSERT_EQUAL_UINT32(3, cache.misses());
+    TEST_ASSERT_EQUAL_UINT32(1, cache.hits());
+    TEST_ASSERT_EQUAL_UINT8(3, cache.size());
+}
+
+void test_least_recently_used_is_evicted()
+{
+    StaticMelodyPool<16, 4> pool;
+    MelodyCache<2> cache(pool);
+
+    cache.get(PresetId::Success);
+    cache.get(PresetId::Error);
+    cache.get(PresetId::Success);           // Error is now the oldest
+    cache.get(PresetId::Warning);
+
+    TEST_ASSERT_EQUAL_UINT32(1, cache.evictions());
+    cache.resetStats();
+    cache.get(PresetId::Success);
+    cache.get(PresetId::Warning);
+    TEST_ASSERT_EQUAL_UINT32(2, cache.hits());
+
+    cache.get(PresetId::Error);
+    TEST_ASSERT_EQUAL_UINT32(1, cache.misses());
+}
+
+void test_full_pool_evicts_until_it_fits()
+{
+    // Room for one preset at a time: the second one evicts the first
+    StaticMelodyPool<1, 4> pool;
+    MelodyCache<4> cache(pool);
+
+    MelodyHandle success = cache.get(PresetId::Success);
+    MelodyHandle startup = cache.get(PresetId::Startup);
+
+    TEST_ASSERT_FALSE(startup.isNull());
+    TEST_ASSERT_FALSE(pool.isValid(success));
+    TEST_ASSERT_EQUAL_UINT32(1, cache.evictions());
+    TEST_ASSERT_EQUAL_UINT8(1, cache.size());
+}
+
+void test_evicted_melody_lives_while_played()
+{
+    StaticMelodyPool<16, 4> pool;
+    MelodyCache<1> cache(pool);
+    PooledMelodySource source(pool);
+
+    MelodyHandle success = cache.get(PresetId::Success);
+    TEST_ASSERT_TRUE(source.reset(success));
+    cache.get(PresetId::Error);
+
+    TEST_ASSERT_EQUAL_UINT32(1, cache.evictions());
+    TEST_ASSERT_TRUE(pool.isValid(success));
+    TEST_ASSERT_EQUAL_UINT8(1, pool.refCount(success));
+
+    source.clear();
+    TEST_ASSERT_FALSE(pool.isValid(success));
+}
+
+void test_clear_releases_every_melody()
+{
+    StaticMelodyPool<16, 4> pool;
+    uint8_t freeBlocks = pool.freeBlocks();
+    {
+        MelodyCache<4> cache(pool);
+        cache.get(PresetId::Success);
+        cache.get(PresetId::Error);
+        cache.clear();
+        TEST_ASSERT_EQUAL_UINT8(0, cache.size());
+        TEST_ASSERT_EQUAL_UINT8(freeBlocks, pool.freeBlocks());
+
+        cache.get(PresetId::Notification);
+    }
+    TEST_ASSERT_EQUAL_UINT8(freeBlocks, pool.freeBlocks());
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_second_get_is_a_hit);
+    RUN_TEST(test_tempo_and_gap_are_part_of_the_key);
+    RUN_TEST(test_least_recently_used_is_evicted);
+    RUN_TEST(test_full_pool_evicts_until_it_fits);
+    RUN_TEST(test_evicted_melody_lives_while_played);
+    RUN_TEST(test_clear_releases_every_melody);
+    return UNITY_END();
+}
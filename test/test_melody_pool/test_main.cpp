@@ -0,0 +1,149 @@
+#include <unity.h>
+#include "PlayerTestSupport.h"
+#include "player/BuzzerPlayer.h"
+#include "player/MelodyPool.h"
+#include "sources/PooledMelodySource.h"
+
+// Pooled melodies live as long as a reference is held, and a handle to a freed melody is seen as
+// stale even after its slot was reused.
+
+using namespace test_support;
+
+typedef BasicBuzzerPlayer<PlainBackend> Player;
+
+namespace
+{
+    Step steps[20];
+
+    /// @brief Melody of count steps of distinct frequencies from base
+    Melody makeMelody(uint16_t base, uint16_t count)
+    {
+        for (uint16_t i = 0; i < count; ++i) steps[i] = Step{(uint16_t)(base + i), 10};
+        return Melody{steps, count};
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_add_copies_the_steps_into_blocks()
+{
+    StaticMelodyPool<4, 2> pool;
+    MelodyHandle handle = pool.add(makeMelody(100, 20));
+
+    TEST_ASSERT_FALSE(handle.isNull());
+    TEST_ASSERT_EQUAL_UINT16(20, pool.stepCount(handle));
+    TEST_ASSERT_EQUAL_UINT8(1, pool.refCount(handle));
+    TEST_ASSERT_EQUAL_UINT8(1, pool.freeBlocks());
+
+    // The caller buffer can be reused right away
+    makeMelody(900, 20);
+    uint16_t i = 0;
+    for (uint8_t block = pool.firstBlock(handle); block != MelodyPool::END_OF_CHAIN; block = pool.nextBlock(block))
+    {
+        const Step* s = pool.blockSteps(block);
+        for (uint8_t j = 0; j < MelodyPool::BLOCK_STEPS && i < 20; ++j, ++i) TEST_ASSERT_EQUAL_UINT16(100 + i, s[j].freqHz);
+    }
+    TEST_ASSERT_EQUAL_UINT16(20, i);
+}
+
+void test_full_pool_refuses_without_reserving()
+{
+    StaticMelodyPool<3, 4> pool;
+    MelodyHandle a = pool.add(makeMelody(100, 16));
+    MelodyHandle b = pool.add(makeMelody(200, 16));
+
+    TEST_ASSERT_FALSE(a.isNull());
+    TEST_ASSERT_TRUE(b.isNull());
+    TEST_ASSERT_EQUAL_UINT8(1, pool.freeBlocks());
+    TEST_ASSERT_FALSE(pool.add(makeMelody(300, 8)).isNull());
+}
+
+void test_last_release_frees_the_melody()
+{
+    StaticMelodyPool<4, 2> pool;
+    MelodyHandle handle = pool.add(makeMelody(100, 12));
+    TEST_ASSERT_TRUE(pool.acquire(handle));
+    TEST_ASSERT_EQUAL_UINT8(2, pool.refCount(handle));
+
+    pool.release(handle);
+    TEST_ASSERT_TRUE(pool.isValid(handle));
+    TEST_ASSERT_EQUAL_UINT8(2, pool.freeBlocks());
+
+    pool.release(handle);
+    TEST_ASSERT_FALSE(pool.isValid(handle));
+    TEST_ASSERT_EQUAL_UINT8(4, pool.freeBlocks());
+    TEST_ASSERT_EQUAL_UINT16(0, pool.stepCount(handle));
+}
+
+void test_stale_handle_after_the_slot_is_reused()
+{
+    StaticMelodyPool<4, 1> pool;
+    MelodyHandle old = pool.add(makeMelody(100, 4));
+    pool.release(old);
+
+    MelodyHandle reused = pool.add(makeMelody(200, 4));
+    TEST_ASSERT_EQUAL_UINT8(old.slot, reused.slot);
+    TEST_ASSERT_FALSE(pool.isValid(old));
+    TEST_ASSERT_TRUE(pool.isValid(reused));
+
+    // The stale handle neither takes nor drops references of the new melody
+    TEST_ASSERT_FALSE(pool.acquire(old));
+    pool.release(old);
+    TEST_ASSERT_EQUAL_UINT8(1, pool.refCount(reused));
+
+    PooledMelodySource source(pool);
+    TEST_ASSERT_FALSE(source.reset(old));
+    Step step;
+    TEST_ASSERT_FALSE(source.next(step));
+}
+
+void test_sources_share_and_keep_the_melody_alive()
+{
+    StaticMelodyPool<4, 2> pool;
+    MelodyHandle handle = pool.add(makeMelody(100, 12));
+
+    PlainBackend backendA, backendB;
+    Player playerA(backendA), playerB(backendB);
+    {
+        PooledMelodySource a(pool), b(pool);
+        TEST_ASSERT_TRUE(a.reset(handle));
+        TEST_ASSERT_TRUE(b.reset(handle));
+        TEST_ASSERT_EQUAL_UINT8(3, pool.refCount(handle));
+
+        // The owner lets go while both still play it
+        pool.release(handle);
+        playerA.play(a);
+        playerB.play(b);
+        while (playerA.isPlaying() || playerB.isPlaying())
+        {
+            playerA.update();
+            playerB.update();
+            arduino_shim::nowUs() += TICK_US;
+        }
+
+        static uint16_t expected[12];
+        for (uint16_t i = 0; i < 12; ++i) expected[i] = 100 + i;
+        assertHeard(backendA.log, expected, 12);
+        assertHeard(backendB.log, expected, 12);
+        TEST_ASSERT_TRUE(pool.isValid(handle));
+    }
+
+    // The sources dropped the last references
+    TEST_ASSERT_FALSE(pool.isValid(handle));
+    TEST_ASSERT_EQUAL_UINT8(4, pool.freeBlocks());
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_add_copies_the_steps_into_blocks);
+    RUN_TEST(test_full_pool_refuses_without_reserving);
+    RUN_TEST(test_last_release_frees_the_melody);
+    RUN_TEST(test_stale_handle_after_the_slot_is_reused);
+    RUN_TEST(test_sources_share_and_keep_the_melody_alive);
+    return UNITY_END();
+}
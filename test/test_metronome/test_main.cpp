@@ -0,0 +1,154 @@
+#include <unity.h>
+#include "PlayerTestSupport.h"
+#include "player/BuzzerPlayer.h"
+#include "sources/MetronomeSource.h"
+
+// The metronome beats follow the exact deadline sequence k * 240000000 / (bpm * beatUnit) us:
+// no rounding to the ms, no drift over a long run.
+
+using namespace test_support;
+
+namespace
+{
+    /// @brief Exact start of beat k in us
+    uint32_t beatStartUs(uint32_t k, const MetronomeConfig& config)
+    {
+        return (uint32_t)((uint64_t)k * 240000000UL / ((uint32_t)config.bpm * config.beatUnit));
+    }
+
+    /// @brief Real length of a step in us
+    uint32_t stepUs(const Step& step, const IStepSource& source)
+    {
+        return step.durationMs * 1000UL + source.lastStepExtraUs();
+    }
+
+    /// @brief Backend that records when each click starts
+    struct OnsetBackend
+    {
+        static constexpr uint8_t MAX_ONSETS = 64;
+
+        unsigned long onsetUs[MAX_ONSETS];
+        uint16_t onsetHz[MAX_ONSETS];
+        uint8_t onsets = 0;
+
+        void start(uint16_t hz)
+        {
+            if (hz == 0 || onsets >= MAX_ONSETS) return;
+            onsetUs[onsets] = micros();
+            onsetHz[onsets++] = hz;
+        }
+        void stop() {}
+        void tick() {}
+    };
+}
+
+void setUp() { arduino_shim::nowUs() = 0; }
+void tearDown() {}
+
+void test_beats_follow_the_exact_deadline_sequence()
+{
+    MetronomeConfig config;
+    config.bpm = 97;
+    config.beatUnit = 8;
+    MetronomeSource metronome(config);
+
+    // A click and a rest per beat, the sum of the steps lands on every beat start
+    uint32_t positionUs = 0;
+    for (uint32_t k = 1; k <= 1000; ++k)
+    {
+        Step click, rest;
+        TEST_ASSERT_TRUE(metronome.next(click));
+        positionUs += stepUs(click, metronome);
+        TEST_ASSERT_TRUE(metronome.next(rest));
+        positionUs += stepUs(rest, metronome);
+
+        TEST_ASSERT_EQUAL_UINT16(0, rest.freqHz);
+        TEST_ASSERT_EQUAL_UINT32(beatStartUs(k, config), positionUs);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1000, metronome.beats());
+}
+
+void test_accent_on_the_first_beat_of_the_bar()
+{
+    MetronomeConfig config;
+    config.beatsPerBar = 3;
+    MetronomeSource metronome(config);
+
+    for (uint8_t beat = 0; beat < 9; ++beat)
+    {
+        Step click, rest;
+        TEST_ASSERT_TRUE(metronome.next(click));
+        TEST_ASSERT_TRUE(metronome.next(rest));
+
+        TEST_ASSERT_EQUAL_UINT16((beat % 3 == 0) ? config.accentHz : config.beatHz, click.freqHz);
+        TEST_ASSERT_EQUAL_UINT32(config.clickMs, click.durationMs);
+    }
+
+    // rewind() starts a new bar
+    Step click;
+    metronome.next(click);
+    metronome.rewind();
+    metronome.next(click);
+    TEST_ASSERT_EQUAL_UINT16(config.accentHz, click.freqHz);
+    TEST_ASSERT_EQUAL_UINT32(1, metronome.beats());
+}
+
+void test_new_tempo_starts_at_the_next_beat()
+{
+    MetronomeConfig slow;
+    slow.bpm = 60;
+    MetronomeSource metronome(slow);
+
+    Step click, rest;
+    metronome.next(click);
+    uint32_t beatUs = stepUs(click, metronome);
+    MetronomeConfig fast = slow;
+    fast.bpm = 240;
+    metronome.setConfig(fast);
+
+    // The beat being played keeps its length, the next one is 4 times shorter
+    metronome.next(rest);
+    beatUs += stepUs(rest, metronome);
+    TEST_ASSERT_EQUAL_UINT32(1000000, beatUs);
+
+    metronome.next(click);
+    beatUs = stepUs(click, metronome);
+    metronome.next(rest);
+    beatUs += stepUs(rest, metronome);
+    TEST_ASSERT_EQUAL_UINT32(250000, beatUs);
+    TEST_ASSERT_EQUAL_UINT16(240, metronome.config().bpm);
+}
+
+void test_played_beats_do_not_drift()
+{
+    MetronomeConfig config;
+    config.bpm = 133;
+    OnsetBackend backend;
+    BasicBuzzerPlayer<OnsetBackend> player(backend);
+    MetronomeSource metronome(config);
+
+    player.play(metronome);
+    run(player, backend, 20000);
+    player.stop();
+
+    // 45 clicks in 20 s, each one at most a clock tick after its deadline
+    TEST_ASSERT_EQUAL(45, backend.onsets);
+    for (uint8_t k = 0; k < backend.onsets; ++k)
+    {
+        uint32_t lateUs = backend.onsetUs[k] - backend.onsetUs[0] - beatStartUs(k, config);
+        TEST_ASSERT_TRUE(lateUs <= TICK_US);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_beats_follow_the_exact_deadline_sequence);
+    RUN_TEST(test_accent_on_the_first_beat_of_the_bar);
+    RUN_TEST(test_new_tempo_starts_at_the_next_beat);
+    RUN_TEST(test_played_beats_do_not_drift);
+    return UNITY_END();
+}
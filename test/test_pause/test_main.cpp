@@ -0,0 +1,172 @@
+#include <unity.h>
+#include "PlayerTestSupport.h"
+#include "player/BuzzerPlayer.h"
+#include "music/Notes.h"
+#include "music/Durations.h"
+#include "sources/MelodySource.h"
+#include "sources/ScoreViewSource.h"
+
+// pause() / resume() and interrupt(): the paused step resumes with the time it had left, and a
+// melody interrupted by an alert carries on where it was, paused or not.
+
+using namespace test_support;
+
+typedef BasicBuzzerPlayer<PlainBackend> Player;
+
+namespace
+{
+    constexpr uint16_t ALERT_HZ = 5000;
+
+    const Step MELODY[] = {
+        {101, 100}, {102, 100}, {103, 100}, {104, 100},
+        {105, 100}, {106, 100}, {107, 100}, {108, 100}
+    };
+    const uint16_t MELODY_HZ[] = {101, 102, 103, 104, 105, 106, 107, 108};
+
+    const Step ALERT[] = {{ALERT_HZ, 30}};
+
+    /// @brief Steps heard apart from the alert (the step it interrupted resumes after it), and how many times the alert started
+    size_t heardWithoutAlert(const Recorder& log, uint16_t* out, size_t capacity, size_t& alerts)
+    {
+        static uint16_t heard[MAX_EVENTS];
+        size_t n = log.heard(heard, MAX_EVENTS);
+        size_t kept = 0;
+
+        alerts = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (heard[i] == ALERT_HZ) ++alerts;
+            else if (kept > 0 && out[kept - 1] == heard[i]) continue;
+            else if (kept < capacity) out[kept++] = heard[i];
+        }
+        return kept;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_pause_keeps_the_time_left_in_the_step()
+{
+    PlainBackend backend;
+    Player player(backend);
+    player.play(Melody{MELODY, 8});
+    run(player, backend, 130);
+
+    player.pause();
+    TEST_ASSERT_TRUE(player.isPaused());
+    TEST_ASSERT_TRUE(player.isPlaying());
+    run(player, backend, 500);
+    TEST_ASSERT_EQUAL_UINT32(130, player.elapsedMs());
+
+    // 70 ms left in the second step, then 6 steps of 100 ms
+    player.resume();
+    TEST_ASSERT_FALSE(player.isPaused());
+    unsigned long resumedUs = micros();
+    runToEnd(player, backend);
+
+    TEST_ASSERT_UINT32_WITHIN(1000, 670000, micros() - resumedUs);
+    assertHeard(backend.log, MELODY_HZ, 8);
+}
+
+void test_pause_and_resume_many_times()
+{
+    PlainBackend backend;
+    Player player(backend);
+    player.play(Melody{MELODY, 8});
+
+    for (uint32_t ms = 0; player.isPlaying() && ms < 10000; ms += 37)
+    {
+        run(player, backend, 37);
+        if (player.isPaused()) player.resume();
+        else player.pause();
+    }
+    if (player.isPaused()) player.resume();
+    runToEnd(player, backend);
+
+    assertHeard(backend.log, MELODY_HZ, 8);
+}
+
+void test_score_source_pause_resume_keeps_every_note()
+{
+    const score::ScoreNote notes[] = {
+        {notes::C5, durations::Eighth},
+        {notes::E5, durations::Eighth},
+        {notes::G5, durations::Quarter}
+    };
+    const uint16_t expected[] = {notes::C5, notes::E5, notes::G5};
+
+    MelodyContext ctx;
+    ScoreViewSource source(score::ScoreView{notes, 3}, ctx);
+    PlainBackend backend;
+    Player player(backend);
+    player.play(source);
+
+    run(player, backend, 300);
+    player.pause();
+    run(player, backend, 100);
+    player.resume();
+    runToEnd(player, backend);
+
+    assertHeard(backend.log, expected, 3);
+}
+
+void test_interrupt_resumes_the_melody()
+{
+    static uint16_t heard[32];
+    MelodySource alert;
+    alert.reset(Melody{ALERT, 1});
+
+    PlainBackend backend;
+    Player player(backend);
+    player.play(Melody{MELODY, 8});
+    run(player, backend, 250);
+    player.interrupt(alert);
+    runToEnd(player, backend);
+
+    size_t alerts;
+    size_t n = heardWithoutAlert(backend.log, heard, 32, alerts);
+    TEST_ASSERT_EQUAL(1, alerts);
+    TEST_ASSERT_EQUAL(8, n);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(MELODY_HZ, heard, 8);
+}
+
+void test_paused_interrupt_stays_paused()
+{
+    static uint16_t heard[32];
+    MelodySource alert;
+    alert.reset(Melody{ALERT, 1});
+
+    PlainBackend backend;
+    Player player(backend);
+    player.play(Melody{MELODY, 8});
+    run(player, backend, 250);
+    player.pause();
+    player.interrupt(alert);
+    run(player, backend, 100);
+
+    TEST_ASSERT_TRUE(player.isPaused());
+    TEST_ASSERT_EQUAL_UINT32(250, player.elapsedMs());
+    player.resume();
+    runToEnd(player, backend);
+
+    size_t alerts;
+    size_t n = heardWithoutAlert(backend.log, heard, 32, alerts);
+    TEST_ASSERT_EQUAL(1, alerts);
+    TEST_ASSERT_EQUAL(8, n);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(MELODY_HZ, heard, 8);
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_pause_keeps_the_time_left_in_the_step);
+    RUN_TEST(test_pause_and_resume_many_times);
+    RUN_TEST(test_score_source_pause_resume_keeps_every_note);
+    RUN_TEST(test_interrupt_resumes_the_melody);
+    RUN_TEST(test_paused_interrupt_stays_paused);
+    return UNITY_END();
+}
@@ -0,0 +1,307 @@
+#include <unity.h>
+#include "PlayerTestSupport.h"
+#include "player/BuzzerPlayer.h"
+#include "player/TimeIndex.h"
+#include "codec/ScoreCodec.h"
+#include "music/Notes.h"
+#include "music/Durations.h"
+#include "sources/MelodySource.h"
+#include "sources/PlaylistSource.h"
+#include "sources/StreamingSource.h"
+#include "sources/MetronomeSource.h"
+#include "sources/ScoreViewSource.h"
+#include "sources/CompressedScoreSource.h"
+
+// Position queries (elapsedMs / totalMs / remainingMs / seek) on each kind of source: a replayable
+// source is scanned on demand or indexed in application storage and can be sought, the others
+// are left untouched and keep playing as before.
+
+using namespace test_support;
+
+typedef BasicBuzzerPlayer<PlainBackend> Player;
+
+namespace
+{
+    const Step MELODY[] = {
+        {101, 100}, {102, 100}, {103, 100}, {104, 100},
+        {105, 100}, {106, 100}, {107, 100}, {108, 100}
+    };
+
+    const score::ScoreNote SCORE[] = {
+        {notes::C5, durations::Quarter},
+        {notes::E5, durations::Quarter},
+        {notes::G5, durations::Half}
+    };
+
+    const Step PART_A[] = {{201, 50}, {202, 50}};
+    const Step PART_B[] = {{301, 50}, {302, 50}};
+    const Step PART_C[] = {{401, 50}, {402, 50}};
+    const Melody PARTS[] = {{PART_A, 2}, {PART_B, 2}, {PART_C, 2}};
+
+    /// @brief Metronome that counts the steps read from it
+    struct CountingMetronome : MetronomeSource
+    {
+        uint32_t reads = 0;
+        bool next(Step& step) override { ++reads; return MetronomeSource::next(step); }
+    };
+
+    /// @brief Play a score source: 500 ms quarters at 120 bpm, seek into the half note
+    void checkScoreSource(IStepSource& source)
+    {
+        PlainBackend backend;
+        Player player(backend);
+        player.play(source);
+        run(player, backend, 600);
+
+        TEST_ASSERT_EQUAL_UINT32(2000, player.totalMs());
+        TEST_ASSERT_TRUE(player.seek(1200));
+        runToEnd(player, backend);
+
+        const uint16_t expected[] = {notes::C5, notes::E5, notes::G5};
+        assertHeard(backend.log, expected, 3);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_melody_position_and_seek()
+{
+    PlainBackend backend;
+    Player player(backend);
+    player.play(Melody{MELODY, 8});
+    run(player, backend, 250);
+
+    TEST_ASSERT_EQUAL_UINT32(250, player.elapsedMs());
+    TEST_ASSERT_EQUAL_UINT32(800, player.totalMs());
+    TEST_ASSERT_EQUAL_UINT32(550, player.remainingMs());
+
+    TEST_ASSERT_TRUE(player.seek(650));
+    TEST_ASSERT_FALSE(player.seek(800));
+    runToEnd(player, backend);
+
+    const uint16_t expected[] = {101, 102, 103, 107, 108};
+    assertHeard(backend.log, expected, 5);
+}
+
+void test_indexed_melody_seeks_backwards()
+{
+    static uint32_t endTimes[8];
+    TimeIndex index(endTimes, 8);
+
+    PlainBackend backend;
+    Player player(backend);
+    player.attachTimeIndex(index);
+    player.play(Melody{MELODY, 8});
+    run(player, backend, 450);
+
+    TEST_ASSERT_EQUAL_UINT32(800, player.totalMs());
+    TEST_ASSERT_TRUE(index.hasPrefix());
+    TEST_ASSERT_TRUE(player.seek(150));
+    TEST_ASSERT_EQUAL_UINT32(150, player.elapsedMs());
+    runToEnd(player, backend);
+
+    const uint16_t expected[] = {101, 102, 103, 104, 105, 102, 103, 104, 105, 106, 107, 108};
+    assertHeard(backend.log, expected, 12);
+}
+
+void test_score_view_position_and_seek()
+{
+    MelodyContext ctx;
+    ScoreViewSource source(score::ScoreView{SCORE, 3}, ctx);
+    checkScoreSource(source);
+}
+
+void test_compressed_score_position_and_seek()
+{
+    static uint8_t encoded[32];
+    TEST_ASSERT_TRUE(codec::encodeScore(SCORE, 3, encoded, sizeof(encoded)) > 0);
+
+    MelodyContext ctx;
+    CompressedScoreSource source(encoded, ctx, codec::MemorySpace::Ram);
+    checkScoreSource(source);
+}
+
+void test_playlist_total_is_the_sum_of_its_entries()
+{
+    PlainBackend backend;
+    Player player(backend);
+    PlaylistSource playlist(PARTS, 3);
+    player.play(playlist);
+    run(player, backend, 120);
+
+    TEST_ASSERT_EQUAL_UINT32(300, player.totalMs());
+    TEST_ASSERT_TRUE(player.seek(260));
+    runToEnd(player, backend);
+
+    const uint16_t expected[] = {201, 202, 301, 402};
+    assertHeard(backend.log, expected, 4);
+}
+
+void test_shuffled_playlist_order_survives_position_queries()
+{
+    uint16_t reference[32], queried[32];
+    size_t referenceCount = 0, queriedCount = 0;
+
+    for (int query = 0; query < 2; ++query)
+    {
+        PlainBackend backend;
+        Player player(backend);
+        PlaylistSource playlist(PARTS, 3, PlaylistOrder::Shuffle, 1234);
+        player.play(playlist, true);
+
+        // Two passes, queried in the first and right after the loop reshuffled
+        run(player, backend, 120);
+        if (query) TEST_ASSERT_EQUAL_UINT32(300, player.totalMs());
+        run(player, backend, 240);
+        if (query) TEST_ASSERT_EQUAL_UINT32(300, player.totalMs());
+        run(player, backend, 230);
+        player.stop();
+
+        if (query) queriedCount = backend.log.heard(queried, 32);
+        else referenceCount = backend.log.heard(reference, 32);
+    }
+
+    TEST_ASSERT_EQUAL(12, referenceCount);
+    TEST_ASSERT_EQUAL(referenceCount, queriedCount);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(reference, queried, referenceCount);
+}
+
+void test_playlist_entries_repeat_in_a_row()
+{
+    const uint8_t repeats[] = {2, 0, 1};
+
+    // A twice, B skipped, C once
+    {
+        PlainBackend backend;
+        Player player(backend);
+        PlaylistSource playlist(PARTS, 3);
+        playlist.setRepeats(repeats);
+        player.play(playlist);
+        runToEnd(player, backend);
+
+        const uint16_t expected[] = {201, 202, 201, 202, 401, 402};
+        assertHeard(backend.log, expected, 6);
+    }
+
+    // Indexed and sought like any melody: 150 ms is the second step of the second A
+    {
+        PlainBackend backend;
+        Player player(backend);
+        PlaylistSource playlist(PARTS, 3);
+        playlist.setRepeats(repeats);
+        player.play(playlist);
+        run(player, backend, 10);
+
+        TEST_ASSERT_EQUAL_UINT32(300, player.totalMs());
+        TEST_ASSERT_TRUE(player.seek(150));
+        runToEnd(player, backend);
+
+        const uint16_t expected[] = {201, 202, 401, 402};
+        assertHeard(backend.log, expected, 4);
+    }
+}
+
+void test_shuffled_playlist_keeps_repeats_together()
+{
+    const uint8_t repeats[] = {1, 3, 1};
+    PlainBackend backend;
+    Player player(backend);
+    PlaylistSource playlist(PARTS, 3, PlaylistOrder::Shuffle, 1234);
+    playlist.setRepeats(repeats);
+    player.play(playlist);
+    runToEnd(player, backend);
+
+    uint16_t heard[32];
+    size_t n = backend.log.heard(heard, 32);
+    TEST_ASSERT_EQUAL(10, n);
+
+    // The three B runs follow each other wherever the shuffle put B
+    size_t first = 0;
+    while (first < n && heard[first] != 301) ++first;
+    TEST_ASSERT_TRUE(first + 6 <= n);
+    for (size_t i = 0; i < 6; ++i) TEST_ASSERT_EQUAL_UINT16(PART_B[i % 2].freqHz, heard[first + i]);
+}
+
+void test_stream_without_rewinder_is_not_indexed()
+{
+    static Step ring[16];
+    CountingStream producer(300);
+    StreamingSource stream(ring, 16);
+    stream.setProducer(&CountingStream::produce, &producer);
+    stream.refill();
+
+    PlainBackend backend;
+    Player player(backend);
+    player.play(stream);
+    run(player, backend, 100, &stream);
+
+    TEST_ASSERT_EQUAL_UINT32(0, player.totalMs());
+    TEST_ASSERT_EQUAL_UINT32(0, player.remainingMs());
+    TEST_ASSERT_FALSE(player.seek(10));
+    runToEnd(player, backend, &stream);
+
+    static uint16_t expected[300];
+    for (uint16_t i = 0; i < 300; ++i) expected[i] = i + 1;
+    assertHeard(backend.log, expected, 300);
+}
+
+void test_stream_with_rewinder_is_not_replayed()
+{
+    static Step ring[16];
+    CountingStream producer(300);
+    StreamingSource stream(ring, 16);
+    stream.setProducer(&CountingStream::produce, &producer, &CountingStream::restart);
+    stream.refill();
+
+    PlainBackend backend;
+    Player player(backend);
+    player.play(stream);
+    run(player, backend, 100, &stream);
+
+    uint32_t produced = stream.produced();
+    TEST_ASSERT_EQUAL_UINT32(0, player.totalMs());
+    TEST_ASSERT_FALSE(player.seek(10));
+    TEST_ASSERT_EQUAL_UINT32(produced, stream.produced());
+    runToEnd(player, backend, &stream);
+
+    static uint16_t expected[300];
+    for (uint16_t i = 0; i < 300; ++i) expected[i] = i + 1;
+    assertHeard(backend.log, expected, 300);
+}
+
+void test_metronome_is_not_read_by_position_queries()
+{
+    PlainBackend backend;
+    Player player(backend);
+    CountingMetronome metronome;
+    player.play(metronome);
+    run(player, backend, 50);
+
+    uint32_t reads = metronome.reads;
+    TEST_ASSERT_EQUAL_UINT32(0, player.totalMs());
+    TEST_ASSERT_EQUAL_UINT32(0, player.remainingMs());
+    TEST_ASSERT_FALSE(player.seek(100));
+    TEST_ASSERT_EQUAL_UINT32(reads, metronome.reads);
+    TEST_ASSERT_TRUE(player.isPlaying());
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_melody_position_and_seek);
+    RUN_TEST(test_indexed_melody_seeks_backwards);
+    RUN_TEST(test_score_view_position_and_seek);
+    RUN_TEST(test_compressed_score_position_and_seek);
+    RUN_TEST(test_playlist_total_is_the_sum_of_its_entries);
+    RUN_TEST(test_shuffled_playlist_order_survives_position_queries);
+    RUN_TEST(test_playlist_entries_repeat_in_a_row);
+    RUN_TEST(test_shuffled_playlist_keeps_repeats_together);
+    RUN_TEST(test_stream_without_rewinder_is_not_indexed);
+    RUN_TEST(test_stream_with_rewinder_is_not_replayed);
+    RUN_TEST(test_metronome_is_not_read_by_position_queries);
+    return UNITY_END();
+}
@@ -0,0 +1,120 @@
+#include <unity.h>
+#include <string.h>
+#include "Arduino.h"
+#include "presetTones/Presets.h"
+
+// Every preset is found by its name (any case) through the perfect hash, and nothing else is:
+// prefixes, extensions and unknown words that land on a used bucket are refused.
+
+namespace
+{
+    const char* const NAMES[] = {"success", "error", "notification", "warning", "startup", "shutdown", "click"};
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_registry_matches_the_ids()
+{
+    TEST_ASSERT_EQUAL_UINT8(7, presets::PRESET_COUNT);
+    for (uint8_t i = 0; i < presets::PRESET_COUNT; ++i)
+    {
+        PresetId id = static_cast<PresetId>(i);
+        score::ScoreView view = presets::getPresetById(id);
+        TEST_ASSERT_NOT_NULL(view.data);
+        TEST_ASSERT_TRUE(view.count > 0);
+
+        char name[16];
+        TEST_ASSERT_EQUAL(strlen(NAMES[i]), presets::getPresetName(id, name, sizeof(name)));
+        TEST_ASSERT_EQUAL_STRING(NAMES[i], name);
+    }
+
+    // Compile time ids give the same score
+    score::ScoreView folded = presets::getPreset<PresetId::Startup>();
+    score::ScoreView looked = presets::getPresetById(PresetId::Startup);
+    TEST_ASSERT_EQUAL_UINT16(looked.count, folded.count);
+    for (uint16_t i = 0; i < folded.count; ++i)
+    {
+        TEST_ASSERT_EQUAL_UINT16(looked.data[i].hz, folded.data[i].hz);
+        TEST_ASSERT_EQUAL_UINT8(looked.data[i].denom, folded.data[i].denom);
+    }
+}
+
+void test_unknown_id_is_empty()
+{
+    score::ScoreView view = presets::getPresetById(PresetId::Count);
+    TEST_ASSERT_NULL(view.data);
+    TEST_ASSERT_EQUAL_UINT16(0, view.count);
+
+    char name[16] = "stale";
+    TEST_ASSERT_EQUAL(0, presets::getPresetName(PresetId::Count, name, sizeof(name)));
+    TEST_ASSERT_EQUAL_STRING("", name);
+}
+
+void test_long_name_is_cut()
+{
+    char name[6];
+    TEST_ASSERT_EQUAL(5, presets::getPresetName(PresetId::Notification, name, sizeof(name)));
+    TEST_ASSERT_EQUAL_STRING("notif", name);
+    TEST_ASSERT_EQUAL(0, presets::getPresetName(PresetId::Error, name, 0));
+}
+
+void test_every_name_is_found()
+{
+    for (uint8_t i = 0; i < presets::PRESET_COUNT; ++i)
+    {
+        PresetId id = PresetId::Count;
+        TEST_ASSERT_TRUE(presets::findPresetByName(NAMES[i], id));
+        TEST_ASSERT_EQUAL_UINT8(i, static_cast<uint8_t>(id));
+    }
+
+    PresetId id = PresetId::Count;
+    TEST_ASSERT_TRUE(presets::findPresetByName("WaRnInG", id));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(PresetId::Warning), static_cast<uint8_t>(id));
+}
+
+void test_name_inside_a_command_line()
+{
+    // "play error\n": the name is not null terminated
+    const char line[] = "play error\n";
+    PresetId id = PresetId::Count;
+    TEST_ASSERT_TRUE(presets::findPresetByName(line + 5, 5, id));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(PresetId::Error), static_cast<uint8_t>(id));
+}
+
+void test_other_words_are_refused()
+{
+    const char* const words[] = {"", "err", "errors", "succes", "clicks", "startupx", "beep", "alarm", "notify", "x"};
+    for (uint8_t i = 0; i < sizeof(words) / sizeof(words[0]); ++i)
+    {
+        PresetId id = PresetId::Count;
+        TEST_ASSERT_FALSE(presets::findPresetByName(words[i], id));
+        TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(PresetId::Count), static_cast<uint8_t>(id));
+    }
+
+    PresetId id;
+    TEST_ASSERT_FALSE(presets::findPresetByName(nullptr, id));
+
+    // Every 3 letters word: most land on a used bucket, the compare refuses them
+    char word[4] = {0};
+    uint16_t found = 0;
+    for (word[0] = 'a'; word[0] <= 'z'; ++word[0])
+        for (word[1] = 'a'; word[1] <= 'z'; ++word[1])
+            for (word[2] = 'a'; word[2] <= 'z'; ++word[2]) found += presets::findPresetByName(word, id) ? 1 : 0;
+    TEST_ASSERT_EQUAL_UINT16(0, found);
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_registry_matches_the_ids);
+    RUN_TEST(test_unknown_id_is_empty);
+    RUN_TEST(test_long_name_is_cut);
+    RUN_TEST(test_every_name_is_found);
+    RUN_TEST(test_name_inside_a_command_line);
+    RUN_TEST(test_other_words_are_refused);
+    return UNITY_END();
+}
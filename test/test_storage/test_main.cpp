@@ -0,0 +1,214 @@
+#include <unity.h>
+#include "Arduino.h"
+#include "core/Eeprom.h"
+#include "codec/ScoreCodec.h"
+#include "music/Notes.h"
+#include "music/Durations.h"
+#include "storage/MelodyBank.h"
+
+// MelodyBank on the emulated EEPROM: tones survive a remount, writes rotate over the slots and a
+// record damaged by a power loss never replaces a good copy.
+
+namespace
+{
+    constexpr uint8_t HEADER_MAGIC = 0;                     // record offset of the magic byte
+
+    const score::ScoreNote TUNE_A[] = {
+        {notes::C5, durations::Eighth}, {notes::E5, durations::Eighth}, {notes::G5, durations::Quarter}
+    };
+    const score::ScoreNote TUNE_B[] = {
+        {notes::G5, durations::Half}, {notes::REST, durations::Quarter}, {notes::C4, durations::Whole}, {notes::D5, durations::Sixteenth}
+    };
+
+    /// @brief Record address of a stored tone
+    uint16_t recordOf(const MelodyBank& bank, uint8_t tone)
+    {
+        return (uint16_t)(uintptr_t)bank.scoreData(tone) - MelodyBank::HEADER_BYTES;
+    }
+
+    /// @brief Decode a stored tone and compare it with its score
+    void assertTone(const MelodyBank& bank, uint8_t tone, const score::ScoreNote* notes, uint16_t count)
+    {
+        TEST_ASSERT_TRUE(bank.contains(tone));
+
+        codec::ScoreDecoder decoder(bank.scoreData(tone), codec::MemorySpace::Eeprom);
+        TEST_ASSERT_EQUAL_UINT16(count, decoder.count());
+
+        score::ScoreNote note;
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            TEST_ASSERT_TRUE(decoder.next(note));
+            TEST_ASSERT_EQUAL_UINT16(notes[i].hz, note.hz);
+            TEST_ASSERT_EQUAL_UINT8(notes[i].denom, note.denom);
+        }
+    }
+}
+
+void setUp()
+{
+    for (uint16_t address = 0; address < eeprom::SIZE; ++address) eeprom::updateByte(address, 0xFF);
+}
+
+void tearDown() {}
+
+void test_tones_survive_a_remount()
+{
+    {
+        MelodyBank bank;
+        TEST_ASSERT_EQUAL_UINT8(0, bank.mount());
+        TEST_ASSERT_TRUE(bank.store(0, TUNE_A, 3));
+        TEST_ASSERT_TRUE(bank.store(3, TUNE_B, 4));
+    }
+
+    MelodyBank bank;
+    TEST_ASSERT_EQUAL_UINT8(2, bank.mount());
+    assertTone(bank, 0, TUNE_A, 3);
+    assertTone(bank, 3, TUNE_B, 4);
+    TEST_ASSERT_FALSE(bank.contains(1));
+    TEST_ASSERT_EQUAL_UINT8(0, bank.corruptRecords());
+
+    CompressedScoreSource source(nullptr, MelodyContext());
+    TEST_ASSERT_TRUE(bank.open(3, source));
+    TEST_ASSERT_EQUAL_UINT16(4, source.noteCount());
+    TEST_ASSERT_FALSE(bank.open(2, source));
+}
+
+void test_store_replaces_and_erase_removes()
+{
+    MelodyBank bank;
+    bank.mount();
+    bank.store(1, TUNE_A, 3);
+    bank.store(1, TUNE_B, 4);
+    assertTone(bank, 1, TUNE_B, 4);
+
+    TEST_ASSERT_TRUE(bank.erase(1));
+    TEST_ASSERT_FALSE(bank.erase(1));
+    TEST_ASSERT_FALSE(bank.contains(1));
+    TEST_ASSERT_EQUAL_UINT16(0, bank.encodedSize(1));
+
+    MelodyBank remounted;
+    TEST_ASSERT_EQUAL_UINT8(0, remounted.mount());
+}
+
+void test_invalid_requests_are_refused()
+{
+    static score::ScoreNote big[400];
+    for (uint16_t i = 0; i < 400; ++i) big[i] = score::ScoreNote{(i % 2) ? notes::C2 : notes::C5, durations::Quarter};
+
+    MelodyBank bank;
+    bank.mount();
+    TEST_ASSERT_FALSE(bank.store(4, TUNE_A, 3));           // 4 tones: 0..3
+    TEST_ASSERT_FALSE(bank.store(0, big, 400));            // larger than a record
+    TEST_ASSERT_FALSE(bank.contains(0));
+}
+
+void test_writes_rotate_over_the_slots()
+{
+    MelodyBank bank;
+    bank.mount();
+    bank.store(0, TUNE_A, 3);                              // a tone that never changes
+
+    uint32_t before[eeprom::SIZE / MelodyBank::SLOT_BYTES];
+    for (uint8_t slot = 0; slot < bank.slotCount(); ++slot) before[slot] = eeprom::writeCount(slot * MelodyBank::SLOT_BYTES + 2);
+
+    for (uint8_t i = 0; i < 70; ++i) TEST_ASSERT_TRUE(bank.store(1, (i % 2) ? TUNE_A : TUNE_B, (i % 2) ? 3 : 4));
+
+    // 70 writes over the 7 slots not holding tone 0: 10 each (the sequence byte changes every time)
+    uint16_t pinned = recordOf(bank, 0);
+    for (uint8_t slot = 0; slot < bank.slotCount(); ++slot)
+    {
+        uint16_t record = slot * MelodyBank::SLOT_BYTES;
+        if (record == pinned) continue;
+        TEST_ASSERT_UINT32_WITHIN(1, 10, eeprom::writeCount(record + 2) - before[slot]);
+    }
+    assertTone(bank, 0, TUNE_A, 3);
+}
+
+void test_damaged_record_is_skipped()
+{
+    MelodyBank bank;
+    bank.mount();
+    bank.store(2, TUNE_B, 4);
+
+    uint16_t record = recordOf(bank, 2);
+    eeprom::updateByte(record + MelodyBank::HEADER_BYTES, eeprom::readByte(record + MelodyBank::HEADER_BYTES) ^ 0x10);
+
+    MelodyBank remounted;
+    TEST_ASSERT_EQUAL_UINT8(0, remounted.mount());
+    TEST_ASSERT_EQUAL_UINT8(1, remounted.corruptRecords());
+    TEST_ASSERT_FALSE(remounted.contains(2));
+}
+
+void test_power_loss_keeps_the_previous_copy()
+{
+    MelodyBank bank;
+    bank.mount();
+    bank.store(0, TUNE_A, 3);
+    uint16_t previous = recordOf(bank, 0);
+    uint8_t validMagic = eeprom::readByte(previous + HEADER_MAGIC);
+
+    // The new copy was cut before its magic byte was written
+    bank.store(0, TUNE_B, 4);
+    uint16_t cut = recordOf(bank, 0);
+    eeprom::updateByte(cut + HEADER_MAGIC, 0xFF);
+    eeprom::updateByte(previous + HEADER_MAGIC, validMagic);
+
+    MelodyBank remounted;
+    TEST_ASSERT_EQUAL_UINT8(1, remounted.mount());
+    assertTone(remounted, 0, TUNE_A, 3);
+}
+
+void test_newer_copy_wins_when_both_survive()
+{
+    MelodyBank bank;
+    bank.mount();
+    bank.store(0, TUNE_A, 3);
+    uint16_t previous = recordOf(bank, 0);
+    uint8_t validMagic = eeprom::readByte(previous + HEADER_MAGIC);
+
+    // Cut after the new copy, before the old one was invalidated
+    bank.store(0, TUNE_B, 4);
+    eeprom::updateByte(previous + HEADER_MAGIC, validMagic);
+
+    MelodyBank remounted;
+    TEST_ASSERT_EQUAL_UINT8(1, remounted.mount());
+    assertTone(remounted, 0, TUNE_B, 4);
+}
+
+void test_mount_retires_the_older_duplicate()
+{
+    MelodyBank bank;
+    bank.mount();
+    bank.store(0, TUNE_A, 3);
+    uint16_t previous = recordOf(bank, 0);
+    uint8_t validMagic = eeprom::readByte(previous + HEADER_MAGIC);
+    bank.store(0, TUNE_B, 4);
+    eeprom::updateByte(previous + HEADER_MAGIC, validMagic);
+
+    MelodyBank remounted;
+    remounted.mount();
+    TEST_ASSERT_EQUAL_UINT8(0x00, eeprom::readByte(previous + HEADER_MAGIC));
+
+    // Erasing the tone does not bring the older copy back
+    TEST_ASSERT_TRUE(remounted.erase(0));
+    MelodyBank again;
+    TEST_ASSERT_EQUAL_UINT8(0, again.mount());
+    TEST_ASSERT_FALSE(again.contains(0));
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_tones_survive_a_remount);
+    RUN_TEST(test_store_replaces_and_erase_removes);
+    RUN_TEST(test_invalid_requests_are_refused);
+    RUN_TEST(test_writes_rotate_over_the_slots);
+    RUN_TEST(test_damaged_record_is_skipped);
+    RUN_TEST(test_power_loss_keeps_the_previous_copy);
+    RUN_TEST(test_newer_copy_wins_when_both_survive);
+    RUN_TEST(test_mount_retires_the_older_duplicate);
+    return UNITY_END();
+}
@@ -0,0 +1,227 @@
+#include <unity.h>
+#include "PlayerTestSupport.h"
+#include "player/BuzzerPlayer.h"
+#include "sources/MelodySource.h"
+#include "sources/StreamingSource.h"
+
+// A stream longer than its ring plays every step in order, refilled in idle time. When the ring
+// runs dry the underrun is counted and the playback goes on.
+
+using namespace test_support;
+
+typedef BasicBuzzerPlayer<PlainBackend> Player;
+
+namespace
+{
+    constexpr uint16_t RING_SIZE = 16;
+
+    /// @brief Counting producer that can be held back
+    struct StalledStream : CountingStream
+    {
+        bool stalled = false;
+
+        explicit StalledStream(uint16_t steps) : CountingStream(steps) {}
+
+        static uint16_t produce(Step* dest, uint16_t maxSteps, bool& ended, void* context)
+        {
+            StalledStream* self = static_cast<StalledStream*>(context);
+            if (self->stalled) return 0;
+            return CountingStream::produce(dest, maxSteps, ended, context);
+        }
+    };
+
+    void expectCounting(const Recorder& log, uint16_t count)
+    {
+        static uint16_t expected[1000];
+        for (uint16_t i = 0; i < count; ++i) expected[i] = i + 1;
+        assertHeard(log, expected, count);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_long_stream_plays_through_a_small_ring()
+{
+    static Step ring[RING_SIZE];
+    CountingStream producer(500);
+    StreamingSource stream(ring, RING_SIZE);
+    stream.setProducer(&CountingStream::produce, &producer);
+    TEST_ASSERT_EQUAL_UINT16(RING_SIZE, stream.refill());
+
+    PlainBackend backend;
+    Player player(backend);
+    player.play(stream);
+    runToEnd(player, backend, &stream);
+
+    expectCounting(backend.log, 500);
+    TEST_ASSERT_TRUE(stream.isDrained());
+    TEST_ASSERT_EQUAL_UINT16(0, stream.underruns());
+    TEST_ASSERT_EQUAL_UINT32(500, stream.produced());
+}
+
+void test_upstream_source_is_pulled_ahead()
+{
+    static Step steps[40], ring[8];
+    for (uint16_t i = 0; i < 40; ++i) steps[i] = Step{(uint16_t)(i + 1), 2};
+    MelodySource upstream;
+    upstream.reset(Melody{steps, 40});
+
+    StreamingSource stream(ring, 8);
+    stream.setProducer(upstream);
+    stream.refill();
+
+    PlainBackend backend;
+    Player player(backend);
+    player.play(stream);
+    runToEnd(player, backend, &stream);
+
+    expectCounting(backend.log, 40);
+    TEST_ASSERT_EQUAL_UINT16(0, stream.underruns());
+}
+
+void test_empty_ring_is_refilled_at_the_step_boundary()
+{
+    static Step ring[RING_SIZE];
+    CountingStream producer(100);
+    StreamingSource stream(ring, RING_SIZE);
+    stream.setProducer(&CountingStream::produce, &producer);
+
+    // Never refilled in idle time: every boundary that finds the ring empty calls the producer
+    PlainBackend backend;
+    Player player(backend);
+    player.play(stream);
+    runToEnd(player, backend);
+
+    expectCounting(backend.log, 100);
+    TEST_ASSERT_TRUE(stream.underruns() > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, stream.underrunMs());
+    TEST_ASSERT_EQUAL_UINT16(0, stream.lowWatermark());
+}
+
+void test_starved_stream_rests_until_the_producer_catches_up()
+{
+    static Step ring[RING_SIZE];
+    StalledStream producer(50);
+    StreamingSource stream(ring, RING_SIZE);
+    stream.setProducer(&StalledStream::produce, &producer);
+    stream.refill(4);
+
+    PlainBackend backend;
+    Player player(backend);
+    player.play(stream);
+    producer.stalled = true;
+    run(player, backend, 40, &stream);
+
+    TEST_ASSERT_TRUE(player.isPlaying());
+    TEST_ASSERT_TRUE(stream.underrunMs() >= StreamingSource::UNDERRUN_REST_MS);
+
+    producer.stalled = false;
+    runToEnd(player, backend, &stream);
+    expectCounting(backend.log, 50);
+
+    stream.resetCounters();
+    TEST_ASSERT_EQUAL_UINT16(0, stream.underruns());
+    TEST_ASSERT_EQUAL_UINT32(0, stream.underrunMs());
+}
+
+void test_loop_needs_a_rewinder()
+{
+    static Step ring[RING_SIZE];
+    {
+        CountingStream producer(20);
+        StreamingSource stream(ring, RING_SIZE);
+        stream.setProducer(&CountingStream::produce, &producer, &CountingStream::restart);
+        stream.refill();
+
+        PlainBackend backend;
+        Player player(backend);
+        player.play(stream, true);
+        run(player, backend, 100, &stream);
+        player.stop();
+
+        // 2 ms steps: two full passes and a half
+        static uint16_t heard[64];
+        size_t n = backend.log.heard(heard, 64);
+        TEST_ASSERT_TRUE(n >= 45);
+        for (size_t i = 0; i < n; ++i) TEST_ASSERT_EQUAL_UINT16(i % 20 + 1, heard[i]);
+    }
+
+    {
+        CountingStream producer(20);
+        StreamingSource stream(ring, RING_SIZE);
+        stream.setProducer(&CountingStream::produce, &producer);
+        stream.refill();
+
+        PlainBackend backend;
+        Player player(backend);
+        player.play(stream, true);
+        runToEnd(player, backend, &stream, 1000);
+
+        TEST_ASSERT_FALSE(player.isPlaying());
+        expectCounting(backend.log, 20);
+    }
+}
+
+void test_seek_needs_a_rewinder()
+{
+    static Step ring[RING_SIZE];
+    CountingStream producer(100);
+    StreamingSource stream(ring, RING_SIZE);
+    stream.setProducer(&CountingStream::produce, &producer);
+    stream.refill();
+
+    // Forward only: the ring is left as it was
+    Step step;
+    TEST_ASSERT_TRUE(stream.next(step));
+    TEST_ASSERT_FALSE(stream.seek(50));
+    TEST_ASSERT_TRUE(stream.next(step));
+    TEST_ASSERT_EQUAL_UINT16(2, step.freqHz);
+
+    CountingStream restartable(100);
+    stream.setProducer(&CountingStream::produce, &restartable, &CountingStream::restart);
+    stream.refill();
+    TEST_ASSERT_TRUE(stream.seek(50));
+    TEST_ASSERT_TRUE(stream.next(step));
+    TEST_ASSERT_EQUAL_UINT16(51, step.freqHz);
+}
+
+void test_seek_skips_without_underruns()
+{
+    static Step ring[4];
+    StalledStream producer(100);
+    StreamingSource stream(ring, 4);
+    stream.setProducer(&StalledStream::produce, &producer, &CountingStream::restart);
+    stream.refill();
+
+    // Far past the ring: the steps are skipped, not played through the ring
+    Step step;
+    TEST_ASSERT_TRUE(stream.seek(50));
+    TEST_ASSERT_EQUAL_UINT16(0, stream.underruns());
+    TEST_ASSERT_EQUAL_UINT16(4, stream.lowWatermark());
+    TEST_ASSERT_TRUE(stream.next(step));
+    TEST_ASSERT_EQUAL_UINT16(51, step.freqHz);
+
+    // Steps the producer cannot supply are not replaced by rests
+    TEST_ASSERT_FALSE(stream.seek(150));
+    producer.stalled = true;
+    TEST_ASSERT_FALSE(stream.seek(10));
+    TEST_ASSERT_EQUAL_UINT16(0, stream.underruns());
+    TEST_ASSERT_EQUAL_UINT32(0, stream.underrunMs());
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_long_stream_plays_through_a_small_ring);
+    RUN_TEST(test_upstream_source_is_pulled_ahead);
+    RUN_TEST(test_empty_ring_is_refilled_at_the_step_boundary);
+    RUN_TEST(test_starved_stream_rests_until_the_producer_catches_up);
+    RUN_TEST(test_loop_needs_a_rewinder);
+    RUN_TEST(test_seek_needs_a_rewinder);
+    RUN_TEST(test_seek_skips_without_underruns);
+    return UNITY_END();
+}
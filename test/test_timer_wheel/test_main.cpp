@@ -0,0 +1,169 @@
+#include <unity.h>
+#include "Arduino.h"
+#include "Timer/TimerWheel.h"
+
+// Every timer fires on its own tick, whatever level of the wheel it was placed in and however
+// many times it cascaded down.
+
+namespace
+{
+    /// @brief Timer that records the tick it fired on
+    struct Probe
+    {
+        TimerWheel* wheel = nullptr;
+        WheelTimer timer;
+        uint32_t firedTick = 0;
+        uint32_t fires = 0;
+        uint32_t period = 0;            // > 0: schedules itself again
+
+        Probe() {}
+        explicit Probe(TimerWheel& w) { attach(w); }
+
+        void attach(TimerWheel& w)
+        {
+            wheel = &w;
+            timer = WheelTimer(&Probe::fire, this);
+        }
+
+        static void fire(void* context)
+        {
+            Probe* self = static_cast<Probe*>(context);
+            self->firedTick = self->wheel->now();
+            ++self->fires;
+            if (self->period > 0) self->wheel->schedule(self->timer, self->period);
+        }
+    };
+
+    /// @brief Move the clock tick by tick, polling like loop() would
+    void advanceTicks(TimerWheel& wheel, uint32_t ticks)
+    {
+        for (uint32_t i = 0; i < ticks; ++i)
+        {
+            arduino_shim::nowUs() += wheel.tickUs();
+            wheel.poll();
+        }
+    }
+}
+
+void setUp() { arduino_shim::nowUs() = 12345; }
+void tearDown() {}
+
+void test_timers_fire_on_their_tick_at_every_level()
+{
+    TimerWheel wheel(1000);
+
+    const uint32_t delays[] = {0, 1, 15, 16, 17, 255, 256, 300, 4095, 4096, 5000, 65535};
+    const uint8_t count = sizeof(delays) / sizeof(delays[0]);
+    Probe probes[count];
+
+    uint32_t start = wheel.now();
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        probes[i].attach(wheel);
+        wheel.schedule(probes[i].timer, delays[i]);
+    }
+
+    advanceTicks(wheel, 65540);
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        TEST_ASSERT_EQUAL_UINT32(1, probes[i].fires);
+        TEST_ASSERT_EQUAL_UINT32(start + delays[i], probes[i].firedTick);
+        TEST_ASSERT_FALSE(probes[i].timer.isArmed());
+    }
+}
+
+void test_timer_past_the_horizon_waits_its_tick()
+{
+    TimerWheel wheel(1000);
+    Probe probe(wheel);
+
+    uint32_t start = wheel.now();
+    wheel.schedule(probe.timer, 200000);
+    advanceTicks(wheel, 199990);
+    TEST_ASSERT_EQUAL_UINT32(0, probe.fires);
+
+    advanceTicks(wheel, 20);
+    TEST_ASSERT_EQUAL_UINT32(1, probe.fires);
+    TEST_ASSERT_EQUAL_UINT32(start + 200000, probe.firedTick);
+}
+
+void test_cancel_and_reschedule()
+{
+    TimerWheel wheel(1000);
+    Probe cancelled(wheel), moved(wheel);
+
+    wheel.schedule(cancelled.timer, 40);
+    wheel.schedule(moved.timer, 40);
+    advanceTicks(wheel, 10);
+
+    wheel.cancel(cancelled.timer);
+    wheel.cancel(cancelled.timer);
+    uint32_t start = wheel.now();
+    wheel.schedule(moved.timer, 100);
+    advanceTicks(wheel, 200);
+
+    TEST_ASSERT_EQUAL_UINT32(0, cancelled.fires);
+    TEST_ASSERT_EQUAL_UINT32(1, moved.fires);
+    TEST_ASSERT_EQUAL_UINT32(start + 100, moved.firedTick);
+}
+
+void test_periodic_timer_does_not_drift()
+{
+    TimerWheel wheel(1000);
+    Probe probe(wheel);
+    probe.period = 7;
+
+    uint32_t start = wheel.now();
+    wheel.schedule(probe.timer, 7);
+    advanceTicks(wheel, 7 * 1000);
+
+    TEST_ASSERT_EQUAL_UINT32(1000, probe.fires);
+    TEST_ASSERT_EQUAL_UINT32(start + 7000, probe.firedTick);
+}
+
+void test_deadline_in_us_is_rounded_up_to_a_tick()
+{
+    TimerWheel wheel(1000);
+    Probe probe(wheel);
+
+    // Half way into a tick: fires on the tick after the deadline, never before it
+    unsigned long deadlineUs = micros() + 5500;
+    wheel.scheduleAtUs(probe.timer, deadlineUs);
+    while (probe.fires == 0)
+    {
+        arduino_shim::nowUs() += 100;
+        wheel.poll();
+    }
+
+    TEST_ASSERT_TRUE(micros() >= deadlineUs);
+    TEST_ASSERT_TRUE(micros() - deadlineUs <= 1000);
+}
+
+void test_missed_ticks_are_run_after_a_blocking_call()
+{
+    TimerWheel wheel(1000);
+    Probe probe(wheel);
+
+    uint32_t start = wheel.now();
+    wheel.schedule(probe.timer, 30);
+    arduino_shim::nowUs() += 100000;
+    wheel.poll();
+
+    TEST_ASSERT_EQUAL_UINT32(1, probe.fires);
+    TEST_ASSERT_EQUAL_UINT32(start + 30, probe.firedTick);
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_timers_fire_on_their_tick_at_every_level);
+    RUN_TEST(test_timer_past_the_horizon_waits_its_tick);
+    RUN_TEST(test_cancel_and_reschedule);
+    RUN_TEST(test_periodic_timer_does_not_drift);
+    RUN_TEST(test_deadline_in_us_is_rounded_up_to_a_tick);
+    RUN_TEST(test_missed_ticks_are_run_after_a_blocking_call);
+    return UNITY_END();
+}
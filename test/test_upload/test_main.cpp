@@ -0,0 +1,344 @@
+#include <unity.h>
+#include "Arduino.h"
+#include "core/Cobs.h"
+#include "protocol/UploadProtocol.h"
+#include "protocol/UploadReceiver.h"
+
+// COBS and the upload frames round trip, and the receiver only accepts what checks: a corrupt
+// frame gets no reply, a retransmitted one is answered again without being applied twice.
+
+using upload::FrameType;
+using upload::Status;
+
+namespace
+{
+    constexpr uint16_t BUFFER_STEPS = 40;
+
+    /// @brief Host end of the link: sends frames to the receiver and decodes its replies
+    struct Host
+    {
+        UploadReceiver* receiver;
+        uint8_t seq = 0;
+        bool replied = false;
+        uint8_t replyType = 0;
+        uint8_t replySeq = 0;
+        Status status = Status::Ok;
+        uint16_t received = 0;
+        UploadEvent event;
+
+        static void sink(const uint8_t* bytes, size_t length, void* context)
+        {
+            Host* self = static_cast<Host*>(context);
+            uint8_t decoded[16];
+            TEST_ASSERT_EQUAL_UINT8(upload::DELIMITER, bytes[0]);
+            TEST_ASSERT_EQUAL_UINT8(upload::DELIMITER, bytes[length - 1]);
+
+            size_t n = upload::decodeFrame(bytes + 1, length - 2, decoded, sizeof(decoded));
+            TEST_ASSERT_EQUAL(upload::HEAD_BYTES + upload::REPLY_BODY_BYTES, n);
+            self->replied = true;
+            self->replyType = decoded[0];
+            self->replySeq = decoded[1];
+            self->status = (Status)decoded[2];
+            self->received = upload::readU16(decoded + 3);
+        }
+
+        /// @brief Encode a frame with the current seq
+        size_t encode(FrameType type, const uint8_t* body, size_t length, uint8_t* frame, size_t capacity)
+        {
+            return upload::encodeFrame((uint8_t)type, seq, body, length, frame, capacity);
+        }
+
+        /// @brief Put bytes on the line, keep the last event
+        void line(const uint8_t* bytes, size_t length)
+        {
+            replied = false;
+            event.type = UploadEvent::Type::None;
+            for (size_t i = 0; i < length; ++i)
+            {
+                UploadEvent e = receiver->feed(bytes[i]);
+                if (e.type != UploadEvent::Type::None) event = e;
+            }
+        }
+
+        /// @brief Send a frame with the current seq
+        void send(FrameType type, const uint8_t* body = nullptr, size_t length = 0)
+        {
+            uint8_t frame[upload::maxFrameSize(upload::MAX_DATA_BYTES)];
+            line(frame, encode(type, body, length, frame, sizeof(frame)));
+        }
+
+        /// @brief Send a frame and move to the next seq
+        void request(FrameType type, const uint8_t* body = nullptr, size_t length = 0)
+        {
+            send(type, body, length);
+            ++seq;
+        }
+
+        void begin(upload::Kind kind, uint16_t total)
+        {
+            uint8_t body[3] = {(uint8_t)kind};
+            upload::writeU16(body + 1, total);
+            request(FrameType::Begin, body, 3);
+        }
+
+        /// @brief DATA frame of steps freq = base + i, duration = 10 * (base + i)
+        size_t stepsFrame(uint16_t offset, uint16_t base, uint8_t count, uint8_t* body)
+        {
+            upload::writeU16(body, offset);
+            for (uint8_t i = 0; i < count; ++i)
+            {
+                uint8_t* wire = body + 2 + i * upload::STEP_WIRE_BYTES;
+                uint32_t duration = 10UL * (base + i);
+                upload::writeU16(wire, base + i);
+                upload::writeU16(wire + 2, (uint16_t)duration);
+                upload::writeU16(wire + 4, (uint16_t)(duration >> 16));
+            }
+            return 2 + count * upload::STEP_WIRE_BYTES;
+        }
+    };
+
+    /// @brief Score handler that keeps what it was given
+    struct Store
+    {
+        uint8_t tone = 0xFF;
+        uint8_t bytes[64];
+        uint16_t length = 0;
+
+        static bool handle(uint8_t tone, const uint8_t* encoded, uint16_t length, void* context)
+        {
+            Store* self = static_cast<Store*>(context);
+            if (length > sizeof(self->bytes)) return false;
+            self->tone = tone;
+            self->length = length;
+            for (uint16_t i = 0; i < length; ++i) self->bytes[i] = encoded[i];
+            return true;
+        }
+    };
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_cobs_round_trip()
+{
+    static uint8_t data[600], encoded[cobs::maxEncodedSize(600)], decoded[600];
+    const size_t lengths[] = {0, 1, 253, 254, 255, 508, 600};
+
+    for (uint8_t k = 0; k < sizeof(lengths) / sizeof(lengths[0]); ++k)
+    {
+        size_t length = lengths[k];
+        for (size_t i = 0; i < length; ++i) data[i] = (i % 7 == 0) ? 0 : (uint8_t)(i * 31 + k);
+
+        size_t n = cobs::encode(data, length, encoded, sizeof(encoded));
+        TEST_ASSERT_TRUE(n > 0);
+        TEST_ASSERT_TRUE(n <= cobs::maxEncodedSize(length));
+        for (size_t i = 0; i < n; ++i) TEST_ASSERT_TRUE(encoded[i] != 0);
+
+        TEST_ASSERT_EQUAL(length, cobs::decode(encoded, n, decoded, sizeof(decoded)));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(data, decoded, length);
+    }
+
+    // Long runs without a zero need a code every 254 bytes
+    for (size_t i = 0; i < 600; ++i) data[i] = 0x55;
+    size_t n = cobs::encode(data, 600, encoded, sizeof(encoded));
+    TEST_ASSERT_EQUAL(cobs::maxEncodedSize(600), n);
+    TEST_ASSERT_EQUAL(600, cobs::decode(encoded, n, decoded, sizeof(decoded)));
+}
+
+void test_cobs_refuses_small_buffers_and_truncated_frames()
+{
+    const uint8_t data[] = {1, 0, 2, 3, 0, 4};
+    uint8_t encoded[16], decoded[16];
+
+    TEST_ASSERT_EQUAL(0, cobs::encode(data, sizeof(data), encoded, 4));
+    size_t n = cobs::encode(data, sizeof(data), encoded, sizeof(encoded));
+    TEST_ASSERT_EQUAL(0, cobs::decode(encoded, n - 1, decoded, sizeof(decoded)));
+    TEST_ASSERT_EQUAL(0, cobs::decode(encoded, n, decoded, 3));
+}
+
+void test_frame_crc_catches_a_flipped_bit()
+{
+    const uint8_t body[] = {0, 1, 2, 0, 0xFF};
+    uint8_t frame[upload::maxFrameSize(sizeof(body))], decoded[16];
+
+    size_t n = upload::encodeFrame((uint8_t)FrameType::Data, 7, body, sizeof(body), frame, sizeof(frame));
+    TEST_ASSERT_TRUE(n > 0);
+    TEST_ASSERT_EQUAL(upload::HEAD_BYTES + sizeof(body), upload::decodeFrame(frame + 1, n - 2, decoded, sizeof(decoded)));
+    TEST_ASSERT_EQUAL_UINT8(7, decoded[1]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(body, decoded + 2, sizeof(body));
+
+    for (size_t byte = 1; byte < n - 1; ++byte)
+    {
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            frame[byte] ^= (uint8_t)(1 << bit);
+            if (frame[byte] != 0) TEST_ASSERT_EQUAL(0, upload::decodeFrame(frame + 1, n - 2, decoded, sizeof(decoded)));
+            frame[byte] ^= (uint8_t)(1 << bit);
+        }
+    }
+}
+
+void test_steps_upload()
+{
+    static Step buffer[BUFFER_STEPS];
+    UploadReceiver receiver(buffer, BUFFER_STEPS);
+    Host host;
+    host.receiver = &receiver;
+    receiver.setReplySink(&Host::sink, &host);
+
+    host.begin(upload::Kind::Steps, 20);
+    TEST_ASSERT_TRUE(host.event.type == UploadEvent::Type::UploadStarted);
+    TEST_ASSERT_TRUE(host.status == Status::Ok);
+
+    uint8_t body[upload::MAX_DATA_BYTES];
+    host.request(FrameType::Data, body, host.stepsFrame(0, 100, 16, body));
+    host.request(FrameType::Data, body, host.stepsFrame(16, 116, 4, body));
+    TEST_ASSERT_EQUAL_UINT16(20, host.received);
+
+    uint8_t loop = 1;
+    host.request(FrameType::Commit, &loop, 1);
+    TEST_ASSERT_TRUE(host.event.type == UploadEvent::Type::MelodyReady);
+    TEST_ASSERT_TRUE(host.event.loop);
+
+    Melody melody = receiver.melody();
+    TEST_ASSERT_EQUAL_UINT16(20, melody.count);
+    for (uint16_t i = 0; i < 20; ++i)
+    {
+        TEST_ASSERT_EQUAL_UINT16(100 + i, melody.steps[i].freqHz);
+        TEST_ASSERT_EQUAL_UINT32(10UL * (100 + i), melody.steps[i].durationMs);
+    }
+}
+
+void test_retransmitted_frame_is_not_applied_twice()
+{
+    static Step buffer[BUFFER_STEPS];
+    UploadReceiver receiver(buffer, BUFFER_STEPS);
+    Host host;
+    host.receiver = &receiver;
+    receiver.setReplySink(&Host::sink, &host);
+    host.begin(upload::Kind::Steps, 8);
+
+    // The reply of the first DATA got lost: the host sends it again with the same seq
+    uint8_t body[upload::MAX_DATA_BYTES];
+    size_t length = host.stepsFrame(0, 300, 4, body);
+    host.send(FrameType::Data, body, length);
+    host.send(FrameType::Data, body, length);
+    TEST_ASSERT_TRUE(host.replied);
+    TEST_ASSERT_TRUE(host.status == Status::Ok);
+    TEST_ASSERT_EQUAL_UINT16(4, host.received);
+    ++host.seq;
+
+    // A new seq with an old offset is out of order
+    host.request(FrameType::Data, body, length);
+    TEST_ASSERT_TRUE(host.status == Status::BadRange);
+    TEST_ASSERT_EQUAL_UINT16(4, receiver.received());
+}
+
+void test_corrupt_frame_gets_no_reply_and_keeps_the_data()
+{
+    static Step buffer[BUFFER_STEPS];
+    UploadReceiver receiver(buffer, BUFFER_STEPS);
+    Host host;
+    host.receiver = &receiver;
+    receiver.setReplySink(&Host::sink, &host);
+    host.begin(upload::Kind::Steps, 8);
+
+    uint8_t body[upload::MAX_DATA_BYTES];
+    host.request(FrameType::Data, body, host.stepsFrame(0, 500, 4, body));
+
+    // Second half damaged on the line: dropped silently, the first half is untouched
+    uint8_t frame[upload::maxFrameSize(upload::MAX_DATA_BYTES)];
+    size_t n = host.encode(FrameType::Data, body, host.stepsFrame(4, 504, 4, body), frame, sizeof(frame));
+    frame[n / 2] ^= 0x04;
+    host.line(frame, n);
+    TEST_ASSERT_FALSE(host.replied);
+    TEST_ASSERT_EQUAL_UINT16(1, receiver.crcErrors() + receiver.framingErrors());
+    TEST_ASSERT_EQUAL_UINT16(4, receiver.received());
+
+    // Resent after the timeout, behind a log line that shares the Serial line
+    const char log[] = "[I] bank: tone 0 -> slot 3\r\n";
+    host.line(reinterpret_cast<const uint8_t*>(log), sizeof(log) - 1);
+    host.request(FrameType::Data, body, host.stepsFrame(4, 504, 4, body));
+    TEST_ASSERT_TRUE(host.status == Status::Ok);
+
+    uint8_t loop = 0;
+    host.request(FrameType::Commit, &loop, 1);
+    TEST_ASSERT_TRUE(host.event.type == UploadEvent::Type::MelodyReady);
+    for (uint16_t i = 0; i < 8; ++i) TEST_ASSERT_EQUAL_UINT16(500 + i, receiver.melody().steps[i].freqHz);
+}
+
+void test_commit_needs_a_complete_upload()
+{
+    static Step buffer[BUFFER_STEPS];
+    UploadReceiver receiver(buffer, BUFFER_STEPS);
+    Host host;
+    host.receiver = &receiver;
+    receiver.setReplySink(&Host::sink, &host);
+
+    uint8_t loop = 0;
+    host.request(FrameType::Commit, &loop, 1);
+    TEST_ASSERT_TRUE(host.status == Status::BadState);
+
+    host.begin(upload::Kind::Steps, BUFFER_STEPS + 1);
+    TEST_ASSERT_TRUE(host.status == Status::BadRange);
+
+    host.begin(upload::Kind::Steps, 8);
+    uint8_t body[upload::MAX_DATA_BYTES];
+    host.request(FrameType::Data, body, host.stepsFrame(0, 100, 4, body));
+    host.request(FrameType::Commit, &loop, 1);
+    TEST_ASSERT_TRUE(host.status == Status::BadState);
+    TEST_ASSERT_EQUAL_UINT16(0, receiver.melody().count);
+
+    host.request(FrameType::Ping);
+    TEST_ASSERT_TRUE(host.status == Status::Ok);
+    TEST_ASSERT_EQUAL_UINT8(upload::REPLY_FLAG | (uint8_t)FrameType::Ping, host.replyType);
+}
+
+void test_score_upload_goes_to_the_handler()
+{
+    static Step buffer[BUFFER_STEPS];
+    UploadReceiver receiver(buffer, BUFFER_STEPS);
+    Host host;
+    Store store;
+    host.receiver = &receiver;
+    receiver.setReplySink(&Host::sink, &host);
+
+    uint8_t score[30];
+    for (uint8_t i = 0; i < sizeof(score); ++i) score[i] = (uint8_t)(i * 9);
+
+    host.begin(upload::Kind::Score, sizeof(score));
+    uint8_t body[2 + sizeof(score)];
+    upload::writeU16(body, 0);
+    for (uint8_t i = 0; i < sizeof(score); ++i) body[2 + i] = score[i];
+    host.request(FrameType::Data, body, sizeof(body));
+
+    // No handler yet: the upload stays open
+    uint8_t tone = 2;
+    host.request(FrameType::Commit, &tone, 1);
+    TEST_ASSERT_TRUE(host.status == Status::StoreFailed);
+
+    receiver.setScoreHandler(&Store::handle, &store);
+    host.request(FrameType::Commit, &tone, 1);
+    TEST_ASSERT_TRUE(host.status == Status::Ok);
+    TEST_ASSERT_TRUE(host.event.type == UploadEvent::Type::ScoreStored);
+    TEST_ASSERT_EQUAL_UINT8(2, store.tone);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(score), store.length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(score, store.bytes, sizeof(score));
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_cobs_round_trip);
+    RUN_TEST(test_cobs_refuses_small_buffers_and_truncated_frames);
+    RUN_TEST(test_frame_crc_catches_a_flipped_bit);
+    RUN_TEST(test_steps_upload);
+    RUN_TEST(test_retransmitted_frame_is_not_applied_twice);
+    RUN_TEST(test_corrupt_frame_gets_no_reply_and_keeps_the_data);
+    RUN_TEST(test_commit_needs_a_complete_upload);
+    RUN_TEST(test_score_upload_goes_to_the_handler);
+    return UNITY_END();
+}
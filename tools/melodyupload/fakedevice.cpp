@@ -0,0 +1,156 @@
+/**
+ * @file fakedevice.cpp
+ * @brief Pseudo-terminal stand-in for a device, to try melodyupload without a board
+ *
+ * @details
+ * Opens a pseudo-terminal, prints the name of its slave side (the "port" to give melodyupload)
+ * and feeds every byte written to it to the firmware UploadReceiver, replies included. Uploaded
+ * melodies and tones are printed instead of played; scores are kept in memory as the EEPROM bank
+ * would keep them, and decoded with the firmware codec when played.
+ *
+ * With -d <permille>, bytes coming from the host are corrupted at random (one in 1000/permille)
+ * to exercise the CRC and the resends.
+ *
+ * Build (from the repository root):
+ *      g++ -std=c++11 -O2 -Iinclude tools/melodyupload/fakedevice.cpp src/protocol/UploadReceiver.cpp src/protocol/UploadProtocol.cpp src/core/Cobs.cpp src/codec/ScoreCodec.cpp src/core/Eeprom.cpp src/music/Pitch.cpp -o fakedevice
+ *
+ * Usage:
+ *      ./fakedevice [-d permille] &         # prints e.g. "port: /dev/pts/3"
+ *      ./melodyupload -w 0 /dev/pts/3 steps melody.txt
+ */
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "codec/ScoreCodec.h"
+#include "protocol/UploadReceiver.h"
+
+namespace {
+
+    constexpr uint16_t STEP_CAPACITY = 64;      // as the firmware example
+
+    Step steps[STEP_CAPACITY];
+    std::map<uint8_t, std::vector<uint8_t>> bank;
+
+    void sendReply(const uint8_t* bytes, size_t length, void* context)
+    {
+        int fd = *static_cast<int*>(context);
+        while (length > 0)
+        {
+            ssize_t n = write(fd, bytes, length);
+            if (n <= 0) return;
+            bytes += n;
+            length -= (size_t)n;
+        }
+    }
+
+    bool storeTone(uint8_t tone, const uint8_t* encoded, uint16_t length, void*)
+    {
+        if (length > 120) return false;             // MelodyBank::MAX_PAYLOAD
+        bank[tone].assign(encoded, encoded + length);
+        return true;
+    }
+
+    void printMelody(const Melody& melody, bool loop)
+    {
+        uint32_t totalMs = 0;
+        for (size_t i = 0; i < melody.count; ++i) totalMs += melody.steps[i].durationMs;
+
+        printf("melody: %zu steps, %u ms%s:", melody.count, (unsigned)totalMs, loop ? ", loop" : "");
+        for (size_t i = 0; i < melody.count && i < 8; ++i)
+        {
+            printf(" %u/%u", (unsigned)melody.steps[i].freqHz, (unsigned)melody.steps[i].durationMs);
+        }
+        printf("%s\n", melody.count > 8 ? " ..." : "");
+    }
+
+    void playTone(uint8_t tone)
+    {
+        auto found = bank.find(tone);
+        if (found == bank.end())
+        {
+            printf("play tone %u: no such tone\n", (unsigned)tone);
+            return;
+        }
+
+        codec::ScoreDecoder decoder(found->second.data(), codec::MemorySpace::Ram);
+        score::ScoreNote note;
+        printf("play tone %u:", (unsigned)tone);
+        while (decoder.next(note)) printf(" %u/%u", (unsigned)note.hz, (unsigned)note.denom);
+        printf("\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int dropPermille = 0;
+    if (argc >= 3 && strcmp(argv[1], "-d") == 0) dropPermille = atoi(argv[2]);
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        perror("posix_openpt");
+        return 1;
+    }
+
+    // Raw on both sides, as a real Serial line
+    termios tty;
+    tcgetattr(master, &tty);
+    cfmakeraw(&tty);
+    tcsetattr(master, TCSANOW, &tty);
+
+    printf("port: %s\n", ptsname(master));
+    fflush(stdout);
+
+    UploadReceiver receiver(steps, STEP_CAPACITY);
+    receiver.setReplySink(sendReply, &master);
+    receiver.setScoreHandler(storeTone, nullptr);
+
+    std::mt19937 random(1);
+    unsigned reported = 0;
+    while (true)
+    {
+        pollfd pfd = {master, POLLIN, 0};
+        if (poll(&pfd, 1, -1) <= 0) continue;
+
+        uint8_t chunk[256];
+        ssize_t n = read(master, chunk, sizeof(chunk));
+        if (n <= 0)
+        {
+            usleep(10000);          // no slave opened yet, or the host closed it
+            continue;
+        }
+
+        for (ssize_t i = 0; i < n; ++i)
+        {
+            uint8_t byte = chunk[i];
+            if (dropPermille > 0 && (int)(random() % 1000) < dropPermille) byte ^= (uint8_t)(1 + random() % 255);
+
+            UploadEvent event = receiver.feed(byte);
+            switch (event.type)
+            {
+                case UploadEvent::Type::UploadStarted:  printf("upload started\n"); break;
+                case UploadEvent::Type::MelodyReady:    printMelody(receiver.melody(), event.loop); break;
+                case UploadEvent::Type::ScoreStored:    printf("tone %u stored (%zu bytes)\n", (unsigned)event.tone, bank[event.tone].size()); break;
+                case UploadEvent::Type::PlayTone:       playTone(event.tone); break;
+                case UploadEvent::Type::Stop:           printf("stop\n"); break;
+                default: break;
+            }
+        }
+        fflush(stdout);
+
+        unsigned errors = receiver.crcErrors() + receiver.framingErrors();
+        if (errors != reported)
+        {
+            reported = errors;
+            fprintf(stderr, "frames ok=%u crc errors=%u framing errors=%u\n", receiver.goodFrames(), receiver.crcErrors(), receiver.framingErrors());
+        }
+    }
+}
@@ -0,0 +1,339 @@
+/**
+ * @file melodyupload.cpp
+ * @brief Host side of the Serial melody upload (see include/protocol/UploadProtocol.h)
+ *
+ * @details
+ * Sends melodies to a running device over its Serial port (115200 8N1, raw), one frame at a time,
+ * waiting for each reply: a frame without a reply after a timeout is sent again (same seq, the
+ * device does not apply it twice).
+ *
+ *  - steps: a file of "freq durationMs" pairs, played from RAM as soon as it is complete
+ *  - score: a file of "hz denom" pairs (as for scorepack), encoded here with the firmware codec
+ *    and stored as a tone in the EEPROM melody bank
+ *
+ * Opening the port resets most Arduino boards: the tool waits for the bootloader (-w ms) and then
+ * pings until the device answers. Against tools/melodyupload/fakedevice use -w 0.
+ *
+ * Build (from the repository root):
+ *      g++ -std=c++11 -O2 -Iinclude tools/melodyupload/melodyupload.cpp src/protocol/UploadProtocol.cpp src/core/Cobs.cpp src/codec/ScoreCodec.cpp src/core/Eeprom.cpp src/music/Pitch.cpp -o melodyupload
+ *
+ * Usage:
+ *      ./melodyupload [-w bootMs] <port> ping
+ *      ./melodyupload [-w bootMs] <port> steps <file> [loop]
+ *      ./melodyupload [-w bootMs] <port> score <tone> <file>
+ *      ./melodyupload [-w bootMs] <port> play <tone>
+ *      ./melodyupload [-w bootMs] <port> stop
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "codec/ScoreCodec.h"
+#include "protocol/UploadProtocol.h"
+
+namespace {
+
+    constexpr int REPLY_TIMEOUT_MS = 500;
+    constexpr int RETRIES = 5;
+    constexpr int BOOT_PINGS = 10;
+
+    const char* STATUS_NAMES[] = {"ok", "bad state", "bad range", "store failed", "unknown frame"};
+
+    struct Port
+    {
+        int fd = -1;
+        uint8_t seq = 0;
+        std::vector<uint8_t> pending;   // bytes received since the last delimiter
+        int resends = 0;
+    };
+
+    bool openPort(Port& port, const char* path)
+    {
+        port.fd = open(path, O_RDWR | O_NOCTTY);
+        if (port.fd < 0) return false;
+
+        termios tty;
+        if (tcgetattr(port.fd, &tty) == 0)
+        {
+            cfmakeraw(&tty);
+            cfsetispeed(&tty, B115200);
+            cfsetospeed(&tty, B115200);
+            tty.c_cflag |= CLOCAL | CREAD;
+            tty.c_cc[VMIN] = 0;
+            tty.c_cc[VTIME] = 0;
+            tcsetattr(port.fd, TCSANOW, &tty);
+        }
+        return true;
+    }
+
+    bool writeAll(int fd, const uint8_t* data, size_t length)
+    {
+        while (length > 0)
+        {
+            ssize_t n = write(fd, data, length);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            length -= (size_t)n;
+        }
+        return true;
+    }
+
+    /// Wait for the reply to (type, seq); other frames and non frame bytes (device logs) are skipped
+    bool readReply(Port& port, uint8_t type, uint8_t seq, upload::Status& status, uint16_t& received)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(REPLY_TIMEOUT_MS);
+
+        while (true)
+        {
+            int left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) return false;
+
+            pollfd pfd = {port.fd, POLLIN, 0};
+            if (poll(&pfd, 1, left) <= 0) continue;
+
+            uint8_t chunk[256];
+            ssize_t n = read(port.fd, chunk, sizeof(chunk));
+            if (n <= 0) continue;
+
+            for (ssize_t i = 0; i < n; ++i)
+            {
+                if (chunk[i] != upload::DELIMITER)
+                {
+                    if (port.pending.size() < 512) port.pending.push_back(chunk[i]);
+                    continue;
+                }
+
+                uint8_t frame[64];
+                size_t length = port.pending.empty() ? 0
+                              : upload::decodeFrame(port.pending.data(), port.pending.size(), frame, sizeof(frame));
+                port.pending.clear();
+
+                if (length == upload::HEAD_BYTES + upload::REPLY_BODY_BYTES
+                    && frame[0] == (upload::REPLY_FLAG | type) && frame[1] == seq)
+                {
+                    status = (upload::Status)frame[2];
+                    received = upload::readU16(frame + 3);
+                    return true;
+                }
+            }
+        }
+    }
+
+    /// Send a frame until it is answered
+    bool transact(Port& port, upload::FrameType type, const std::vector<uint8_t>& body, upload::Status& status, uint16_t& received, int attempts = RETRIES)
+    {
+        uint8_t seq = ++port.seq;
+        std::vector<uint8_t> frame(upload::maxFrameSize(body.size()));
+        size_t length = upload::encodeFrame((uint8_t)type, seq, body.data(), body.size(), frame.data(), frame.size());
+
+        for (int attempt = 0; attempt < attempts; ++attempt)
+        {
+            if (attempt > 0) ++port.resends;
+            if (!writeAll(port.fd, frame.data(), length)) return false;
+            if (readReply(port, (uint8_t)type, seq, status, received)) return true;
+        }
+        return false;
+    }
+
+    bool expectOk(Port& port, upload::FrameType type, const std::vector<uint8_t>& body, uint16_t* received = nullptr)
+    {
+        upload::Status status;
+        uint16_t count = 0;
+        if (!transact(port, type, body, status, count))
+        {
+            fprintf(stderr, "no reply from the device\n");
+            return false;
+        }
+        if (status != upload::Status::Ok)
+        {
+            unsigned code = (unsigned)status;
+            fprintf(stderr, "device: %s\n", code < sizeof(STATUS_NAMES) / sizeof(STATUS_NAMES[0]) ? STATUS_NAMES[code] : "?");
+            return false;
+        }
+        if (received) *received = count;
+        return true;
+    }
+
+    std::vector<uint8_t> u16Body(uint16_t value)
+    {
+        std::vector<uint8_t> body(2);
+        upload::writeU16(body.data(), value);
+        return body;
+    }
+
+    /// BEGIN, DATA frames of at most chunk bytes (records), COMMIT
+    bool sendUpload(Port& port, upload::Kind kind, const std::vector<uint8_t>& payload, uint16_t total, uint8_t unitBytes, uint8_t commitArg)
+    {
+        std::vector<uint8_t> begin = {(uint8_t)kind, (uint8_t)total, (uint8_t)(total >> 8)};
+        if (!expectOk(port, upload::FrameType::Begin, begin)) return false;
+
+        size_t chunkUnits = (upload::MAX_DATA_BYTES - 2) / unitBytes;
+        for (uint16_t offset = 0; offset < total; )
+        {
+            uint16_t units = (uint16_t)std::min<size_t>(chunkUnits, total - offset);
+            std::vector<uint8_t> body = u16Body(offset);
+            body.insert(body.end(), payload.begin() + (size_t)offset * unitBytes, payload.begin() + (size_t)(offset + units) * unitBytes);
+
+            uint16_t received = 0;
+            if (!expectOk(port, upload::FrameType::Data, body, &received)) return false;
+            offset = received;
+        }
+
+        return expectOk(port, upload::FrameType::Commit, {commitArg});
+    }
+
+    bool loadSteps(const char* path, std::vector<uint8_t>& payload, uint16_t& count)
+    {
+        FILE* file = fopen(path, "r");
+        if (!file) return false;
+
+        char line[128];
+        count = 0;
+        while (fgets(line, sizeof(line), file))
+        {
+            if (line[0] == '#') continue;
+
+            unsigned freq = 0;
+            unsigned long duration = 0;
+            if (sscanf(line, "%u %lu", &freq, &duration) != 2) continue;
+
+            uint8_t record[upload::STEP_WIRE_BYTES];
+            upload::writeU16(record, (uint16_t)freq);
+            upload::writeU16(record + 2, (uint16_t)duration);
+            upload::writeU16(record + 4, (uint16_t)(duration >> 16));
+            payload.insert(payload.end(), record, record + sizeof(record));
+            ++count;
+        }
+
+        fclose(file);
+        return count > 0;
+    }
+
+    bool loadScore(const char* path, std::vector<uint8_t>& encoded)
+    {
+        FILE* file = fopen(path, "r");
+        if (!file) return false;
+
+        std::vector<score::ScoreNote> notes;
+        char line[128];
+        while (fgets(line, sizeof(line), file))
+        {
+            if (line[0] == '#') continue;
+
+            unsigned hz = 0, denom = 0;
+            if (sscanf(line, "%u %u", &hz, &denom) == 2) notes.push_back(score::ScoreNote{(uint16_t)hz, (uint8_t)denom});
+        }
+        fclose(file);
+
+        encoded.resize(codec::MAX_HEADER_SIZE + notes.size() * 5 + 1);
+        size_t size = codec::encodeScore(notes.data(), (uint16_t)notes.size(), encoded.data(), encoded.size());
+        encoded.resize(size);
+        return size > 0;
+    }
+
+    int usage()
+    {
+        fprintf(stderr,
+                "usage: melodyupload [-w bootMs] <port> ping\n"
+                "       melodyupload [-w bootMs] <port> steps <file> [loop]\n"
+                "       melodyupload [-w bootMs] <port> score <tone> <file>\n"
+                "       melodyupload [-w bootMs] <port> play <tone>\n"
+                "       melodyupload [-w bootMs] <port> stop\n");
+        return 2;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int arg = 1;
+    int bootMs = 2000;
+    if (arg + 1 < argc && strcmp(argv[arg], "-w") == 0)
+    {
+        bootMs = atoi(argv[arg + 1]);
+        arg += 2;
+    }
+    if (argc - arg < 2) return usage();
+
+    const char* path = argv[arg];
+    std::string command = argv[arg + 1];
+    char** rest = argv + arg + 2;
+    int restCount = argc - arg - 2;
+
+    Port port;
+    if (!openPort(port, path))
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return 1;
+    }
+
+    // Board reset on open: wait for the bootloader, then for the firmware
+    std::this_thread::sleep_for(std::chrono::milliseconds(bootMs));
+    upload::Status status;
+    uint16_t received;
+    if (!transact(port, upload::FrameType::Ping, {}, status, received, BOOT_PINGS))
+    {
+        fprintf(stderr, "%s: the device does not answer\n", path);
+        return 1;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    bool ok = false;
+    size_t bytes = 0;
+
+    if (command == "ping")
+    {
+        ok = true;
+    }
+    else if (command == "steps" && restCount >= 1)
+    {
+        std::vector<uint8_t> payload;
+        uint16_t count = 0;
+        if (!loadSteps(rest[0], payload, count))
+        {
+            fprintf(stderr, "%s: no steps\n", rest[0]);
+            return 1;
+        }
+        bool loop = restCount >= 2 && strcmp(rest[1], "loop") == 0;
+        ok = sendUpload(port, upload::Kind::Steps, payload, count, upload::STEP_WIRE_BYTES, loop ? 1 : 0);
+        bytes = payload.size();
+    }
+    else if (command == "score" && restCount >= 2)
+    {
+        std::vector<uint8_t> encoded;
+        if (!loadScore(rest[1], encoded))
+        {
+            fprintf(stderr, "%s: no notes or encoding failed\n", rest[1]);
+            return 1;
+        }
+        ok = sendUpload(port, upload::Kind::Score, encoded, (uint16_t)encoded.size(), 1, (uint8_t)atoi(rest[0]));
+        bytes = encoded.size();
+    }
+    else if (command == "play" && restCount >= 1)
+    {
+        ok = expectOk(port, upload::FrameType::Play, {(uint8_t)atoi(rest[0])});
+    }
+    else if (command == "stop")
+    {
+        ok = expectOk(port, upload::FrameType::Stop, {});
+    }
+    else
+    {
+        return usage();
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    if (ok) fprintf(stderr, "%s: ok (%zu bytes, %.1f ms, %d resends)\n", command.c_str(), bytes, ms, port.resends);
+
+    close(port.fd);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file scorepack.cpp
+ * @brief Host encoder for compressed scores (see include/codec/ScoreCodec.h)
+ * 
+ * @details
+ * Encodes scores with the exact same codec the firmware decodes, checks the round trip and prints
+ * a header with PROGMEM arrays ready to play with CompressedScoreSource.
+ * 
+ *  - No arguments: encodes every preset of presetTones/Presets.h
+ *  - One or more score files: each file holds "hz denom" pairs (one note per line, '#' comments)
+ * 
+ * The generated header goes to stdout, the compression report to stderr.
+ * 
+ * Build (from the repository root):
+ *      g++ -std=c++11 -O2 -Iinclude tools/scorepack/scorepack.cpp src/codec/ScoreCodec.cpp src/core/Eeprom.cpp src/music/Pitch.cpp -o scorepack
+ * 
+ * Usage:
+ *      ./scorepack > include/presetTones/PackedPresets.h
+ *      ./scorepack tools/scorepack/corpus/main_phrases.txt > PackedScores.h
+ */
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "codec/ScoreCodec.h"
+#include "presetTones/Presets.h"
+
+namespace {
+
+    // On AVR a ScoreNote is {uint16_t, uint8_t} = 3 bytes and a built Step {uint16_t, uint32_t} = 6 bytes
+    constexpr size_t AVR_SCORE_NOTE_SIZE = 3;
+    constexpr size_t AVR_STEP_SIZE = 6;
+
+    struct Entry
+    {
+        std::string name;
+        std::vector<score::ScoreNote> notes;
+    };
+
+    struct Totals
+    {
+        size_t notes = 0;
+        size_t rawBytes = 0;
+        size_t packedBytes = 0;
+    };
+
+    bool loadScoreFile(const char* path, Entry& entry)
+    {
+        FILE* file = fopen(path, "r");
+        if (!file) return false;
+
+        // name = file name without directories nor extension
+        std::string name(path);
+        size_t slash = name.find_last_of('/');
+        if (slash != std::string::npos) name = name.substr(slash + 1);
+        size_t dot = name.find_last_of('.');
+        if (dot != std::string::npos) name = name.substr(0, dot);
+        entry.name = name;
+
+        char line[128];
+        while (fgets(line, sizeof(line), file))
+        {
+            if (line[0] == '#') continue;
+
+            unsigned hz = 0, denom = 0;
+            if (sscanf(line, "%u %u", &hz, &denom) == 2)
+            {
+                entry.notes.push_back(score::ScoreNote{(uint16_t)hz, (uint8_t)denom});
+            }
+        }
+
+        fclose(file);
+        return true;
+    }
+
+    void addPreset(std::vector<Entry>& entries, const char* name, score::ScoreView view)
+    {
+        entries.push_back(Entry{name, std::vector<score::ScoreNote>(view.data, view.data + view.count)});
+    }
+
+    std::string toIdentifier(const std::string& name)
+    {
+        std::string id;
+        for (char c : name)
+        {
+            id += (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') ? c : '_');
+        }
+        return id;
+    }
+
+    bool packEntry(const Entry& entry, Totals& totals)
+    {
+        std::vector<uint8_t> packed(codec::MAX_HEADER_SIZE + entry.notes.size() * 5 + 1);
+        size_t size = codec::encodeScore(entry.notes.data(), (uint16_t)entry.notes.size(), packed.data(), packed.size());
+        if (size == 0)
+        {
+            fprintf(stderr, "%s: encoding failed\n", entry.name.c_str());
+            return false;
+        }
+
+        // Round trip + decode cost
+        codec::ScoreDecoder decoder(packed.data(), codec::MemorySpace::Ram);
+        score::ScoreNote note;
+        constexpr int RUNS = 10000;
+        auto begin = std::chrono::steady_clock::now();
+        for (int run = 0; run < RUNS; ++run)
+        {
+            decoder.rewind();
+            for (size_t i = 0; decoder.next(note); ++i)
+            {
+                if (run == 0 && (note.hz != entry.notes[i].hz || note.denom != entry.notes[i].denom))
+                {
+                    fprintf(stderr, "%s: round trip mismatch at note %zu\n", entry.name.c_str(), i);
+                    return false;
+                }
+            }
+        }
+        double nsPerNote = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count()
+                           / ((double)RUNS * (entry.notes.empty() ? 1 : entry.notes.size()));
+
+        size_t rawBytes = entry.notes.size() * AVR_SCORE_NOTE_SIZE;
+        fprintf(stderr, "%-16s notes=%3zu score=%4zuB steps>=%4zuB packed=%3zuB ratio=%.2f bits/note=%.1f decode=%.0fns/note(host)\n",
+                entry.name.c_str(), entry.notes.size(), rawBytes, entry.notes.size() * AVR_STEP_SIZE, size,
+                size ? (double)rawBytes / size : 0.0,
+                entry.notes.empty() ? 0.0 : (double)size * 8 / entry.notes.size(),
+                nsPerNote);
+
+        totals.notes += entry.notes.size();
+        totals.rawBytes += rawBytes;
+        totals.packedBytes += size;
+
+        // C array
+        printf("// %s: %zu notes, %zu bytes (ScoreNote[]: %zu bytes)\n", entry.name.c_str(), entry.notes.size(), size, rawBytes);
+        printf("static const uint8_t PACKED_%s[] PROGMEM = {", toIdentifier(entry.name).c_str());
+        for (size_t i = 0; i < size; ++i)
+        {
+            printf("%s0x%02X", (i % 12 == 0) ? "\n    " : ", ", packed[i]);
+        }
+        printf("\n};\n\n");
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<Entry> entries;
+
+    if (argc < 2)
+    {
+        addPreset(entries, "Success", presets::success());
+        addPreset(entries, "Error", presets::error());
+        addPreset(entries, "Notification", presets::notification());
+        addPreset(entries, "Warning", presets::warning());
+        addPreset(entries, "Startup", presets::startup());
+        addPreset(entries, "Shutdown", presets::shutdown());
+        addPreset(entries, "ButtonClick", presets::buttonClick());
+    }
+    else
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            Entry entry;
+            if (!loadScoreFile(argv[i], entry))
+            {
+                fprintf(stderr, "cannot read %s\n", argv[i]);
+                return 1;
+            }
+            entries.push_back(entry);
+        }
+    }
+
+    printf("#pragma once\n\n// Generated by tools/scorepack. Do not edit.\n\n#include <stdint.h>\n#include \"core/Progmem.h\"\n\n");
+
+    Totals totals;
+    for (const Entry& entry : entries)
+    {
+        if (!packEntry(entry, totals)) return 1;
+    }
+
+    fprintf(stderr, "TOTAL            notes=%3zu score=%4zuB packed=%3zuB ratio=%.2f\n",
+            totals.notes, totals.rawBytes, totals.packedBytes,
+            totals.packedBytes ? (double)totals.rawBytes / totals.packedBytes : 0.0);
+    return 0;
+}
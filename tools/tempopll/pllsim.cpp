@@ -0,0 +1,167 @@
+/**
+ * @file pllsim.cpp
+ * @brief Host simulation of TempoPll (see include/player/TempoPll.h) with jittery clock inputs
+ *
+ * @details
+ * Runs the same PLL code as the firmware against generated pulse trains (tap button, 24 PPQN
+ * clock, beat messages with drops, tempo changes) and reports for each scenario:
+ *  - lock time: from the first pulse to isLocked()
+ *  - beat phase error of the PLL once locked: where the PLL puts the true beats (RMS / max)
+ *  - melody phase error: a 120 BPM melody whose position advances at playbackRateFor()
+ *    (q8.8, refreshed every 50 ms like the steps of a melody) against the true beats, once it
+ *    caught up (16 beats after the lock or relock)
+ *
+ * Build (from the repository root):
+ *      g++ -std=c++11 -O2 -Iinclude tools/tempopll/pllsim.cpp src/player/TempoPll.cpp -o pllsim
+ *
+ * Usage:
+ *      ./pllsim [seed]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <random>
+#include <vector>
+
+#include "player/TempoPll.h"
+
+namespace {
+
+    constexpr uint16_t MELODY_BPM = 120;
+    constexpr uint32_t SIM_STEP_US = 100;           // simulation resolution
+    constexpr uint32_t RATE_REFRESH_US = 50000;     // playback rate applied every melody step
+
+    struct Scenario
+    {
+        const char* name;
+        uint8_t pulsesPerBeat;
+        double bpmStart;            // tempo of the source
+        double bpmEnd;              // tempo after the change (same as start: no change)
+        double changeAtS;           // time of the tempo change
+        double jitterUs;            // pulse jitter, uniform +-jitterUs
+        double dropRate;            // fraction of pulses lost
+        double durationS;
+    };
+
+    struct Stats
+    {
+        double sum2 = 0;
+        double max = 0;
+        size_t count = 0;
+
+        void add(double v) { sum2 += v * v; if (fabs(v) > max) max = fabs(v); ++count; }
+        double rms() const { return count ? sqrt(sum2 / count) : 0; }
+    };
+
+    /// @brief Wrap a phase difference (fraction of beat) to [-0.5, 0.5)
+    double wrap(double phase)
+    {
+        return phase - floor(phase + 0.5);
+    }
+
+    void run(const Scenario& sc, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> jitter(-sc.jitterUs, sc.jitterUs);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        TempoPll pll(sc.pulsesPerBeat);
+
+        // True beat grid of the source: phase integrates the tempo
+        const double t0 = 1000000.0;                // start at 1 s
+        double beatPos = 0;                         // beats of the source since t0
+        double nextPulseBeat = 0;                   // next pulse in source beats
+        const double pulseBeats = 1.0 / sc.pulsesPerBeat;
+
+        double firstPulseUs = -1, lockUs = -1, relockFromUs = -1, relockUs = -1;
+
+        Stats pllErr, melodyErr;
+        double melodyPosUs = 0;                     // melody time, advances at the playback rate
+        uint16_t rateQ8 = 0x0100;
+        bool following = false;
+        double lastRefresh = 0;
+
+        for (double t = t0; t < t0 + sc.durationS * 1e6; t += SIM_STEP_US)
+        {
+            double bpm = (t - t0 >= sc.changeAtS * 1e6) ? sc.bpmEnd : sc.bpmStart;
+            double beatUs = 60e6 / bpm;
+            double prevBeatPos = beatPos;
+            beatPos += SIM_STEP_US / beatUs;
+
+            if (relockFromUs < 0 && sc.bpmEnd != sc.bpmStart && t - t0 >= sc.changeAtS * 1e6) relockFromUs = t;
+
+            // Pulses of this step (ideal time + jitter, some dropped)
+            while (nextPulseBeat <= beatPos)
+            {
+                double ideal = t - (beatPos - nextPulseBeat) * beatUs;
+                nextPulseBeat += pulseBeats;
+                if (unit(rng) < sc.dropRate) continue;
+
+                unsigned long at = (unsigned long)(ideal + jitter(rng));
+                if (firstPulseUs < 0) firstPulseUs = at;
+                pll.pulse(at);
+            }
+
+            unsigned long now = (unsigned long)t;
+            bool locked = pll.isLocked(now);
+            if (locked && lockUs < 0) lockUs = t;
+
+            // Relocked: locked again on the new tempo (estimate within 1 %)
+            if (relockFromUs >= 0 && relockUs < 0 && locked && fabs(pll.bpmQ8() / 256.0 - sc.bpmEnd) < sc.bpmEnd / 100) relockUs = t;
+
+            // Melody following the PLL
+            if (locked && !following)
+            {
+                following = true;
+                melodyPosUs = 0;                     // the melody starts with the lock
+                lastRefresh = t - RATE_REFRESH_US;
+            }
+            if (following)
+            {
+                if (t - lastRefresh >= RATE_REFRESH_US)
+                {
+                    rateQ8 = pll.playbackRateFor(MELODY_BPM, (uint32_t)(melodyPosUs / 1000), now);
+                    lastRefresh = t;
+                }
+                melodyPosUs += SIM_STEP_US * rateQ8 / 256.0;
+            }
+
+            // On each true beat (outside the tempo change transient): errors in us
+            bool onBeat = floor(beatPos) != floor(prevBeatPos);
+            bool settled = lockUs >= 0 && (relockFromUs < 0 || relockUs >= 0) && t > lockUs + 4 * beatUs;
+            if (onBeat && settled)
+            {
+                pllErr.add(wrap(pll.beatPhaseQ16(now) / 65536.0) * beatUs);
+
+                // The melody catches up with a bounded trim: skip 16 beats after (re)lock
+                double melodyBeatUs = 60e6 / MELODY_BPM;
+                double from = (relockUs >= 0) ? relockUs : lockUs;
+                if (t > from + 16 * beatUs) melodyErr.add(wrap(melodyPosUs / melodyBeatUs) * beatUs);
+            }
+        }
+
+        printf("%-34s lock %6.0f ms", sc.name, lockUs >= 0 ? (lockUs - firstPulseUs) / 1000 : -1.0);
+        if (relockFromUs >= 0) printf("  relock %6.0f ms", relockUs >= 0 ? (relockUs - relockFromUs) / 1000 : -1.0);
+        else printf("                  ");
+        printf("  bpm %7.2f  PLL phase rms %6.0f us max %6.0f us  melody phase rms %6.0f us max %6.0f us\n",
+            pll.bpmQ8() / 256.0, pllErr.rms(), pllErr.max, melodyErr.rms(), melodyErr.max);
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned seed = (argc > 1) ? (unsigned)atoi(argv[1]) : 1;
+
+    const Scenario scenarios[] = {
+        {"tap 120 BPM, +-20 ms",              1, 120, 120,  0,  20000, 0.00, 60},
+        {"tap 96 BPM, +-8 ms",                1,  96,  96,  0,   8000, 0.00, 60},
+        {"24 PPQN 128 BPM, +-250 us",        24, 128, 128,  0,    250, 0.00, 60},
+        {"24 PPQN 128 -> 100 BPM at 30 s",   24, 128, 100, 30,    250, 0.00, 60},
+        {"beat msgs 90 BPM, +-5 ms, 10% lost", 1, 90,  90,  0,   5000, 0.10, 60},
+        {"beat msgs 90 -> 110 BPM at 30 s",   1,  90, 110, 30,   5000, 0.00, 60},
+    };
+
+    for (const Scenario& sc : scenarios) run(sc, seed);
+    return 0;
+}